@@ -4291,6 +4291,18 @@ extern "C" bool thd_is_strict_mode(const MYSQL_THD thd)
 }
 
 
+/**
+  Is the statement being explained.
+  Needed by InnoDB.
+  @param thd	Thread object
+  @return True if the statement is EXPLAIN, false otherwise.
+*/
+extern "C" bool thd_is_explain(const MYSQL_THD thd)
+{
+  return thd->lex->describe != DESCRIBE_NONE;
+}
+
+
 #ifndef EMBEDDED_LIBRARY
 extern "C" void thd_pool_wait_begin(MYSQL_THD thd, int wait_type);
 extern "C" void thd_pool_wait_end(MYSQL_THD thd);
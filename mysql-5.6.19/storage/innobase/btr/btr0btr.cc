@@ -4277,7 +4277,7 @@ btr_index_rec_validate(
 		ulint	fixed_size = dict_col_get_fixed_size(
 			dict_index_get_nth_col(index, i), page_is_comp(page));
 
-		rec_get_nth_field_offs(offsets, i, &len);
+		rec_get_nth_field(rec, offsets, i, &len);
 
 		/* Note that if fixed_size != 0, it equals the
 		length of a fixed-size column in the clustered index.
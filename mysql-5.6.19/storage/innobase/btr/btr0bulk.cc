@@ -0,0 +1,604 @@
+/*****************************************************************************
+
+Copyright (c) 2026, the authors of this file.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file btr/btr0bulk.cc
+Bottom-up loading of a B-tree from sorted index entries
+*******************************************************/
+
+#include "btr0bulk.h"
+#include "btr0btr.h"
+#include "btr0cur.h"
+#include "btr0sea.h"
+#include "page0page.h"
+#include "page0cur.h"
+#include "page0zip.h"
+#include "mtr0log.h"
+#include "fsp0fsp.h"
+#include "ibuf0ibuf.h"
+#include "log0log.h"
+#include "rem0cmp.h"
+#include "srv0srv.h"
+
+/** State of one level of the tree being loaded */
+struct btr_bulk_level_t {
+	ulint		page_no;	/*!< rightmost page of the level */
+	mem_heap_t*	heap;		/*!< memory heap for the node pointer
+					to a completed page of the level */
+};
+
+/** Bulk loader of an index tree */
+struct btr_bulk_t {
+	dict_index_t*	index;		/*!< index being loaded */
+	trx_id_t	trx_id;		/*!< transaction building the index */
+	ulint		space;		/*!< tablespace of the index */
+	ulint		comp;		/*!< nonzero=compact page format */
+	ulint		reserve;	/*!< number of bytes left free on each
+					page, as set by innodb_fill_factor */
+	ulint		n_levels;	/*!< number of levels built so far,
+					0 until the first entry is inserted */
+	btr_bulk_level_t levels[BTR_MAX_LEVELS];
+					/*!< per-level state, leaf level 0 */
+	mtr_t		mtr;		/*!< mini-transaction covering the
+					leaf page being filled */
+	buf_block_t*	block;		/*!< leaf page being filled, or NULL */
+	rec_t*		last_rec;	/*!< last record on block */
+	mem_heap_t*	heap;		/*!< memory heap for converting
+					entries to records */
+};
+
+/**********************************************************************//**
+Allocates and initializes a page at the right end of a tree level.
+@return the new page, x-latched in mtr, or NULL if out of space */
+static
+buf_block_t*
+btr_bulk_page_alloc(
+/*================*/
+	btr_bulk_t*	bulk,		/*!< in/out: bulk loader */
+	ulint		level,		/*!< in: level of the page */
+	buf_block_t*	prev_block,	/*!< in/out: current rightmost page
+					of the level, x-latched in mtr,
+					or NULL if the level is empty */
+	mtr_t*		mtr)		/*!< in/out: mini-transaction */
+{
+	dict_index_t*	index = bulk->index;
+	buf_block_t*	block;
+	page_t*		page;
+	ulint		n_reserved;
+	ulint		hint_page_no;
+	mtr_t		alloc_mtr;
+
+	hint_page_no = prev_block
+		? buf_block_get_page_no(prev_block) + 1
+		: dict_index_get_page(index) + 1;
+
+	/* Allocate in a separate mini-transaction, so that the
+	tablespace latch is not held while the page is being filled. */
+	mtr_start(&alloc_mtr);
+
+	if (!fsp_reserve_free_extents(&n_reserved, bulk->space, 1,
+				      FSP_NORMAL, &alloc_mtr)) {
+		mtr_commit(&alloc_mtr);
+		return(NULL);
+	}
+
+	block = btr_page_alloc(index, hint_page_no, FSP_UP, level,
+			       &alloc_mtr, mtr);
+
+	fil_space_release_free_extents(bulk->space, n_reserved);
+	mtr_commit(&alloc_mtr);
+
+	if (block == NULL) {
+		return(NULL);
+	}
+
+	page = buf_block_get_frame(block);
+
+	page_create(block, mtr, bulk->comp);
+	btr_page_set_level(page, NULL, level, mtr);
+	btr_page_set_index_id(page, NULL, index->id, mtr);
+	btr_page_set_next(page, NULL, FIL_NULL, mtr);
+	block->check_index_page_at_flush = TRUE;
+
+	if (prev_block) {
+		btr_page_set_prev(page, NULL,
+				  buf_block_get_page_no(prev_block), mtr);
+		btr_page_set_next(buf_block_get_frame(prev_block), NULL,
+				  buf_block_get_page_no(block), mtr);
+	} else {
+		btr_page_set_prev(page, NULL, FIL_NULL, mtr);
+	}
+
+	if (level == 0 && !dict_index_is_clust(index)) {
+		page_set_max_trx_id(block, NULL, bulk->trx_id, mtr);
+	}
+
+	bulk->levels[level].page_no = buf_block_get_page_no(block);
+
+	return(block);
+}
+
+/**********************************************************************//**
+Determines if a record fits on the rightmost page of a level.
+@return true if the record should be inserted on the page */
+static
+bool
+btr_bulk_page_has_space(
+/*====================*/
+	const btr_bulk_t*	bulk,	/*!< in: bulk loader */
+	const page_t*		page,	/*!< in: rightmost page of a level */
+	ulint			rec_size)/*!< in: size of the record */
+{
+	ulint	reserve = bulk->reserve;
+
+	switch (page_get_n_recs(page)) {
+	case 0:
+		return(true);
+	case 1:
+		/* Never leave a single node pointer on a non-leaf
+		page, or the tree could grow without bound. */
+		if (!page_is_leaf(page)) {
+			reserve = 0;
+		}
+	}
+
+	return(page_get_max_insert_size(page, 1) >= rec_size + reserve);
+}
+
+/**********************************************************************//**
+Builds the node pointer to a completed page of a level. The node pointer
+is allocated from the heap of that level.
+@return node pointer */
+static
+dtuple_t*
+btr_bulk_node_ptr(
+/*==============*/
+	btr_bulk_t*		bulk,	/*!< in/out: bulk loader */
+	const buf_block_t*	block,	/*!< in: completed page */
+	ulint			level)	/*!< in: level of the page */
+{
+	const page_t*	page = buf_block_get_frame(block);
+	dtuple_t*	node_ptr;
+
+	ut_ad(page_get_n_recs(page) > 0);
+
+	node_ptr = dict_index_build_node_ptr(
+		bulk->index,
+		page_rec_get_next_const(page_get_infimum_rec(page)),
+		buf_block_get_page_no(block), bulk->levels[level].heap,
+		level);
+
+	if (mach_read_from_4(page + FIL_PAGE_PREV) == FIL_NULL) {
+		/* The leftmost node pointer of each level
+		carries the minimum record flag. */
+		dtuple_set_info_bits(node_ptr,
+				     dtuple_get_info_bits(node_ptr)
+				     | REC_INFO_MIN_REC_FLAG);
+	}
+
+	return(node_ptr);
+}
+
+/**********************************************************************//**
+Appends a node pointer to a non-leaf level, creating the level or
+a new page of the level when needed.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+btr_bulk_insert_node_ptr(
+/*=====================*/
+	btr_bulk_t*	bulk,		/*!< in/out: bulk loader */
+	ulint		level,		/*!< in: non-leaf level */
+	dtuple_t*	node_ptr)	/*!< in: node pointer */
+{
+	dict_index_t*	index = bulk->index;
+	buf_block_t*	block;
+	dtuple_t*	parent_ptr = NULL;
+	page_cur_t	cur;
+	ulint*		offsets = NULL;
+	mem_heap_t*	heap = NULL;
+	rec_t*		rec;
+	mtr_t		mtr;
+	dberr_t		err = DB_SUCCESS;
+
+	ut_ad(level > 0);
+	ut_a(level < BTR_MAX_LEVELS);
+	ut_ad(level <= bulk->n_levels);
+
+	mtr_start(&mtr);
+
+	if (level == bulk->n_levels) {
+		block = btr_bulk_page_alloc(bulk, level, NULL, &mtr);
+
+		if (block == NULL) {
+			err = DB_OUT_OF_FILE_SPACE;
+			goto func_exit;
+		}
+
+		bulk->levels[level].heap = mem_heap_create(1024);
+		bulk->n_levels++;
+	} else {
+		block = btr_block_get(bulk->space, 0,
+				      bulk->levels[level].page_no,
+				      RW_X_LATCH, index, &mtr);
+
+		if (!btr_bulk_page_has_space(
+			    bulk, buf_block_get_frame(block),
+			    rec_get_converted_size(index, node_ptr, 0))) {
+
+			parent_ptr = btr_bulk_node_ptr(bulk, block, level);
+			block = btr_bulk_page_alloc(bulk, level, block, &mtr);
+
+			if (block == NULL) {
+				err = DB_OUT_OF_FILE_SPACE;
+				goto func_exit;
+			}
+		}
+	}
+
+	page_cur_position(
+		page_rec_get_prev(page_get_supremum_rec(
+					  buf_block_get_frame(block))),
+		block, &cur);
+
+	rec = page_cur_tuple_insert(&cur, node_ptr, index,
+				    &offsets, &heap, 0, &mtr);
+
+	if (rec == NULL) {
+		err = DB_TOO_BIG_RECORD;
+	}
+
+func_exit:
+	mtr_commit(&mtr);
+
+	if (heap) {
+		mem_heap_free(heap);
+	}
+
+	if (err == DB_SUCCESS && parent_ptr) {
+		err = btr_bulk_insert_node_ptr(bulk, level + 1, parent_ptr);
+		mem_heap_empty(bulk->levels[level].heap);
+	}
+
+	return(err);
+}
+
+/**********************************************************************//**
+Writes the used part of a page to the redo log. The records of the leaf
+pages are inserted without logging, and each page is logged only once,
+when it has been filled. */
+static
+void
+btr_bulk_log_page(
+/*==============*/
+	buf_block_t*	block,	/*!< in: leaf page, x-latched in mtr */
+	mtr_t*		mtr)	/*!< in/out: mini-transaction */
+{
+	page_t*	page = buf_block_get_frame(block);
+	byte*	heap_top = page_header_get_ptr(page, PAGE_HEAP_TOP);
+	byte*	dir_start = page_dir_get_nth_slot(
+		page, page_dir_get_n_slots(page) - 1);
+
+	mlog_log_string(page + PAGE_HEADER,
+			heap_top - (page + PAGE_HEADER), mtr);
+	mlog_log_string(dir_start,
+			page + UNIV_PAGE_SIZE - PAGE_DIR - dir_start, mtr);
+}
+
+/**********************************************************************//**
+Completes the leaf page being filled and commits its mini-transaction.
+Unless this is the only leaf page, the node pointer to it is inserted
+to the level above.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+btr_bulk_leaf_commit(
+/*=================*/
+	btr_bulk_t*	bulk,		/*!< in/out: bulk loader */
+	bool		last)		/*!< in: whether this is the
+					last leaf page */
+{
+	buf_block_t*	block = bulk->block;
+	dtuple_t*	node_ptr = NULL;
+	dberr_t		err = DB_SUCCESS;
+
+	btr_bulk_log_page(block, &bulk->mtr);
+
+	if (!dict_index_is_clust(bulk->index)) {
+		ibuf_reset_free_bits(block);
+	}
+
+	if (!last || bulk->n_levels > 1) {
+		node_ptr = btr_bulk_node_ptr(bulk, block, 0);
+	}
+
+	mtr_commit(&bulk->mtr);
+	bulk->block = NULL;
+
+	if (node_ptr) {
+		err = btr_bulk_insert_node_ptr(bulk, 1, node_ptr);
+		mem_heap_empty(bulk->levels[0].heap);
+	}
+
+	return(err);
+}
+
+/**********************************************************************//**
+Starts filling a new leaf page at the right end of the leaf level.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+btr_bulk_leaf_start(
+/*================*/
+	btr_bulk_t*	bulk)	/*!< in/out: bulk loader */
+{
+	dict_index_t*	index = bulk->index;
+	buf_block_t*	prev_block = NULL;
+
+	ut_ad(!bulk->block);
+
+	/* Do not wait for log space while holding page latches. */
+	log_free_check();
+
+	mtr_start(&bulk->mtr);
+
+	if (dict_index_is_clust(index)) {
+		/* Storing off-page columns requires the index tree
+		to be x-latched. Acquire it before any page latch. */
+		mtr_x_lock(dict_index_get_lock(index), &bulk->mtr);
+	}
+
+	if (bulk->n_levels > 0) {
+		prev_block = btr_block_get(bulk->space, 0,
+					   bulk->levels[0].page_no,
+					   RW_X_LATCH, index, &bulk->mtr);
+	}
+
+	bulk->block = btr_bulk_page_alloc(bulk, 0, prev_block, &bulk->mtr);
+
+	if (bulk->block == NULL) {
+		mtr_commit(&bulk->mtr);
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	if (bulk->n_levels == 0) {
+		bulk->levels[0].heap = mem_heap_create(1024);
+		bulk->n_levels = 1;
+	}
+
+	bulk->last_rec = page_get_infimum_rec(
+		buf_block_get_frame(bulk->block));
+
+	return(DB_SUCCESS);
+}
+
+/**********************************************************************//**
+Copies the single page of the topmost level to the root page and frees
+it. */
+static
+void
+btr_bulk_copy_to_root(
+/*==================*/
+	btr_bulk_t*	bulk)	/*!< in/out: bulk loader */
+{
+	dict_index_t*	index = bulk->index;
+	ulint		top = bulk->n_levels - 1;
+	buf_block_t*	root_block;
+	buf_block_t*	top_block;
+	page_t*		top_page;
+	mtr_t		mtr;
+
+	mtr_start(&mtr);
+	mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+	root_block = btr_block_get(bulk->space, 0, dict_index_get_page(index),
+				   RW_X_LATCH, index, &mtr);
+	top_block = btr_block_get(bulk->space, 0, bulk->levels[top].page_no,
+				  RW_X_LATCH, index, &mtr);
+	top_page = buf_block_get_frame(top_block);
+
+	ut_ad(mach_read_from_4(top_page + FIL_PAGE_PREV) == FIL_NULL);
+	ut_ad(mach_read_from_4(top_page + FIL_PAGE_NEXT) == FIL_NULL);
+	ut_ad(page_get_n_recs(buf_block_get_frame(root_block)) == 0);
+
+	/* Recreate the root page: the segment headers on it are
+	preserved intact. */
+	btr_search_drop_page_hash_index(root_block);
+	page_create(root_block, &mtr, bulk->comp);
+	btr_page_set_level(buf_block_get_frame(root_block), NULL, top, &mtr);
+	root_block->check_index_page_at_flush = TRUE;
+
+	page_copy_rec_list_end(root_block, top_block,
+			       page_get_infimum_rec(top_page), index, &mtr);
+
+	btr_page_free(index, top_block, &mtr);
+
+	mtr_commit(&mtr);
+}
+
+/**********************************************************************//**
+Creates a bulk loader for an empty, uncompressed index tree.
+@return own: bulk loader */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,	/*!< in: index whose tree is empty */
+	trx_id_t	trx_id)	/*!< in: transaction building the index */
+{
+	btr_bulk_t*	bulk;
+
+	ut_ad(!dict_index_is_ibuf(index));
+	ut_ad(!dict_table_zip_size(index->table));
+
+	bulk = static_cast<btr_bulk_t*>(mem_zalloc(sizeof *bulk));
+
+	bulk->index = index;
+	bulk->trx_id = trx_id;
+	bulk->space = dict_index_get_space(index);
+	bulk->comp = dict_table_is_comp(index->table);
+	bulk->reserve = UNIV_PAGE_SIZE * (100 - srv_fill_factor) / 100;
+	bulk->heap = mem_heap_create(1024);
+
+	return(bulk);
+}
+
+/**********************************************************************//**
+Appends an entry to the index tree. The entries must be passed in
+ascending order.
+@return DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk loader */
+	dtuple_t*	tuple)	/*!< in/out: index entry; fields may be
+				temporarily moved off-page */
+{
+	dict_index_t*	index = bulk->index;
+	big_rec_t*	big_rec = NULL;
+	ulint		n_ext = dtuple_get_n_ext(tuple);
+	ulint		rec_size;
+	ulint*		offsets = NULL;
+	page_cur_t	cur;
+	rec_t*		rec;
+	dberr_t		err = DB_SUCCESS;
+
+	mem_heap_empty(bulk->heap);
+
+	rec_size = rec_get_converted_size(index, tuple, n_ext);
+
+	if (page_zip_rec_needs_ext(rec_size, bulk->comp,
+				   dtuple_get_n_fields(tuple), 0)) {
+		/* Move the longest fields off-page. This returns
+		NULL for secondary indexes. */
+		big_rec = dtuple_convert_big_rec(index, tuple, &n_ext);
+
+		if (big_rec == NULL) {
+			return(DB_TOO_BIG_RECORD);
+		}
+
+		rec_size = rec_get_converted_size(index, tuple, n_ext);
+	}
+
+	if (bulk->block == NULL) {
+		err = btr_bulk_leaf_start(bulk);
+	} else if (!btr_bulk_page_has_space(
+			   bulk, buf_block_get_frame(bulk->block), rec_size)) {
+		err = btr_bulk_leaf_commit(bulk, false);
+
+		if (err == DB_SUCCESS) {
+			err = btr_bulk_leaf_start(bulk);
+		}
+	}
+
+	if (err != DB_SUCCESS) {
+		goto func_exit;
+	}
+
+#ifdef UNIV_DEBUG
+	if (!page_rec_is_infimum(bulk->last_rec)) {
+		offsets = rec_get_offsets(bulk->last_rec, index, NULL,
+					  ULINT_UNDEFINED, &bulk->heap);
+		ut_ad(cmp_dtuple_rec(tuple, bulk->last_rec, offsets) > 0);
+		offsets = NULL;
+	}
+#endif /* UNIV_DEBUG */
+
+	page_cur_position(bulk->last_rec, bulk->block, &cur);
+
+	/* The page will be logged as a whole when it is completed. */
+	rec = page_cur_tuple_insert(&cur, tuple, index, &offsets,
+				    &bulk->heap, n_ext, NULL);
+
+	if (rec == NULL) {
+		err = DB_TOO_BIG_RECORD;
+		goto func_exit;
+	}
+
+	bulk->last_rec = rec;
+
+	if (big_rec) {
+		offsets = rec_get_offsets(rec, index, offsets,
+					  ULINT_UNDEFINED, &bulk->heap);
+		err = btr_store_big_rec_extern_fields(
+			index, bulk->block, rec, offsets, big_rec,
+			&bulk->mtr, BTR_STORE_INSERT);
+	}
+
+func_exit:
+	if (big_rec) {
+		dtuple_convert_back_big_rec(index, tuple, big_rec);
+	}
+
+	return(err);
+}
+
+/**********************************************************************//**
+Completes the index tree and frees the bulk loader. If err is not
+DB_SUCCESS, the latches are released without completing the tree;
+the caller is expected to drop the index.
+@return DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_finish(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in, own: bulk loader */
+	dberr_t		err)	/*!< in: error status of the load */
+{
+	if (bulk->block) {
+		if (err == DB_SUCCESS) {
+			err = btr_bulk_leaf_commit(bulk, true);
+		} else {
+			mtr_commit(&bulk->mtr);
+		}
+	}
+
+	/* Attach the rightmost page of each non-leaf level to the
+	level above. This may add levels. */
+	for (ulint level = 1;
+	     err == DB_SUCCESS && level + 1 < bulk->n_levels;
+	     level++) {
+		buf_block_t*	block;
+		dtuple_t*	node_ptr;
+		mtr_t		mtr;
+
+		mtr_start(&mtr);
+		block = btr_block_get(bulk->space, 0,
+				      bulk->levels[level].page_no,
+				      RW_X_LATCH, bulk->index, &mtr);
+		node_ptr = btr_bulk_node_ptr(bulk, block, level);
+		mtr_commit(&mtr);
+
+		err = btr_bulk_insert_node_ptr(bulk, level + 1, node_ptr);
+		mem_heap_empty(bulk->levels[level].heap);
+	}
+
+	if (err == DB_SUCCESS && bulk->n_levels > 0) {
+		btr_bulk_copy_to_root(bulk);
+	}
+
+	for (ulint level = 0; level < bulk->n_levels; level++) {
+		mem_heap_free(bulk->levels[level].heap);
+	}
+
+	mem_heap_free(bulk->heap);
+	mem_free(bulk);
+
+	return(err);
+}
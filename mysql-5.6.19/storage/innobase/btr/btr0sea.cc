@@ -270,7 +270,44 @@ btr_search_enable(void)
 {
 	rw_lock_x_lock(&btr_search_latch);
 
-	btr_search_enabled = TRUE;
+	if (buf_pool_withdrawing) {
+		/* The pages are being moved to other blocks.
+		buf_pool_resize() enables the index when it is done. */
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"The adaptive hash index cannot be enabled"
+			" while the buffer pool is being resized.");
+	} else {
+		btr_search_enabled = TRUE;
+	}
+
+	rw_lock_x_unlock(&btr_search_latch);
+}
+
+/*****************************************************************//**
+Resizes the hash table of the adaptive hash index. The index must be
+disabled. */
+UNIV_INTERN
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size)	/*!< in: hash index hash table size */
+{
+	rw_lock_x_lock(&btr_search_latch);
+
+	if (btr_search_enabled) {
+		/* It was enabled meanwhile and may be in use. */
+		rw_lock_x_unlock(&btr_search_latch);
+		return;
+	}
+
+	mem_heap_free(btr_search_sys->hash_index->heap);
+	hash_table_free(btr_search_sys->hash_index);
+
+	btr_search_sys->hash_index = ha_create(hash_size, 0,
+					MEM_HEAP_FOR_BTR_SEARCH, 0);
+#if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
+	btr_search_sys->hash_index->adaptive = TRUE;
+#endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 
 	rw_lock_x_unlock(&btr_search_latch);
 }
@@ -324,6 +324,16 @@ buf_buddy_alloc_zip(
 
 	buf = UT_LIST_GET_FIRST(buf_pool->zip_free[i]);
 
+	if (UNIV_UNLIKELY(buf_pool->withdraw_target > 0)) {
+		/* Do not allocate from the frames that
+		buf_pool_resize() is withdrawing. */
+		while (buf != NULL
+		       && buf_frame_will_be_withdrawn(
+			       buf_pool, buf->stamp.bytes)) {
+			buf = UT_LIST_GET_NEXT(list, buf);
+		}
+	}
+
 	if (buf) {
 		buf_buddy_remove_from_free(buf_pool, buf, i);
 	} else if (i + 1 < BUF_BUDDY_SIZES) {
@@ -662,8 +672,11 @@ recombine:
 
 	/* Do not recombine blocks if there are few free blocks.
 	We may waste up to 15360*max_len bytes to free blocks
-	(1024 + 2048 + 4096 + 8192 = 15360) */
-	if (UT_LIST_GET_LEN(buf_pool->zip_free[i]) < 16) {
+	(1024 + 2048 + 4096 + 8192 = 15360). While the buffer pool
+	is being shrunk, always recombine, so that the frames being
+	withdrawn can be returned as a whole. */
+	if (UT_LIST_GET_LEN(buf_pool->zip_free[i]) < 16
+	    && buf_pool->withdraw_target == 0) {
 		goto func_exit;
 	}
 
@@ -719,3 +732,119 @@ func_exit:
 			      reinterpret_cast<buf_buddy_free_t*>(buf),
 			      i);
 }
+
+/**********************************************************************//**
+Try to reallocate a block to a frame that is not being withdrawn.
+@return	true if a free block was available; false if the free list
+was empty and the block was not moved */
+UNIV_INTERN
+bool
+buf_buddy_realloc(
+/*==============*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	void*		buf,		/*!< in: block to be reallocated,
+					the compressed frame of a page
+					in buf_pool->page_hash */
+	ulint		size)		/*!< in: block size,
+					up to UNIV_PAGE_SIZE */
+{
+	void*	dst = NULL;
+	ulint	i = buf_buddy_get_slot(size);
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(!mutex_own(&buf_pool->zip_mutex));
+	ut_ad(i <= BUF_BUDDY_SIZES);
+	ut_ad(i >= buf_buddy_get_slot(UNIV_ZIP_SIZE_MIN));
+
+	if (i < BUF_BUDDY_SIZES) {
+		/* Try to allocate from the buddy system. */
+		dst = buf_buddy_alloc_zip(buf_pool, i);
+	}
+
+	if (dst == NULL) {
+		/* Try allocating from the buf_pool->free list. */
+		buf_block_t*	block = buf_LRU_get_free_only(buf_pool);
+
+		if (block == NULL) {
+			return(false);
+		}
+
+		buf_buddy_block_register(block);
+
+		dst = buf_buddy_alloc_from(
+			buf_pool, block->frame, i, BUF_BUDDY_SIZES);
+	}
+
+	buf_pool->buddy_stat[i].used++;
+
+	if (buf_buddy_relocate(buf_pool, buf, dst, i)) {
+		buf_buddy_free_low(buf_pool, buf, i);
+	} else {
+		/* The page is fixed or being freed; the caller
+		will retry later. */
+		buf_buddy_free_low(buf_pool, dst, i);
+	}
+
+	return(true);
+}
+
+/**********************************************************************//**
+Combines the free buddy blocks in the frames that are being withdrawn,
+so that whole frames are returned to buf_pool->withdraw. */
+UNIV_INTERN
+void
+buf_buddy_condense_free(
+/*====================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(buf_pool->withdraw_target > 0);
+
+	for (ulint i = 0; i < UT_ARR_SIZE(buf_pool->zip_free); ++i) {
+		buf_buddy_free_t*	buf
+			= UT_LIST_GET_FIRST(buf_pool->zip_free[i]);
+
+		/* Seek to the first block to withdraw. */
+		while (buf != NULL
+		       && !buf_frame_will_be_withdrawn(
+			       buf_pool, buf->stamp.bytes)) {
+			buf = UT_LIST_GET_NEXT(list, buf);
+		}
+
+		while (buf != NULL) {
+			buf_buddy_free_t*	next
+				= UT_LIST_GET_NEXT(list, buf);
+			buf_buddy_free_t*	buddy
+				= reinterpret_cast<buf_buddy_free_t*>(
+					buf_buddy_get(buf->stamp.bytes,
+						      BUF_BUDDY_LOW << i));
+
+			/* Seek to the next block to withdraw, skipping
+			the buddy, which is combined with buf below. */
+			for (;;) {
+				while (next != NULL
+				       && !buf_frame_will_be_withdrawn(
+					       buf_pool, next->stamp.bytes)) {
+					next = UT_LIST_GET_NEXT(list, next);
+				}
+
+				if (buddy != next) {
+					break;
+				}
+
+				next = UT_LIST_GET_NEXT(list, next);
+			}
+
+			if (buf_buddy_is_free(buddy, i)
+			    == BUF_BUDDY_STATE_FREE) {
+				/* Both buf and its buddy are free:
+				combine them. */
+				buf_buddy_remove_from_free(buf_pool, buf, i);
+				buf_pool->buddy_stat[i].used++;
+				buf_buddy_free_low(buf_pool, buf, i);
+			}
+
+			buf = next;
+		}
+	}
+}
@@ -48,6 +48,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "log0log.h"
 #endif /* !UNIV_HOTBACKUP */
 #include "srv0srv.h"
+#include "srv0start.h"
 #include "dict0dict.h"
 #include "log0recv.h"
 #include "page0zip.h"
@@ -257,6 +258,12 @@ static const ulint BUF_PAGE_READ_MAX_RETRIES = 100;
 /** The buffer pools of the database */
 UNIV_INTERN buf_pool_t*	buf_pool_ptr;
 
+/** true while buf_pool_resize() is withdrawing blocks */
+UNIV_INTERN volatile bool	buf_pool_withdrawing;
+
+/** Incremented each time buf_pool_resize() has freed chunks */
+UNIV_INTERN volatile ulint	buf_withdraw_clock;
+
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 static ulint	buf_dbg_counter	= 0; /*!< This is used to insert validation
 					operations in execution in the
@@ -1069,6 +1076,15 @@ buf_chunk_init(
 		return(NULL);
 	}
 
+	/* Bind the memory before the block descriptors below are
+	written, because the pages are placed when they are first
+	touched. If the binding fails, the pages are placed by the
+	default policy of the process. */
+	if (buf_pool->numa_node != ULINT_UNDEFINED) {
+		os_mem_bind_node(chunk->mem, chunk->mem_size,
+				 buf_pool->numa_node);
+	}
+
 	/* Allocate the block descriptors from
 	the start of the memory block. */
 	chunk->blocks = (buf_block_t*) chunk->mem;
@@ -1096,7 +1112,8 @@ buf_chunk_init(
 
 	/* Init block structs and assign frames for them. Then we
 	assign the frames to the first blocks (we already mapped the
-	memory above). */
+	memory above). The blocks are added to the free list by
+	buf_chunk_add_to_free_list(). */
 
 	block = chunk->blocks;
 
@@ -1105,12 +1122,6 @@ buf_chunk_init(
 		buf_block_init(buf_pool, block, frame);
 		UNIV_MEM_INVALID(block->frame, UNIV_PAGE_SIZE);
 
-		/* Add the block to the free list */
-		UT_LIST_ADD_LAST(list, buf_pool->free, (&block->page));
-
-		ut_d(block->page.in_free_list = TRUE);
-		ut_ad(buf_pool_from_block(block) == buf_pool);
-
 		block++;
 		frame += UNIV_PAGE_SIZE;
 	}
@@ -1121,6 +1132,82 @@ buf_chunk_init(
 	return(chunk);
 }
 
+/********************************************************************//**
+Adds the blocks of a chunk that was allocated by buf_chunk_init() to the
+free list of the buffer pool instance. */
+static
+void
+buf_chunk_add_to_free_list(
+/*=======================*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	buf_chunk_t*	chunk)		/*!< in: chunk of buffers */
+{
+	buf_block_t*	block = chunk->blocks;
+	ulint		i;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	for (i = chunk->size; i--; block++) {
+		UT_LIST_ADD_LAST(list, buf_pool->free, (&block->page));
+
+		ut_d(block->page.in_free_list = TRUE);
+		ut_ad(buf_pool_from_block(block) == buf_pool);
+	}
+}
+
+/********************************************************************//**
+Frees the synchronization objects and the memory of a chunk that has been
+removed from the buffer pool. None of its blocks may be in use. */
+static
+void
+buf_chunk_free(
+/*===========*/
+	buf_chunk_t*	chunk)		/*!< in, own: chunk of buffers */
+{
+	buf_block_t*	block = chunk->blocks;
+	ulint		i;
+
+	for (i = chunk->size; i--; block++) {
+		ut_ad(buf_block_get_state(block) == BUF_BLOCK_NOT_USED);
+		ut_ad(!block->page.in_free_list);
+
+		mutex_free(&block->mutex);
+		rw_lock_free(&block->lock);
+#ifdef UNIV_SYNC_DEBUG
+		rw_lock_free(&block->debug_latch);
+#endif /* UNIV_SYNC_DEBUG */
+	}
+
+	os_mem_free_large(chunk->mem, chunk->mem_size);
+}
+
+/********************************************************************//**
+Publishes a copy of buf_pool->chunks[0 .. n_chunks) for
+buf_block_align_instance(). The previous map is kept, because readers
+do not hold any latch. */
+static
+void
+buf_pool_publish_chunk_map(
+/*=======================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	buf_chunk_map_t*	map;
+	const ulint		n = buf_pool->n_chunks;
+
+	map = static_cast<buf_chunk_map_t*>(
+		mem_alloc(sizeof *map + n * sizeof *map->chunks));
+
+	map->n_chunks = n;
+	map->chunks = reinterpret_cast<buf_chunk_t*>(map + 1);
+	memcpy(map->chunks, buf_pool->chunks, n * sizeof *map->chunks);
+	map->prev = buf_pool->chunk_map;
+
+	/* The map must be complete before readers can see it. */
+	os_wmb;
+
+	buf_pool->chunk_map = map;
+}
+
 #ifdef UNIV_DEBUG
 /*********************************************************************//**
 Finds a block in the given buffer chunk that points to a
@@ -1275,25 +1362,48 @@ buf_pool_init_instance(
 	buf_pool_mutex_enter(buf_pool);
 
 	if (buf_pool_size > 0) {
-		buf_pool->n_chunks = 1;
+		/* The pool is allocated in chunks of
+		srv_buf_pool_chunk_unit bytes, so that buf_pool_resize()
+		can later add or remove chunks. The last chunk may be
+		smaller. */
+		buf_pool->n_chunks = (buf_pool_size + srv_buf_pool_chunk_unit
+				      - 1) / srv_buf_pool_chunk_unit;
+		buf_pool->n_chunks_new = buf_pool->n_chunks;
 
-		buf_pool->chunks = chunk =
-			(buf_chunk_t*) mem_zalloc(sizeof *chunk);
+		buf_pool->chunks = chunk = (buf_chunk_t*) mem_zalloc(
+			buf_pool->n_chunks * sizeof *chunk);
 
 		UT_LIST_INIT(buf_pool->free);
+		UT_LIST_INIT(buf_pool->withdraw);
+		buf_pool->curr_size = 0;
+
+		for (i = 0; i < buf_pool->n_chunks; i++, chunk++) {
+			ulint	chunk_size = ut_min(
+				(ulint) srv_buf_pool_chunk_unit,
+				buf_pool_size - i * srv_buf_pool_chunk_unit);
+
+			if (!buf_chunk_init(buf_pool, chunk, chunk_size)) {
+				while (--chunk >= buf_pool->chunks) {
+					os_mem_free_large(chunk->mem,
+							  chunk->mem_size);
+				}
 
-		if (!buf_chunk_init(buf_pool, chunk, buf_pool_size)) {
-			mem_free(chunk);
-			mem_free(buf_pool);
+				mem_free(buf_pool->chunks);
+				mem_free(buf_pool);
 
-			buf_pool_mutex_exit(buf_pool);
+				buf_pool_mutex_exit(buf_pool);
 
-			return(DB_ERROR);
+				return(DB_ERROR);
+			}
+
+			buf_chunk_add_to_free_list(buf_pool, chunk);
+			buf_pool->curr_size += chunk->size;
 		}
 
+		buf_pool_publish_chunk_map(buf_pool);
+
 		buf_pool->instance_no = instance_no;
 		buf_pool->old_pool_size = buf_pool_size;
-		buf_pool->curr_size = chunk->size;
 		buf_pool->curr_pool_size = buf_pool->curr_size * UNIV_PAGE_SIZE;
 
 		/* Number of locks protecting page_hash must be a
@@ -1377,11 +1487,51 @@ buf_pool_free_instance(
 	}
 
 	mem_free(buf_pool->chunks);
+
+	while (buf_chunk_map_t* map = buf_pool->chunk_map) {
+		buf_pool->chunk_map = map->prev;
+		mem_free(map);
+	}
+
 	ha_clear(buf_pool->page_hash);
 	hash_table_free(buf_pool->page_hash);
 	hash_table_free(buf_pool->zip_hash);
 }
 
+/********************************************************************//**
+Registers the memory of the buffer pool chunks for asynchronous i/o. */
+static
+void
+buf_pool_register_aio_buffers(void)
+/*===============================*/
+{
+	ulint	n_chunks = 0;
+	ulint	n = 0;
+	byte**	bufs;
+	ulint*	lens;
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		n_chunks += buf_pool_from_array(i)->n_chunks;
+	}
+
+	bufs = static_cast<byte**>(ut_malloc(n_chunks * sizeof(*bufs)));
+	lens = static_cast<ulint*>(ut_malloc(n_chunks * sizeof(*lens)));
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		const buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+		for (ulint j = 0; j < buf_pool->n_chunks; j++, n++) {
+			bufs[n] = static_cast<byte*>(buf_pool->chunks[j].mem);
+			lens[n] = buf_pool->chunks[j].mem_size;
+		}
+	}
+
+	os_aio_register_buffers(bufs, lens, n);
+
+	ut_free(bufs);
+	ut_free(lens);
+}
+
 /********************************************************************//**
 Creates the buffer pool.
 @return	DB_SUCCESS if success, DB_ERROR if not enough memory or error */
@@ -1394,17 +1544,37 @@ buf_pool_init(
 {
 	ulint		i;
 	const ulint	size	= total_size / n_instances;
+	ulint		n_nodes	= srv_buf_pool_numa ? os_numa_n_nodes() : 1;
 
 	ut_ad(n_instances > 0);
 	ut_ad(n_instances <= MAX_BUFFER_POOLS);
 	ut_ad(n_instances == srv_buf_pool_instances);
 
+	if (n_nodes > 1) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Binding %lu buffer pool instances to %lu NUMA nodes",
+			n_instances, n_nodes);
+
+		if (n_instances % n_nodes) {
+			ib_logf(IB_LOG_LEVEL_WARN,
+				"innodb_buffer_pool_instances=%lu is not a"
+				" multiple of the %lu NUMA nodes; the pages"
+				" will not be spread evenly over the nodes",
+				n_instances, n_nodes);
+		}
+	}
+
 	buf_pool_ptr = (buf_pool_t*) mem_zalloc(
 		n_instances * sizeof *buf_pool_ptr);
 
 	for (i = 0; i < n_instances; i++) {
 		buf_pool_t*	ptr	= &buf_pool_ptr[i];
 
+		/* buf_pool_get() spreads the pages evenly over the
+		instances, so assigning the instances to the nodes in
+		turn spreads the pages evenly over the nodes. */
+		ptr->numa_node = n_nodes > 1 ? i % n_nodes : ULINT_UNDEFINED;
+
 		if (buf_pool_init_instance(ptr, size, i) != DB_SUCCESS) {
 
 			/* Free all the instances created so far. */
@@ -1419,6 +1589,8 @@ buf_pool_init(
 
 	btr_search_sys_create(buf_pool_get_curr_size() / sizeof(void*) / 64);
 
+	buf_pool_register_aio_buffers();
+
 	return(DB_SUCCESS);
 }
 
@@ -1457,6 +1629,10 @@ buf_pool_clear_hash_index(void)
 
 	for (p = 0; p < srv_buf_pool_instances; p++) {
 		buf_pool_t*	buf_pool = buf_pool_from_array(p);
+
+		/* Keep buf_pool_resize() from changing the chunks. */
+		buf_pool_mutex_enter(buf_pool);
+
 		buf_chunk_t*	chunks	= buf_pool->chunks;
 		buf_chunk_t*	chunk	= chunks + buf_pool->n_chunks;
 
@@ -1482,7 +1658,771 @@ buf_pool_clear_hash_index(void)
 # endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 			}
 		}
+
+		buf_pool_mutex_exit(buf_pool);
+	}
+}
+
+/********************************************************************//**
+Determines whether a block belongs to a chunk that buf_pool_resize()
+is removing from the buffer pool instance.
+@return	true if the block will be removed from the buffer pool */
+UNIV_INTERN
+bool
+buf_block_will_be_withdrawn(
+/*========================*/
+	const buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const buf_block_t*	block)		/*!< in: block, not
+						dereferenced */
+{
+	const buf_chunk_t*		chunk;
+	const buf_chunk_t* const	echunk
+		= buf_pool->chunks + buf_pool->n_chunks;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	for (chunk = buf_pool->chunks + buf_pool->n_chunks_new;
+	     chunk < echunk; chunk++) {
+
+		if (block >= chunk->blocks
+		    && block < chunk->blocks + chunk->size) {
+
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/********************************************************************//**
+Determines whether a pointer points to the frames of a chunk that
+buf_pool_resize() is removing from the buffer pool instance.
+@return	true if the frame will be removed from the buffer pool */
+UNIV_INTERN
+bool
+buf_frame_will_be_withdrawn(
+/*========================*/
+	const buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const byte*		ptr)		/*!< in: pointer to a frame,
+						not dereferenced */
+{
+	const buf_chunk_t*		chunk;
+	const buf_chunk_t* const	echunk
+		= buf_pool->chunks + buf_pool->n_chunks;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	for (chunk = buf_pool->chunks + buf_pool->n_chunks_new;
+	     chunk < echunk; chunk++) {
+
+		if (ptr >= chunk->blocks->frame
+		    && ptr < chunk->blocks->frame
+		    + chunk->size * UNIV_PAGE_SIZE) {
+
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/*****************************************************************//**
+Sets the global variable that feeds MySQL's
+innodb_buffer_pool_resize_status to the specified string and writes it
+to the error log. The format and the following parameters are the same
+as the ones used for printf(3). */
+static __attribute__((nonnull, format(printf, 1, 2)))
+void
+buf_resize_status(
+/*==============*/
+	const char*	fmt,	/*!< in: format */
+	...)			/*!< in: extra parameters according
+				to fmt */
+{
+	va_list	ap;
+
+	va_start(ap, fmt);
+
+	ut_vsnprintf(
+		export_vars.innodb_buffer_pool_resize_status,
+		sizeof(export_vars.innodb_buffer_pool_resize_status),
+		fmt, ap);
+
+	va_end(ap);
+
+	ib_logf(IB_LOG_LEVEL_INFO, "%s",
+		export_vars.innodb_buffer_pool_resize_status);
+}
+
+/********************************************************************//**
+Moves a file page out of a block that is being withdrawn, into a block
+taken from the free list. The page is not moved if it is in use.
+@return	false if the free list was empty */
+static
+bool
+buf_page_realloc(
+/*=============*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_block_t*	block)		/*!< in: block to move the page
+					out of */
+{
+	buf_block_t*	new_block;
+	ulint		fold;
+	rw_lock_t*	hash_lock;
+
+	ut_ad(buf_pool_withdrawing);
+	ut_ad(buf_pool_mutex_own(buf_pool));
+	ut_ad(buf_block_get_state(block) == BUF_BLOCK_FILE_PAGE);
+
+	new_block = buf_LRU_get_free_only(buf_pool);
+
+	if (new_block == NULL) {
+		return(false);
+	}
+
+	fold = buf_page_address_fold(block->page.space, block->page.offset);
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+
+	rw_lock_x_lock(hash_lock);
+	mutex_enter(&block->mutex);
+
+	if (!buf_page_can_relocate(&block->page)) {
+		/* The page was fixed meanwhile. */
+		rw_lock_x_unlock(hash_lock);
+		mutex_exit(&block->mutex);
+
+		mutex_enter(&new_block->mutex);
+		buf_LRU_block_free_non_file_page(new_block);
+		mutex_exit(&new_block->mutex);
+
+		return(true);
+	}
+
+	mutex_enter(&new_block->mutex);
+
+	memcpy(new_block->frame, block->frame, UNIV_PAGE_SIZE);
+	memcpy(&new_block->page, &block->page, sizeof block->page);
+
+	/* Relocate buf_pool->LRU. */
+	ut_ad(block->page.in_LRU_list);
+	ut_ad(!block->page.in_zip_hash);
+	ut_d(block->page.in_LRU_list = FALSE);
+
+	buf_page_t*	prev_b = UT_LIST_GET_PREV(LRU, &block->page);
+	UT_LIST_REMOVE(LRU, buf_pool->LRU, &block->page);
+
+	if (prev_b != NULL) {
+		UT_LIST_INSERT_AFTER(LRU, buf_pool->LRU, prev_b,
+				     &new_block->page);
+	} else {
+		UT_LIST_ADD_FIRST(LRU, buf_pool->LRU, &new_block->page);
+	}
+
+	if (buf_pool->LRU_old == &block->page) {
+		buf_pool->LRU_old = &new_block->page;
+	}
+
+	/* Relocate buf_pool->unzip_LRU. */
+	if (block->page.zip.data != NULL) {
+		buf_block_t*	prev_block = UT_LIST_GET_PREV(unzip_LRU, block);
+
+		ut_ad(block->in_unzip_LRU_list);
+		ut_d(block->in_unzip_LRU_list = FALSE);
+		ut_d(new_block->in_unzip_LRU_list = TRUE);
+
+		UT_LIST_REMOVE(unzip_LRU, buf_pool->unzip_LRU, block);
+
+		if (prev_block != NULL) {
+			UT_LIST_INSERT_AFTER(unzip_LRU, buf_pool->unzip_LRU,
+					     prev_block, new_block);
+		} else {
+			UT_LIST_ADD_FIRST(unzip_LRU, buf_pool->unzip_LRU,
+					  new_block);
+		}
+
+		block->page.zip.data = NULL;
+		page_zip_set_size(&block->page.zip, 0);
+	} else {
+		ut_ad(!block->in_unzip_LRU_list);
+		ut_d(new_block->in_unzip_LRU_list = FALSE);
+	}
+
+	/* Relocate buf_pool->page_hash. */
+	ut_ad(block->page.in_page_hash);
+	ut_ad(&block->page == buf_page_hash_get_low(
+		      buf_pool, block->page.space, block->page.offset, fold));
+	ut_d(block->page.in_page_hash = FALSE);
+
+	HASH_DELETE(buf_page_t, hash, buf_pool->page_hash, fold,
+		    (&block->page));
+	HASH_INSERT(buf_page_t, hash, buf_pool->page_hash, fold,
+		    (&new_block->page));
+
+	/* Relocate buf_pool->flush_list. */
+	if (block->page.oldest_modification) {
+		buf_flush_relocate_on_flush_list(
+			&block->page, &new_block->page);
 	}
+
+	/* The adaptive hash index is disabled while the buffer
+	pool is being shrunk. */
+	ut_ad(!block->index);
+	new_block->index = NULL;
+	new_block->n_hash_helps = 0;
+	new_block->n_fields = 1;
+	new_block->left_side = TRUE;
+	new_block->check_index_page_at_flush
+		= block->check_index_page_at_flush;
+	new_block->lock_hash_val = block->lock_hash_val;
+
+	/* Invalidate the cursors that point to the old block. */
+	buf_block_modify_clock_inc(block);
+
+	rw_lock_x_unlock(hash_lock);
+	mutex_exit(&new_block->mutex);
+
+	/* Free the old block; buf_LRU_block_free_non_file_page()
+	puts it to buf_pool->withdraw. */
+	buf_block_set_state(block, BUF_BLOCK_REMOVE_HASH);
+	buf_block_set_state(block, BUF_BLOCK_MEMORY);
+	buf_LRU_block_free_non_file_page(block);
+
+	mutex_exit(&block->mutex);
+
+	return(true);
+}
+
+/********************************************************************//**
+Withdraws the blocks of the chunks [n_chunks_new, n_chunks) of a buffer
+pool instance. The free blocks there are moved to buf_pool->withdraw,
+and the pages stored there are moved to other blocks. Blocks that are
+in use are skipped; the next call will retry them.
+@return	true if all the blocks of the chunks have been withdrawn */
+static
+bool
+buf_pool_withdraw_blocks(
+/*=====================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	buf_block_t*	block;
+	buf_page_t*	bpage;
+	bool		done;
+
+	buf_pool_mutex_enter(buf_pool);
+
+	ut_ad(buf_pool->withdraw_target > 0);
+
+	/* Move the free blocks of the chunks to buf_pool->withdraw. */
+	block = (buf_block_t*) UT_LIST_GET_FIRST(buf_pool->free);
+
+	while (block != NULL) {
+		buf_block_t*	next_block = (buf_block_t*)
+			UT_LIST_GET_NEXT(list, &block->page);
+
+		ut_ad(block->page.in_free_list);
+
+		if (buf_block_will_be_withdrawn(buf_pool, block)) {
+			UT_LIST_REMOVE(list, buf_pool->free, &block->page);
+			ut_d(block->page.in_free_list = FALSE);
+			UT_LIST_ADD_LAST(list, buf_pool->withdraw,
+					 &block->page);
+		}
+
+		block = next_block;
+	}
+
+	/* Combine the free compressed page fragments in the chunks,
+	so that whole frames are returned. */
+	buf_buddy_condense_free(buf_pool);
+
+	/* Move the pages that are stored in the chunks. */
+	bpage = UT_LIST_GET_FIRST(buf_pool->LRU);
+
+	while (bpage != NULL) {
+		ib_mutex_t*	block_mutex = buf_page_get_mutex(bpage);
+		buf_page_t*	next_bpage = UT_LIST_GET_NEXT(LRU, bpage);
+
+		mutex_enter(block_mutex);
+
+		if (bpage->zip.data != NULL
+		    && buf_frame_will_be_withdrawn(buf_pool, bpage->zip.data)
+		    && buf_page_can_relocate(bpage)) {
+
+			mutex_exit(block_mutex);
+			buf_pool_mutex_exit_forbid(buf_pool);
+
+			bool	ok = buf_buddy_realloc(
+				buf_pool, bpage->zip.data,
+				page_zip_get_size(&bpage->zip));
+
+			buf_pool_mutex_exit_allow(buf_pool);
+
+			if (!ok) {
+				/* The free list is empty. */
+				break;
+			}
+
+			mutex_enter(block_mutex);
+		}
+
+		if (buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE
+		    && buf_block_will_be_withdrawn(
+			    buf_pool, (buf_block_t*) bpage)
+		    && buf_page_can_relocate(bpage)) {
+
+			mutex_exit(block_mutex);
+			buf_pool_mutex_exit_forbid(buf_pool);
+
+			bool	ok = buf_page_realloc(
+				buf_pool, (buf_block_t*) bpage);
+
+			buf_pool_mutex_exit_allow(buf_pool);
+
+			if (!ok) {
+				/* The free list is empty. */
+				break;
+			}
+		} else {
+			mutex_exit(block_mutex);
+		}
+
+		bpage = next_bpage;
+	}
+
+	ut_ad(UT_LIST_GET_LEN(buf_pool->withdraw)
+	      <= buf_pool->withdraw_target);
+
+	done = UT_LIST_GET_LEN(buf_pool->withdraw)
+		== buf_pool->withdraw_target;
+
+	buf_pool_mutex_exit(buf_pool);
+
+	return(done);
+}
+
+/********************************************************************//**
+Stops withdrawing the blocks of a buffer pool instance and returns the
+blocks that were withdrawn to the free list. */
+static
+void
+buf_pool_withdraw_cancel(
+/*=====================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	buf_page_t*	bpage;
+
+	buf_pool_mutex_enter(buf_pool);
+
+	while ((bpage = UT_LIST_GET_FIRST(buf_pool->withdraw)) != NULL) {
+		UT_LIST_REMOVE(list, buf_pool->withdraw, bpage);
+		UT_LIST_ADD_LAST(list, buf_pool->free, bpage);
+		ut_d(bpage->in_free_list = TRUE);
+	}
+
+	buf_pool->withdraw_target = 0;
+	buf_pool->n_chunks_new = buf_pool->n_chunks;
+
+	buf_pool_mutex_exit(buf_pool);
+}
+
+/********************************************************************//**
+Moves the buf_page_t nodes of a page_hash or zip_hash to another hash
+table. */
+static
+void
+buf_pool_hash_migrate(
+/*==================*/
+	hash_table_t*	old_hash,	/*!< in/out: hash table to empty */
+	hash_table_t*	new_hash,	/*!< in/out: hash table to fill */
+	bool		zip)		/*!< in: true if old_hash is
+					a buf_pool->zip_hash */
+{
+	for (ulint i = 0; i < hash_get_n_cells(old_hash); i++) {
+		buf_page_t*	bpage = static_cast<buf_page_t*>(
+			HASH_GET_FIRST(old_hash, i));
+
+		while (bpage != NULL) {
+			buf_page_t*	next = bpage->hash;
+			ulint		fold = zip
+				? BUF_POOL_ZIP_FOLD_BPAGE(bpage)
+				: buf_page_address_fold(
+					bpage->space, bpage->offset);
+
+			HASH_INSERT(buf_page_t, hash, new_hash, fold, bpage);
+
+			bpage = next;
+		}
+	}
+}
+
+/********************************************************************//**
+Resizes buf_pool->page_hash and buf_pool->zip_hash to the current size of
+the buffer pool instance. The page_hash keeps its locks; only its cell
+array is replaced. */
+static
+void
+buf_pool_resize_hash(
+/*=================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	hash_table_t*	new_hash;
+	hash_cell_t*	old_array;
+
+	ut_ad(buf_pool_mutex_own(buf_pool));
+
+	new_hash = hash_create(2 * buf_pool->curr_size);
+
+	buf_pool_hash_migrate(buf_pool->page_hash, new_hash, false);
+
+	old_array = buf_pool->page_hash->array;
+	buf_pool->page_hash->array = new_hash->array;
+	buf_pool->page_hash->n_cells = new_hash->n_cells;
+	new_hash->array = old_array;
+
+	hash_table_free(new_hash);
+
+	new_hash = hash_create(2 * buf_pool->curr_size);
+
+	buf_pool_hash_migrate(buf_pool->zip_hash, new_hash, true);
+
+	hash_table_free(buf_pool->zip_hash);
+	buf_pool->zip_hash = new_hash;
+}
+
+/********************************************************************//**
+Removes the chunks [n_chunks_new, n_chunks) of a buffer pool instance,
+after all their blocks have been withdrawn, and frees their memory. */
+static
+void
+buf_pool_remove_chunks(
+/*===================*/
+	buf_pool_t*	buf_pool)	/*!< in/out: buffer pool instance */
+{
+	buf_chunk_t*	chunk;
+	buf_chunk_t*	echunk;
+
+	buf_pool_mutex_enter(buf_pool);
+	hash_lock_x_all(buf_pool->page_hash);
+
+	ut_ad(UT_LIST_GET_LEN(buf_pool->withdraw)
+	      == buf_pool->withdraw_target);
+
+	chunk = buf_pool->chunks + buf_pool->n_chunks_new;
+	echunk = buf_pool->chunks + buf_pool->n_chunks;
+
+	for (buf_chunk_t* c = chunk; c < echunk; c++) {
+		buf_pool->curr_size -= c->size;
+	}
+
+	/* The blocks in buf_pool->withdraw are the blocks of
+	the chunks that are being removed. */
+	UT_LIST_INIT(buf_pool->withdraw);
+	buf_pool->withdraw_target = 0;
+
+	buf_pool->n_chunks = buf_pool->n_chunks_new;
+	buf_pool->curr_pool_size = buf_pool->curr_size * UNIV_PAGE_SIZE;
+	buf_pool->old_pool_size = buf_pool->curr_pool_size;
+
+	buf_pool_publish_chunk_map(buf_pool);
+
+	buf_pool_resize_hash(buf_pool);
+
+	hash_unlock_x_all(buf_pool->page_hash);
+	buf_pool_mutex_exit(buf_pool);
+
+	/* No block of the removed chunks is in use, so no pointer
+	that is passed to buf_block_align() can point into them. The
+	entries stay in buf_pool->chunks beyond n_chunks. */
+	for (; chunk < echunk; chunk++) {
+		buf_chunk_free(chunk);
+	}
+}
+
+/********************************************************************//**
+Adds chunks to a buffer pool instance until it has n_chunks chunks.
+@return	false if not all the chunks could be allocated */
+static
+bool
+buf_pool_add_chunks(
+/*================*/
+	buf_pool_t*	buf_pool,	/*!< in/out: buffer pool instance */
+	ulint		n_chunks)	/*!< in: new number of chunks */
+{
+	buf_chunk_t*	new_chunks;
+	ulint		n;
+
+	ut_ad(n_chunks > buf_pool->n_chunks);
+
+	/* Allocate the memory without holding any latch. The
+	current chunks are not changed by other threads. */
+	new_chunks = (buf_chunk_t*) mem_zalloc(n_chunks * sizeof *new_chunks);
+	memcpy(new_chunks, buf_pool->chunks,
+	       buf_pool->n_chunks * sizeof *new_chunks);
+
+	for (n = buf_pool->n_chunks; n < n_chunks; n++) {
+		if (!buf_chunk_init(buf_pool, &new_chunks[n],
+				    srv_buf_pool_chunk_unit)) {
+			break;
+		}
+	}
+
+	buf_pool_mutex_enter(buf_pool);
+	hash_lock_x_all(buf_pool->page_hash);
+
+	/* Only threads that hold buf_pool->mutex read buf_pool->chunks;
+	the others read buf_pool->chunk_map. */
+	mem_free(buf_pool->chunks);
+	buf_pool->chunks = new_chunks;
+
+	for (ulint i = buf_pool->n_chunks; i < n; i++) {
+		buf_chunk_add_to_free_list(buf_pool, &new_chunks[i]);
+		buf_pool->curr_size += new_chunks[i].size;
+	}
+
+	buf_pool->n_chunks = n;
+	buf_pool->n_chunks_new = n;
+	buf_pool->curr_pool_size = buf_pool->curr_size * UNIV_PAGE_SIZE;
+	buf_pool->old_pool_size = buf_pool->curr_pool_size;
+
+	buf_pool_publish_chunk_map(buf_pool);
+
+	buf_pool_resize_hash(buf_pool);
+
+	hash_unlock_x_all(buf_pool->page_hash);
+	buf_pool_mutex_exit(buf_pool);
+
+	return(n == n_chunks);
+}
+
+/********************************************************************//**
+Resizes the buffer pool to srv_buf_pool_size by adding chunks to or
+removing chunks from every instance. Before chunks are removed, the
+pages stored in them are moved to other blocks, which may take many
+passes if the pages are in use. The resize is abandoned if
+srv_buf_pool_size is changed again meanwhile, or at shutdown. */
+static
+void
+buf_pool_resize(void)
+/*=================*/
+{
+	const ulint	size = srv_buf_pool_size;
+	const ulint	n_chunks = ut_max(
+		(ulint) 1,
+		(size / srv_buf_pool_instances + srv_buf_pool_chunk_unit - 1)
+		/ srv_buf_pool_chunk_unit);
+	bool		shrink = false;
+	bool		grow = false;
+	bool		ahi_enabled = btr_search_enabled;
+	ulint		i;
+
+	for (i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+		if (n_chunks < buf_pool->n_chunks) {
+			shrink = true;
+		} else if (n_chunks > buf_pool->n_chunks) {
+			grow = true;
+		}
+	}
+
+	if (shrink && os_aio_buffers_registered()) {
+		/* The rings would keep using the memory of the
+		removed chunks. */
+		buf_resize_status("Cannot shrink the buffer pool while"
+				  " it is registered with io_uring.");
+		srv_buf_pool_old_size = size;
+		return;
+	}
+
+	buf_resize_status("Resizing the buffer pool from %lu to %lu bytes"
+			  " (%lu chunks of %lu bytes per instance).",
+			  (ulong) srv_buf_pool_curr_size, (ulong) size,
+			  (ulong) n_chunks, (ulong) srv_buf_pool_chunk_unit);
+
+	/* The adaptive hash index points into the frames of the
+	pages that are moved, and its size depends on the size of
+	the buffer pool. It is rebuilt by the workload afterwards.
+	btr_search_enable() does nothing while buf_pool_withdrawing
+	is set. */
+	if (shrink) {
+		buf_pool_withdrawing = true;
+	}
+
+	if (ahi_enabled) {
+		btr_search_disable();
+	}
+
+	if (shrink) {
+		ulint	n_pass = 0;
+
+		for (i = 0; i < srv_buf_pool_instances; i++) {
+			buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+			if (n_chunks >= buf_pool->n_chunks) {
+				continue;
+			}
+
+			buf_pool_mutex_enter(buf_pool);
+
+			buf_pool->n_chunks_new = n_chunks;
+			buf_pool->withdraw_target = 0;
+
+			for (ulint j = n_chunks; j < buf_pool->n_chunks; j++) {
+				buf_pool->withdraw_target
+					+= buf_pool->chunks[j].size;
+			}
+
+			buf_pool_mutex_exit(buf_pool);
+		}
+
+		for (;;) {
+			ulint	n_withdrawn = 0;
+			ulint	n_target = 0;
+			bool	done = true;
+
+			for (i = 0; i < srv_buf_pool_instances; i++) {
+				buf_pool_t*	buf_pool
+					= buf_pool_from_array(i);
+
+				if (buf_pool->withdraw_target == 0) {
+					continue;
+				}
+
+				if (!buf_pool_withdraw_blocks(buf_pool)) {
+					done = false;
+				}
+
+				n_withdrawn += UT_LIST_GET_LEN(
+					buf_pool->withdraw);
+				n_target += buf_pool->withdraw_target;
+			}
+
+			if (done) {
+				break;
+			}
+
+			if (srv_shutdown_state != SRV_SHUTDOWN_NONE
+			    || srv_buf_pool_size != size) {
+
+				for (i = 0; i < srv_buf_pool_instances; i++) {
+					buf_pool_withdraw_cancel(
+						buf_pool_from_array(i));
+				}
+
+				buf_pool_withdrawing = false;
+
+				buf_resize_status(
+					"Resizing the buffer pool to %lu"
+					" bytes was abandoned.",
+					(ulong) size);
+
+				goto func_exit;
+			}
+
+			if (++n_pass % 10 == 0) {
+				buf_resize_status(
+					"Withdrawing blocks (%lu/%lu).",
+					(ulong) n_withdrawn,
+					(ulong) n_target);
+			}
+
+			/* Make free blocks for the pages to be
+			moved to, and give the threads that use the
+			remaining pages a chance to release them. */
+			buf_flush_LRU_tail();
+			os_thread_sleep(100000);
+		}
+
+		for (i = 0; i < srv_buf_pool_instances; i++) {
+			buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+			if (buf_pool->n_chunks_new < buf_pool->n_chunks) {
+				buf_pool_remove_chunks(buf_pool);
+			}
+		}
+
+		/* Pointers to blocks that were saved before this
+		may point to the freed chunks. */
+		buf_withdraw_clock++;
+		buf_pool_withdrawing = false;
+	}
+
+	if (grow) {
+		for (i = 0; i < srv_buf_pool_instances; i++) {
+			buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+			if (n_chunks > buf_pool->n_chunks
+			    && !buf_pool_add_chunks(buf_pool, n_chunks)) {
+
+				ib_logf(IB_LOG_LEVEL_ERROR,
+					"Cannot allocate all the chunks"
+					" of buffer pool instance %lu.",
+					(ulong) i);
+			}
+		}
+	}
+
+	buf_pool_set_sizes();
+
+	buf_resize_status("Resized the buffer pool to %lu bytes.",
+			  (ulong) srv_buf_pool_curr_size);
+
+func_exit:
+	if (ahi_enabled) {
+		btr_search_sys_resize(
+			buf_pool_get_curr_size() / sizeof(void*) / 64);
+		btr_search_enable();
+	}
+
+	/* buf_pool_set_sizes() copied srv_buf_pool_size, which may
+	have been changed meanwhile. A size that could not be reached
+	is not retried until it is changed. */
+	srv_buf_pool_old_size = size;
+}
+
+/*****************************************************************//**
+This is the thread that resizes the buffer pool. It waits for an event
+and when woken up adds or removes chunks until the size of the buffer
+pool matches srv_buf_pool_size.
+@return this function does not return, it calls os_thread_exit() */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_resize_thread)(
+/*==============================*/
+	void*	arg __attribute__((unused)))	/*!< in: a dummy parameter
+						required by os_thread_create */
+{
+	ut_ad(!srv_read_only_mode);
+
+	srv_buf_resize_thread_active = TRUE;
+
+	ut_strlcpy(export_vars.innodb_buffer_pool_resize_status,
+		   "not started",
+		   sizeof(export_vars.innodb_buffer_pool_resize_status));
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		ib_int64_t	sig_count = os_event_reset(srv_buf_resize_event);
+
+		if (srv_buf_pool_size == srv_buf_pool_old_size) {
+			os_event_wait_low(srv_buf_resize_event, sig_count);
+		}
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			break;
+		}
+
+		if (srv_buf_pool_size != srv_buf_pool_old_size) {
+			buf_pool_resize();
+		}
+	}
+
+	srv_buf_resize_thread_active = FALSE;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
 }
 
 /********************************************************************//**
@@ -1770,7 +2710,7 @@ buf_pool_watch_unset(
 	buf_page_t*	bpage;
 	buf_pool_t*	buf_pool = buf_pool_get(space, offset);
 	ulint		fold = buf_page_address_fold(space, offset);
-	rw_lock_t*	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
+	rw_lock_t*	hash_lock;
 
 	/* We only need to have buf_pool mutex in case where we end
 	up calling buf_pool_watch_remove but to obey latching order
@@ -1779,6 +2719,9 @@ buf_pool_watch_unset(
 	called from the purge thread. */
 	buf_pool_mutex_enter(buf_pool);
 
+	/* The page_hash cannot be resized while we hold the
+	buf_pool->mutex. */
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 
 	/* The page must exist because buf_pool_watch_set() increments
@@ -1827,6 +2770,7 @@ buf_pool_watch_occurred(
 							     fold);
 
 	rw_lock_s_lock(hash_lock);
+	hash_lock = hash_lock_s_confirm(hash_lock, buf_pool->page_hash, fold);
 
 	/* The page must exist because buf_pool_watch_set()
 	increments buf_fix_count. */
@@ -2247,15 +3191,27 @@ buf_block_align_instance(
 					resides */
 	const byte*	ptr)		/*!< in: pointer to a frame */
 {
-	buf_chunk_t*	chunk;
-	ulint		i;
+	const buf_chunk_map_t*	map;
+	buf_chunk_t*		chunk;
+	ulint			i;
+
+	/* buf_pool_resize() may be publishing a new map. A map is
+	never changed or freed while the buffer pool is in use. The
+	memory of a removed chunk is not dereferenced here, because a
+	pointer to a frame that is in use cannot point into it. */
+	map = buf_pool->chunk_map;
+	os_rmb;
+
+	if (UNIV_UNLIKELY(map == NULL)) {
+		return(NULL);
+	}
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
-	for (chunk = buf_pool->chunks, i = buf_pool->n_chunks; i--; chunk++) {
+	for (chunk = map->chunks, i = map->n_chunks; i--; chunk++) {
 		ulint	offs;
 
-		if (UNIV_UNLIKELY(ptr < chunk->blocks->frame)) {
+		if (ptr < (const byte*) chunk->mem
+		    || ptr >= (const byte*) chunk->mem + chunk->mem_size
+		    || UNIV_UNLIKELY(ptr < chunk->blocks->frame)) {
 
 			continue;
 		}
@@ -2367,8 +3323,8 @@ buf_pointer_is_block_field_instance(
 	const buf_chunk_t*		chunk	= buf_pool->chunks;
 	const buf_chunk_t* const	echunk	= chunk + buf_pool->n_chunks;
 
-	/* TODO: protect buf_pool->chunks with a mutex (it will
-	currently remain constant after buf_pool_init()) */
+	/* The pointers are only compared; see the comment in
+	buf_block_align_instance() about buf_pool_resize(). */
 	while (chunk < echunk) {
 		if (ptr >= (void*) chunk->blocks
 		    && ptr < (void*) (chunk->blocks + chunk->size)) {
@@ -2554,6 +3510,9 @@ loop:
 
 	rw_lock_s_lock(hash_lock);
 
+	/* The page_hash may have been resized while we waited. */
+	hash_lock = hash_lock_s_confirm(hash_lock, buf_pool->page_hash, fold);
+
 	if (block != NULL) {
 
 		/* If the guess is a compressed page descriptor that
@@ -2588,6 +3547,8 @@ loop:
 
 		if (mode == BUF_GET_IF_IN_POOL_OR_WATCH) {
 			rw_lock_x_lock(hash_lock);
+			hash_lock = hash_lock_x_confirm(
+				hash_lock, buf_pool->page_hash, fold);
 			block = (buf_block_t*) buf_pool_watch_set(
 				space, offset, fold);
 
@@ -2737,6 +3698,7 @@ got_block:
 
 		buf_pool_mutex_enter(buf_pool);
 
+		hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 		rw_lock_x_lock(hash_lock);
 
 		/* Buffer-fixing prevents the page_hash from changing. */
@@ -2916,6 +3878,8 @@ got_block:
 		if (buf_LRU_free_page(&fix_block->page, true)) {
 			buf_pool_mutex_exit(buf_pool);
 			rw_lock_x_lock(hash_lock);
+			hash_lock = hash_lock_x_confirm(
+				hash_lock, buf_pool->page_hash, fold);
 
 			if (mode == BUF_GET_IF_IN_POOL_OR_WATCH) {
 				/* Set the watch, as it would have
@@ -3547,9 +4511,10 @@ buf_page_init_for_read(
 	}
 
 	fold = buf_page_address_fold(space, offset);
-	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 
 	buf_pool_mutex_enter(buf_pool);
+
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 
 	watch_page = buf_page_hash_get_low(buf_pool, space, offset, fold);
@@ -3647,6 +4612,9 @@ err_exit:
 		uninitialized data. */
 		data = buf_buddy_alloc(buf_pool, zip_size, &lru);
 
+		/* buf_buddy_alloc() may have released buf_pool->mutex,
+		and the page_hash may have been resized meanwhile. */
+		hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 		rw_lock_x_lock(hash_lock);
 
 		/* If buf_buddy_alloc() allocated storage from the LRU list,
@@ -3786,9 +4754,10 @@ buf_page_create(
 	free_block = buf_LRU_get_free_block(buf_pool);
 
 	fold = buf_page_address_fold(space, offset);
-	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 
 	buf_pool_mutex_enter(buf_pool);
+
+	hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 	rw_lock_x_lock(hash_lock);
 
 	block = (buf_block_t*) buf_page_hash_get_low(
@@ -4115,6 +5084,12 @@ buf_page_io_complete(
 		} else {
 			ut_a(uncompressed);
 			frame = ((buf_block_t*) bpage)->frame;
+
+			/* Pages of tablespaces with page compression
+			are only kept uncompressed in the buffer pool. */
+			if (!os_file_decompress_page(frame)) {
+				goto corrupt;
+			}
 		}
 
 		/* If this page is not uninitialized and not in the
@@ -4645,9 +5620,14 @@ assert_s_latched:
 	}
 
 	ut_a(UT_LIST_GET_LEN(buf_pool->LRU) == n_lru);
-	if (UT_LIST_GET_LEN(buf_pool->free) != n_free) {
-		fprintf(stderr, "Free list len %lu, free blocks %lu\n",
+	/* The free blocks of the chunks being withdrawn are kept
+	in buf_pool->withdraw. */
+	if (UT_LIST_GET_LEN(buf_pool->free)
+	    + UT_LIST_GET_LEN(buf_pool->withdraw) != n_free) {
+		fprintf(stderr, "Free list len %lu, withdraw list len %lu,"
+			" free blocks %lu\n",
 			(ulong) UT_LIST_GET_LEN(buf_pool->free),
+			(ulong) UT_LIST_GET_LEN(buf_pool->withdraw),
 			(ulong) n_free);
 		ut_error;
 	}
@@ -5064,6 +6044,8 @@ buf_stats_get_pool_info(
 
 	pool_info->pool_unique_id = pool_id;
 
+	pool_info->numa_node = buf_pool->numa_node;
+
 	pool_info->pool_size = buf_pool->curr_size;
 
 	pool_info->lru_len = UT_LIST_GET_LEN(buf_pool->LRU);
@@ -5311,7 +6293,13 @@ buf_print_io(
 		"----------------------\n", file);
 
 		for (i = 0; i < srv_buf_pool_instances; i++) {
-			fprintf(file, "---BUFFER POOL %lu\n", i);
+			if (pool_info[i].numa_node != ULINT_UNDEFINED) {
+				fprintf(file, "---BUFFER POOL %lu"
+					" (NUMA node %lu)\n",
+					i, pool_info[i].numa_node);
+			} else {
+				fprintf(file, "---BUFFER POOL %lu\n", i);
+			}
 			buf_print_io_instance(&pool_info[i], file);
 		}
 	}
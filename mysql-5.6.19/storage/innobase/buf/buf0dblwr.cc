@@ -43,8 +43,12 @@ Created 2011/12/19
 #ifdef UNIV_PFS_MUTEX
 /* Key to register the mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	buf_dblwr_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	buf_dblwr_file_mutex_key;
 #endif /* UNIV_PFS_RWLOCK */
 
+/** Name prefix of the doublewrite files in the data home directory */
+#define BUF_DBLWR_FILE_PREFIX	"ib_dblwr_"
+
 /** The doublewrite buffer */
 UNIV_INTERN buf_dblwr_t*	buf_dblwr = NULL;
 
@@ -121,6 +125,256 @@ buf_dblwr_sync_datafiles()
 	fil_flush_file_spaces(FIL_TABLESPACE);
 }
 
+/****************************************************************//**
+Builds the path of a doublewrite file.
+@return	path of the file, to be freed with mem_free() */
+static
+char*
+buf_dblwr_file_path(
+/*================*/
+	ulint	i)	/*!< in: number of the doublewrite file */
+{
+	ulint	len = strlen(srv_data_home) + sizeof(BUF_DBLWR_FILE_PREFIX)
+		+ 22;
+	char*	path = static_cast<char*>(mem_alloc(len));
+
+	ut_snprintf(path, len, "%s%c" BUF_DBLWR_FILE_PREFIX "%lu",
+		    srv_data_home, SRV_PATH_SEPARATOR, (ulong) i);
+
+	srv_normalize_path_for_win(path);
+
+	return(path);
+}
+
+/****************************************************************//**
+Gets the doublewrite file used by the flush batches of a buffer pool
+instance.
+@return	doublewrite file */
+UNIV_INLINE
+buf_dblwr_file_t*
+buf_dblwr_get_file(
+/*===============*/
+	const buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_flush_t		flush_type)	/*!< in: BUF_FLUSH_LRU or
+						BUF_FLUSH_LIST */
+{
+	ulint	i;
+
+	ut_ad(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
+
+	i = buf_pool_index(buf_pool) * 2 + flush_type;
+	ut_ad(i < buf_dblwr->n_files);
+
+	return(&buf_dblwr->files[i]);
+}
+
+/****************************************************************//**
+Frees the doublewrite files structures and closes the files. */
+static
+void
+buf_dblwr_files_free(
+/*=================*/
+	buf_dblwr_file_t*	files,	/*!< in,own: doublewrite files */
+	ulint			n_files)/*!< in: number of files opened */
+{
+	for (ulint i = 0; i < n_files; i++) {
+		buf_dblwr_file_t*	dblwr_file = &files[i];
+
+		ut_ad(dblwr_file->b_reserved == 0);
+
+		os_file_close(dblwr_file->file);
+		mem_free(dblwr_file->path);
+		os_event_free(dblwr_file->b_event);
+		ut_free(dblwr_file->write_buf_unaligned);
+		mem_free(dblwr_file->buf_block_arr);
+		mutex_free(&dblwr_file->mutex);
+	}
+
+	mem_free(files);
+}
+
+/****************************************************************//**
+Opens or creates the doublewrite files of the flush batches, one for
+each buffer pool instance and flush type, if innodb_doublewrite_files
+is set. If a file cannot be opened, the flush batches fall back to the
+doublewrite buffer in the system tablespace. */
+static
+void
+buf_dblwr_files_init(void)
+/*======================*/
+{
+	buf_dblwr_file_t*	files;
+	ulint			n_files;
+	ulint			i;
+
+	ut_ad(buf_dblwr->n_files == 0);
+
+	if (!srv_dblwr_files || !srv_use_doublewrite_buf
+	    || srv_read_only_mode || fc_is_enabled()) {
+
+		return;
+	}
+
+	/* One file for BUF_FLUSH_LRU and one for BUF_FLUSH_LIST
+	batches of every buffer pool instance */
+	n_files = 2 * srv_buf_pool_instances;
+
+	files = static_cast<buf_dblwr_file_t*>(
+		mem_zalloc(n_files * sizeof(buf_dblwr_file_t)));
+
+	for (i = 0; i < n_files; i++) {
+		buf_dblwr_file_t*	dblwr_file = &files[i];
+		char*			path = buf_dblwr_file_path(i);
+		ibool			exists;
+		os_file_type_t		type;
+		ibool			success;
+
+		success = os_file_status(path, &exists, &type);
+
+		if (success) {
+			dblwr_file->file = os_file_create(
+				innodb_file_data_key, path,
+				exists ? OS_FILE_OPEN : OS_FILE_CREATE,
+				OS_FILE_NORMAL, OS_DATA_FILE, &success);
+		}
+
+		if (!success) {
+			ib_logf(IB_LOG_LEVEL_WARN,
+				"Cannot open doublewrite file '%s'. The "
+				"doublewrite buffer in the system tablespace "
+				"will be used for all flush batches.", path);
+
+			mem_free(path);
+			buf_dblwr_files_free(files, i);
+
+			return;
+		}
+
+		mutex_create(buf_dblwr_file_mutex_key,
+			     &dblwr_file->mutex, SYNC_DOUBLEWRITE);
+
+		dblwr_file->path = path;
+		dblwr_file->b_event = os_event_create();
+
+		dblwr_file->write_buf_unaligned = static_cast<byte*>(
+			ut_malloc((1 + srv_doublewrite_batch_size)
+				  * UNIV_PAGE_SIZE));
+
+		dblwr_file->write_buf = static_cast<byte*>(
+			ut_align(dblwr_file->write_buf_unaligned,
+				 UNIV_PAGE_SIZE));
+
+		dblwr_file->buf_block_arr = static_cast<buf_page_t**>(
+			mem_zalloc(srv_doublewrite_batch_size
+				   * sizeof(void*)));
+	}
+
+	buf_dblwr->files = files;
+	buf_dblwr->n_files = n_files;
+}
+
+/****************************************************************//**
+Reads the pages of all existing doublewrite files into memory for crash
+recovery. The files of every number are read, regardless of the current
+configuration, because the previous server instance may have run with a
+different number of buffer pool instances. */
+static
+void
+buf_dblwr_files_load(void)
+/*======================*/
+{
+	os_offset_t	total_size = 0;
+	ulint		n_files;
+	byte*		buf;
+	byte*		page;
+	ulint		n_pages = 0;
+	recv_dblwr_t&	recv_dblwr = recv_sys->dblwr;
+
+	ut_ad(buf_dblwr->recv_buf_unaligned == NULL);
+
+	/* Find out the total size of the files first, so that all pages
+	can be read into one buffer. */
+	for (n_files = 0; ; n_files++) {
+		char*		path = buf_dblwr_file_path(n_files);
+		ibool		success;
+		os_file_t	file;
+
+		file = os_file_create_simple_no_error_handling(
+			innodb_file_data_key, path, OS_FILE_OPEN,
+			OS_FILE_READ_ONLY, &success);
+
+		mem_free(path);
+
+		if (!success) {
+			break;
+		}
+
+		total_size += ut_2pow_round(os_file_get_size(file),
+					    UNIV_PAGE_SIZE);
+
+		os_file_close(file);
+	}
+
+	if (total_size == 0) {
+		return;
+	}
+
+	buf_dblwr->recv_buf_unaligned = static_cast<byte*>(
+		ut_malloc(UNIV_PAGE_SIZE + total_size));
+
+	buf = static_cast<byte*>(
+		ut_align(buf_dblwr->recv_buf_unaligned, UNIV_PAGE_SIZE));
+
+	page = buf;
+
+	for (ulint i = 0; i < n_files; i++) {
+		char*		path = buf_dblwr_file_path(i);
+		ibool		success;
+		os_file_t	file;
+		os_offset_t	size;
+
+		file = os_file_create_simple_no_error_handling(
+			innodb_file_data_key, path, OS_FILE_OPEN,
+			OS_FILE_READ_ONLY, &success);
+
+		if (!success) {
+			mem_free(path);
+			break;
+		}
+
+		size = ut_2pow_round(os_file_get_size(file), UNIV_PAGE_SIZE);
+
+		/* The file may have grown after the first pass only if
+		another process is using it, which is not supported. */
+		size = ut_min(size, total_size - (page - buf));
+
+		if (size > 0 && !os_file_read(file, page, 0, (ulint) size)) {
+			ib_logf(IB_LOG_LEVEL_WARN,
+				"Cannot read doublewrite file '%s'.", path);
+			size = 0;
+		}
+
+		os_file_close(file);
+		mem_free(path);
+
+		for (byte* end = page + size; page < end;
+		     page += UNIV_PAGE_SIZE) {
+
+			/* Pages that were never written in a batch */
+			if (buf_page_is_zeroes(page, 0)) {
+				continue;
+			}
+
+			recv_dblwr.add(page);
+			n_pages++;
+		}
+	}
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Read %lu pages from %lu doublewrite files.",
+		(ulong) n_pages, (ulong) n_files);
+}
+
 /****************************************************************//**
 Creates or initialializes the doublewrite buffer at a database start. */
 static
@@ -170,6 +424,8 @@ buf_dblwr_init(
 
 	buf_dblwr->buf_block_arr = static_cast<buf_page_t**>(
 		mem_zalloc(buf_size * sizeof(void*)));
+
+	buf_dblwr_files_init();
 }
 
 /****************************************************************//**
@@ -472,6 +728,10 @@ buf_dblwr_init_or_load_pages(
 		os_file_flush(file);
 	}
 
+	if (load_corrupt_pages) {
+		buf_dblwr_files_load();
+	}
+
 leave_func:
 	ut_free(unaligned_read_buf);
 }
@@ -526,7 +786,8 @@ buf_dblwr_process()
 
 			/* Check if the page is corrupt */
 
-			if (buf_page_is_corrupted(true, read_buf, zip_size)) {
+			if ((!zip_size && !os_file_decompress_page(read_buf))
+			    || buf_page_is_corrupted(true, read_buf, zip_size)) {
 
 				fprintf(stderr,
 					"InnoDB: Warning: database page"
@@ -604,6 +865,47 @@ buf_dblwr_process()
 	ut_free(unaligned_read_buf);
 }
 
+/****************************************************************//**
+Removes the doublewrite files that are not used by the current
+configuration and frees the pages that were read from the doublewrite
+files for crash recovery. Must be called after the crash recovery has
+completed. */
+UNIV_INTERN
+void
+buf_dblwr_files_cleanup(void)
+/*==========================*/
+{
+	ut_a(buf_dblwr != NULL);
+
+	if (buf_dblwr->recv_buf_unaligned != NULL) {
+		ut_free(buf_dblwr->recv_buf_unaligned);
+		buf_dblwr->recv_buf_unaligned = NULL;
+	}
+
+	if (srv_read_only_mode) {
+		return;
+	}
+
+	/* The files of a previous configuration with more buffer pool
+	instances, or all of them if the files are not used anymore */
+	for (ulint i = buf_dblwr->n_files; ; i++) {
+		char*		path = buf_dblwr_file_path(i);
+		ibool		exists;
+		os_file_type_t	type;
+
+		if (!os_file_status(path, &exists, &type) || !exists) {
+			mem_free(path);
+			break;
+		}
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Removing unused doublewrite file '%s'.", path);
+
+		os_file_delete_if_exists(innodb_file_data_key, path);
+		mem_free(path);
+	}
+}
+
 /****************************************************************//**
 Frees doublewrite buffer. */
 UNIV_INTERN
@@ -629,6 +931,17 @@ buf_dblwr_free(void)
 
 	mutex_free(&buf_dblwr->mutex);
 
+	if (buf_dblwr->n_files > 0) {
+		buf_dblwr_files_free(buf_dblwr->files, buf_dblwr->n_files);
+		buf_dblwr->files = NULL;
+		buf_dblwr->n_files = 0;
+	}
+
+	if (buf_dblwr->recv_buf_unaligned != NULL) {
+		ut_free(buf_dblwr->recv_buf_unaligned);
+		buf_dblwr->recv_buf_unaligned = NULL;
+	}
+
 	if (fc_is_enabled()) {
 		fc_destroy();
 		fc_log_destroy();
@@ -647,13 +960,45 @@ buf_dblwr_update(
 	const buf_page_t*	bpage,	/*!< in: buffer block descriptor */
 	buf_flush_t		flush_type)/*!< in: flush type */
 {
-	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+	if (bpage->dblwr_bypassed) {
+		/* The page was not written through the doublewrite
+		buffer, see buf_flush_write_block_low(). */
 		return;
 	}
 
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
+		if (buf_dblwr->n_files > 0) {
+			buf_dblwr_file_t*	dblwr_file = buf_dblwr_get_file(
+				buf_pool_from_bpage(bpage), flush_type);
+
+			mutex_enter(&dblwr_file->mutex);
+
+			ut_ad(dblwr_file->batch_running);
+			ut_ad(dblwr_file->b_reserved > 0);
+			ut_ad(dblwr_file->b_reserved
+			      <= dblwr_file->first_free);
+
+			dblwr_file->b_reserved--;
+
+			if (dblwr_file->b_reserved == 0) {
+				mutex_exit(&dblwr_file->mutex);
+				/* This will finish the batch. Sync data
+				files to the disk. */
+				fil_flush_file_spaces(FIL_TABLESPACE);
+				mutex_enter(&dblwr_file->mutex);
+
+				/* We can now reuse the write buffer */
+				dblwr_file->first_free = 0;
+				dblwr_file->batch_running = false;
+				os_event_set(dblwr_file->b_event);
+			}
+
+			mutex_exit(&dblwr_file->mutex);
+			break;
+		}
+
 		mutex_enter(&buf_dblwr->mutex);
 
 		ut_ad(buf_dblwr->batch_running);
@@ -831,6 +1176,200 @@ buf_dblwr_write_block_to_datafile(
 
 }
 
+/********************************************************************//**
+Checks the pages of a batch before they are written to the doublewrite
+buffer or file. */
+static
+void
+buf_dblwr_check_batch(
+/*==================*/
+	const byte*		write_buf,	/*!< in: copies of the pages */
+	buf_page_t* const*	block_arr,	/*!< in: pages of the batch */
+	ulint			n_pages)	/*!< in: number of pages */
+{
+	for (ulint len2 = 0, i = 0;
+	     i < n_pages;
+	     len2 += UNIV_PAGE_SIZE, i++) {
+
+		const buf_block_t*	block;
+
+		block = (buf_block_t*) block_arr[i];
+
+		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
+		    || block->page.zip.data) {
+			/* No simple validate for compressed
+			pages exists. */
+			continue;
+		}
+
+		/* Check that the actual page in the buffer pool is
+		not corrupt and the LSN values are sane. */
+		buf_dblwr_check_block(block);
+
+		/* Check that the page as written to the doublewrite
+		buffer has sane LSN values. */
+		buf_dblwr_check_page_lsn(write_buf + len2);
+	}
+}
+
+/********************************************************************//**
+Copies a page into a slot of a doublewrite write buffer. */
+static
+void
+buf_dblwr_copy_page(
+/*================*/
+	byte*			slot,	/*!< out: slot in the write buffer */
+	const buf_page_t*	bpage)	/*!< in: page to copy */
+{
+	ulint	zip_size = buf_page_get_zip_size(bpage);
+
+	if (zip_size) {
+		UNIV_MEM_ASSERT_RW(bpage->zip.data, zip_size);
+		/* Copy the compressed page and clear the rest. */
+		memcpy(slot, bpage->zip.data, zip_size);
+		memset(slot + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
+	} else {
+		ut_a(buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE);
+		UNIV_MEM_ASSERT_RW(((buf_block_t*) bpage)->frame,
+				   UNIV_PAGE_SIZE);
+
+		memcpy(slot, ((buf_block_t*) bpage)->frame, UNIV_PAGE_SIZE);
+	}
+}
+
+/********************************************************************//**
+Writes the batch buffered for a doublewrite file to the file, syncs it
+and posts the writes of the pages to the datafiles. The datafiles are
+synced by the IO helper thread that completes the last write of the
+batch, see buf_dblwr_update(). */
+static
+void
+buf_dblwr_file_flush(
+/*=================*/
+	buf_dblwr_file_t*	dblwr_file,	/*!< in/out: doublewrite file */
+	bool			wait)		/*!< in: whether to wait for
+						a batch that another thread
+						is writing to end */
+{
+	ulint	first_free;
+
+try_again:
+	mutex_enter(&dblwr_file->mutex);
+
+	if (dblwr_file->first_free == 0) {
+
+		mutex_exit(&dblwr_file->mutex);
+
+		return;
+	}
+
+	if (dblwr_file->batch_running) {
+		if (!wait) {
+			/* The thread running the batch posts the
+			writes of its pages itself. */
+			mutex_exit(&dblwr_file->mutex);
+
+			return;
+		}
+
+		ib_int64_t	sig_count = os_event_reset(dblwr_file->b_event);
+		mutex_exit(&dblwr_file->mutex);
+
+		os_event_wait_low(dblwr_file->b_event, sig_count);
+		goto try_again;
+	}
+
+	ut_ad(dblwr_file->first_free == dblwr_file->b_reserved);
+
+	/* Disallow anyone else to post to this doublewrite file or to
+	start another batch of flushing from it. */
+	dblwr_file->batch_running = true;
+	first_free = dblwr_file->first_free;
+
+	mutex_exit(&dblwr_file->mutex);
+
+	buf_dblwr_check_batch(dblwr_file->write_buf,
+			      dblwr_file->buf_block_arr, first_free);
+
+	if (!os_file_write(dblwr_file->path, dblwr_file->file,
+			   dblwr_file->write_buf, 0,
+			   first_free * UNIV_PAGE_SIZE)) {
+
+		ib_logf(IB_LOG_LEVEL_FATAL,
+			"Cannot write to doublewrite file '%s'.",
+			dblwr_file->path);
+	}
+
+	/* increment the doublewrite flushed pages counter */
+	srv_stats.dblwr_pages_written.add(first_free);
+	srv_stats.dblwr_writes.inc();
+
+	/* Now flush the doublewrite file data to disk */
+	os_file_flush(dblwr_file->file);
+
+	/* The batch cannot end before all of its pages have been
+	posted, see the comment in buf_dblwr_flush_buffered_writes(). */
+	for (ulint i = 0; i < first_free; i++) {
+		buf_dblwr_write_block_to_datafile(
+			dblwr_file->buf_block_arr[i], false);
+	}
+
+	os_aio_simulated_wake_handler_threads();
+}
+
+/********************************************************************//**
+Posts a buffer page for writing through a doublewrite file. If the
+write buffer of the file is full, writes it out and waits for free space
+to appear. */
+static
+void
+buf_dblwr_file_add_to_batch(
+/*========================*/
+	buf_dblwr_file_t*	dblwr_file,	/*!< in/out: doublewrite file */
+	buf_page_t*		bpage)		/*!< in: buffer block to write */
+{
+try_again:
+	mutex_enter(&dblwr_file->mutex);
+
+	ut_a(dblwr_file->first_free <= srv_doublewrite_batch_size);
+
+	if (dblwr_file->batch_running) {
+		ib_int64_t	sig_count = os_event_reset(dblwr_file->b_event);
+		mutex_exit(&dblwr_file->mutex);
+
+		os_event_wait_low(dblwr_file->b_event, sig_count);
+		goto try_again;
+	}
+
+	if (dblwr_file->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&dblwr_file->mutex);
+
+		buf_dblwr_file_flush(dblwr_file, true);
+
+		goto try_again;
+	}
+
+	buf_dblwr_copy_page(dblwr_file->write_buf
+			    + UNIV_PAGE_SIZE * dblwr_file->first_free, bpage);
+
+	dblwr_file->buf_block_arr[dblwr_file->first_free] = bpage;
+
+	dblwr_file->first_free++;
+	dblwr_file->b_reserved++;
+
+	ut_ad(dblwr_file->first_free == dblwr_file->b_reserved);
+
+	if (dblwr_file->first_free == srv_doublewrite_batch_size) {
+		mutex_exit(&dblwr_file->mutex);
+
+		buf_dblwr_file_flush(dblwr_file, true);
+
+		return;
+	}
+
+	mutex_exit(&dblwr_file->mutex);
+}
+
 /********************************************************************//**
 Flushes possible buffered writes from the doublewrite memory buffer to disk,
 and also wakes up the aio thread if simulated aio is used. It is very
@@ -852,6 +1391,16 @@ buf_dblwr_flush_buffered_writes(void)
 		return;
 	}
 
+	if (buf_dblwr->n_files > 0) {
+		/* Batches that are already being written are
+		dispatched by the threads writing them. */
+		for (ulint i = 0; i < buf_dblwr->n_files; i++) {
+			buf_dblwr_file_flush(&buf_dblwr->files[i], false);
+		}
+
+		return;
+	}
+
 try_again:
 	mutex_enter(&buf_dblwr->mutex);
 
@@ -900,29 +1449,8 @@ try_again:
 
 	write_buf = buf_dblwr->write_buf;
 
-	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
-	     len2 += UNIV_PAGE_SIZE, i++) {
-
-		const buf_block_t*	block;
-
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
-
-		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
-		    || block->page.zip.data) {
-			/* No simple validate for compressed
-			pages exists. */
-			continue;
-		}
-
-		/* Check that the actual page in the buffer pool is
-		not corrupt and the LSN values are sane. */
-		buf_dblwr_check_block(block);
-
-		/* Check that the page as written to the doublewrite
-		buffer has sane LSN values. */
-		buf_dblwr_check_page_lsn(write_buf + len2);
-	}
+	buf_dblwr_check_batch(write_buf, buf_dblwr->buf_block_arr,
+			      buf_dblwr->first_free);
 
 	/* Write out the first block of the doublewrite buffer */
 	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
@@ -988,6 +1516,30 @@ flush:
 	os_aio_simulated_wake_handler_threads();
 }
 
+/********************************************************************//**
+Flushes the writes buffered for a flush batch of a buffer pool instance.
+If the doublewrite files are used, only the file of the buffer pool
+instance and flush type is written, so that batches of other instances
+and flush types are not waited for; otherwise this is the same as
+buf_dblwr_flush_buffered_writes(). */
+UNIV_INTERN
+void
+buf_dblwr_flush_batch(
+/*==================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_flush_t	flush_type)	/*!< in: BUF_FLUSH_LRU or
+					BUF_FLUSH_LIST */
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL
+	    || buf_dblwr->n_files == 0) {
+
+		buf_dblwr_flush_buffered_writes();
+		return;
+	}
+
+	buf_dblwr_file_flush(buf_dblwr_get_file(buf_pool, flush_type), true);
+}
+
 /********************************************************************//**
 Posts a buffer page for writing. If the doublewrite memory buffer is
 full, calls buf_dblwr_flush_buffered_writes and waits for for free
@@ -998,10 +1550,16 @@ buf_dblwr_add_to_batch(
 /*====================*/
 	buf_page_t*	bpage)	/*!< in: buffer block to write */
 {
-	ulint	zip_size;
-
 	ut_a(buf_page_in_file(bpage));
 
+	if (buf_dblwr->n_files > 0) {
+		buf_dblwr_file_add_to_batch(
+			buf_dblwr_get_file(buf_pool_from_bpage(bpage),
+					   buf_page_get_flush_type(bpage)),
+			bpage);
+		return;
+	}
+
 try_again:
 	mutex_enter(&buf_dblwr->mutex);
 
@@ -1030,26 +1588,8 @@ try_again:
 		goto try_again;
 	}
 
-	zip_size = buf_page_get_zip_size(bpage);
-
-	if (zip_size) {
-		UNIV_MEM_ASSERT_RW(bpage->zip.data, zip_size);
-		/* Copy the compressed page and clear the rest. */
-		memcpy(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free,
-		       bpage->zip.data, zip_size);
-		memset(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free
-		       + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
-	} else {
-		ut_a(buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE);
-		UNIV_MEM_ASSERT_RW(((buf_block_t*) bpage)->frame,
-				   UNIV_PAGE_SIZE);
-
-		memcpy(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free,
-		       ((buf_block_t*) bpage)->frame, UNIV_PAGE_SIZE);
-	}
+	buf_dblwr_copy_page(buf_dblwr->write_buf
+			    + UNIV_PAGE_SIZE * buf_dblwr->first_free, bpage);
 
 	buf_dblwr->buf_block_arr[buf_dblwr->first_free] = bpage;
 
@@ -40,6 +40,7 @@ Created April 08, 2011 Vasil Dimov
 #include "sync0rw.h" /* rw_lock_s_lock() */
 #include "ut0byte.h" /* ut_ull_create() */
 #include "ut0sort.h" /* UT_SORT_FUNCTION_BODY */
+#include "ut0ut.h" /* ut_time() */
 
 enum status_severity {
 	STATUS_INFO,
@@ -57,8 +58,20 @@ static ibool	buf_load_should_start = FALSE;
 
 static ibool	buf_load_abort_flag = FALSE;
 
+/* The time of the last completed dump, and the buffer pool activity
+counter (see buf_dump_activity()) at that time. These are only accessed
+by the buffer pool dump/load thread. */
+static ib_time_t	buf_dump_last_time;
+static ulint		buf_dump_last_activity;
+
+/** Number of consecutive dump entries that are sorted on
+space_no,page_no and read together while loading. The dump is written
+hottest pages first, so a smaller batch restores the hottest pages
+earlier and a bigger one gives more sequential reads. */
+#define BUF_LOAD_BATCH		1024
+
 /* Used to temporary store dump info in order to avoid IO while holding
-buffer pool mutex during dump and also to sort the contents of the dump
+buffer pool mutex during dump and also to sort batches of the dump
 before reading the pages from disk during load.
 We store the space id in the high 32 bits and page no in low 32 bits. */
 typedef ib_uint64_t	buf_dump_t;
@@ -167,6 +180,29 @@ buf_load_status(
 	va_end(ap);
 }
 
+/*****************************************************************//**
+Returns a counter that changes when pages are read into the buffer pools
+or moved to the head of an LRU list. The counters are read without the
+buffer pool mutexes, because an approximate value is good enough for
+deciding whether the LRU lists have changed since the last dump.
+@return sum of the page read and made young counters */
+static
+ulint
+buf_dump_activity()
+/*===============*/
+{
+	ulint	activity = 0;
+
+	for (ulint i = 0; i < srv_buf_pool_instances; i++) {
+		const buf_pool_t*	buf_pool = buf_pool_from_array(i);
+
+		activity += buf_pool->stat.n_pages_read
+			+ buf_pool->stat.n_pages_made_young;
+	}
+
+	return(activity);
+}
+
 /*****************************************************************//**
 Perform a buffer pool dump into the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
@@ -177,17 +213,28 @@ static
 void
 buf_dump(
 /*=====*/
-	ibool	obey_shutdown)	/*!< in: quit if we are in a shutting down
+	ibool	obey_shutdown,	/*!< in: quit if we are in a shutting down
 				state */
+	bool	quiet)		/*!< in: whether to report the start and
+				completion of the dump only in
+				innodb_buffer_pool_dump_status, and not
+				in the error log */
 {
 #define SHOULD_QUIT()	(SHUTTING_DOWN() && obey_shutdown)
 
-	char	full_filename[OS_FILE_MAX_PATH];
-	char	tmp_filename[OS_FILE_MAX_PATH];
-	char	now[32];
-	FILE*	f;
-	ulint	i;
-	int	ret;
+	char			full_filename[OS_FILE_MAX_PATH];
+	char			tmp_filename[OS_FILE_MAX_PATH];
+	char			now[32];
+	FILE*			f;
+	buf_dump_t*		dumps[MAX_BUFFER_POOLS];
+	ulint			dump_n[MAX_BUFFER_POOLS];
+	ulint			max_n = 0;
+	ulint			total_n = 0;
+	ulint			activity;
+	ulint			i;
+	ulint			j;
+	int			ret;
+	enum status_severity	severity = quiet ? STATUS_INFO : STATUS_NOTICE;
 
 	ut_snprintf(full_filename, sizeof(full_filename),
 		    "%s%c%s", srv_data_home, SRV_PATH_SEPARATOR,
@@ -196,7 +243,7 @@ buf_dump(
 	ut_snprintf(tmp_filename, sizeof(tmp_filename),
 		    "%s.incomplete", full_filename);
 
-	buf_dump_status(STATUS_NOTICE, "Dumping buffer pool(s) to %s",
+	buf_dump_status(severity, "Dumping buffer pool(s) to %s",
 			full_filename);
 
 	f = fopen(tmp_filename, "w");
@@ -208,13 +255,18 @@ buf_dump(
 	}
 	/* else */
 
-	/* walk through each buffer pool */
+	activity = buf_dump_activity();
+
+	memset(dumps, 0, sizeof(dumps));
+	memset(dump_n, 0, sizeof(dump_n));
+
+	/* walk through each buffer pool and copy its LRU list,
+	most recently used pages first */
 	for (i = 0; i < srv_buf_pool_instances && !SHOULD_QUIT(); i++) {
 		buf_pool_t*		buf_pool;
 		const buf_page_t*	bpage;
 		buf_dump_t*		dump;
 		ulint			n_pages;
-		ulint			j;
 
 		buf_pool = buf_pool_from_array(i);
 
@@ -235,18 +287,17 @@ buf_dump(
 
 		if (dump == NULL) {
 			buf_pool_mutex_exit(buf_pool);
-			fclose(f);
 			buf_dump_status(STATUS_ERR,
 					"Cannot allocate " ULINTPF " bytes: %s",
 					(ulint) (n_pages * sizeof(*dump)),
 					strerror(errno));
 			/* leave tmp_filename to exist */
-			return;
+			goto err_exit;
 		}
 
-		for (bpage = UT_LIST_GET_LAST(buf_pool->LRU), j = 0;
+		for (bpage = UT_LIST_GET_FIRST(buf_pool->LRU), j = 0;
 		     bpage != NULL;
-		     bpage = UT_LIST_GET_PREV(LRU, bpage), j++) {
+		     bpage = UT_LIST_GET_NEXT(LRU, bpage), j++) {
 
 			ut_a(buf_page_in_file(bpage));
 
@@ -258,32 +309,48 @@ buf_dump(
 
 		buf_pool_mutex_exit(buf_pool);
 
-		for (j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
+		dumps[i] = dump;
+		dump_n[i] = n_pages;
+		total_n += n_pages;
+
+		if (n_pages > max_n) {
+			max_n = n_pages;
+		}
+	}
+
+	/* Interleave the LRU lists of the buffer pool instances, so that
+	the pages that are hottest in any instance come first in the file
+	and are restored first by buf_load(). */
+	for (j = 0; j < max_n && !SHOULD_QUIT(); j++) {
+		for (i = 0; i < srv_buf_pool_instances; i++) {
+
+			if (j >= dump_n[i]) {
+				continue;
+			}
+
 			ret = fprintf(f, ULINTPF "," ULINTPF "\n",
-				      BUF_DUMP_SPACE(dump[j]),
-				      BUF_DUMP_PAGE(dump[j]));
+				      BUF_DUMP_SPACE(dumps[i][j]),
+				      BUF_DUMP_PAGE(dumps[i][j]));
 			if (ret < 0) {
-				ut_free(dump);
-				fclose(f);
 				buf_dump_status(STATUS_ERR,
 						"Cannot write to '%s': %s",
 						tmp_filename, strerror(errno));
 				/* leave tmp_filename to exist */
-				return;
+				goto err_exit;
 			}
+		}
 
-			if (j % 128 == 0) {
-				buf_dump_status(
-					STATUS_INFO,
-					"Dumping buffer pool "
-					ULINTPF "/" ULINTPF ", "
-					"page " ULINTPF "/" ULINTPF,
-					i + 1, srv_buf_pool_instances,
-					j + 1, n_pages);
-			}
+		if (j % 128 == 0) {
+			buf_dump_status(
+				STATUS_INFO,
+				"Dumping buffer pool(s), "
+				"page " ULINTPF "/" ULINTPF,
+				j + 1, max_n);
 		}
+	}
 
-		ut_free(dump);
+	for (i = 0; i < srv_buf_pool_instances; i++) {
+		ut_free(dumps[i]);
 	}
 
 	ret = fclose(f);
@@ -318,10 +385,44 @@ buf_dump(
 
 	/* success */
 
+	buf_dump_last_time = ut_time();
+	buf_dump_last_activity = activity;
+
 	ut_sprintf_timestamp(now);
 
-	buf_dump_status(STATUS_NOTICE,
-			"Buffer pool(s) dump completed at %s", now);
+	buf_dump_status(severity,
+			"Buffer pool(s) dump completed at %s "
+			"(" ULINTPF " pages)", now, total_n);
+	return;
+
+err_exit:
+	for (i = 0; i < srv_buf_pool_instances; i++) {
+		ut_free(dumps[i]);
+	}
+
+	fclose(f);
+}
+
+/*****************************************************************//**
+Performs a periodic buffer pool dump if innodb_buffer_pool_dump_interval
+seconds have passed since the last dump and pages have been read into
+the buffer pools or made young since then. Otherwise the dump file is
+still up to date and is left alone. */
+static
+void
+buf_dump_periodic()
+/*===============*/
+{
+	ulint	interval = srv_buf_dump_interval;
+
+	if (interval == 0
+	    || ut_difftime(ut_time(), buf_dump_last_time) < interval
+	    || buf_dump_activity() == buf_dump_last_activity) {
+
+		return;
+	}
+
+	buf_dump(TRUE /* quit on shutdown */, true /* quiet */);
 }
 
 /*****************************************************************//**
@@ -346,7 +447,7 @@ buf_dump_cmp(
 }
 
 /*****************************************************************//**
-Sort a buffer pool dump on space_no, page_no. */
+Sort a part of a buffer pool dump on space_no, page_no. */
 static
 void
 buf_dump_sort(
@@ -427,8 +528,9 @@ buf_load()
 	}
 
 	/* If dump is larger than the buffer pool(s), then we ignore the
-	extra trailing. This could happen if a dump is made, then buffer
-	pool is shrunk and then load it attempted. */
+	extra trailing, which holds the coldest pages. This could happen if
+	a dump is made, then buffer pool is shrunk and then load it
+	attempted. */
 	total_buffer_pools_pages = buf_pool_get_n_pages()
 		* srv_buf_pool_instances;
 	if (dump_n > total_buffer_pools_pages) {
@@ -515,14 +617,27 @@ buf_load()
 		return;
 	}
 
-	if (!SHUTTING_DOWN()) {
-		buf_dump_sort(dump, dump_tmp, 0, dump_n);
+	/* The dump lists the hottest pages first. Sort it in batches,
+	so that the hottest pages are read first, and the reads within
+	a batch are as sequential as possible. */
+	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i += BUF_LOAD_BATCH) {
+		buf_dump_sort(dump, dump_tmp, i,
+			      ut_min(i + BUF_LOAD_BATCH, dump_n));
 	}
 
 	ut_free(dump_tmp);
 
 	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
 
+		/* Let the reads of user threads go first: they are
+		waiting for their pages, while the load is not. */
+		while (buf_get_n_pending_read_ios() > srv_io_capacity
+		       && !SHUTTING_DOWN() && !buf_load_abort_flag) {
+
+			os_aio_simulated_wake_handler_threads();
+			os_thread_sleep(10000);
+		}
+
 		buf_read_page_async(BUF_DUMP_SPACE(dump[i]),
 				    BUF_DUMP_PAGE(dump[i]));
 
@@ -569,7 +684,8 @@ buf_load_abort()
 /*****************************************************************//**
 This is the main thread for buffer pool dump/load. It waits for an
 event and when waked up either performs a dump or load and sleeps
-again.
+again. If innodb_buffer_pool_dump_interval is set, it also wakes up
+periodically to refresh the dump.
 @return this function does not return, it calls os_thread_exit() */
 extern "C" UNIV_INTERN
 os_thread_ret_t
@@ -589,13 +705,31 @@ DECLARE_THREAD(buf_dump_thread)(
 		buf_load();
 	}
 
+	/* Do not overwrite the dump that was just loaded before the
+	first interval has passed. */
+	buf_dump_last_time = ut_time();
+	buf_dump_last_activity = buf_dump_activity();
+
 	while (!SHUTTING_DOWN()) {
+		ib_int64_t	sig_count = os_event_reset(srv_buf_dump_event);
+
+		if (buf_dump_should_start || buf_load_should_start) {
+			/* Requested while we were busy */
+		} else if (srv_buf_dump_interval == 0) {
+			os_event_wait_low(srv_buf_dump_event, sig_count);
+		} else {
+			os_event_wait_time_low(srv_buf_dump_event,
+					       srv_buf_dump_interval * 1000000,
+					       sig_count);
+		}
 
-		os_event_wait(srv_buf_dump_event);
+		if (SHUTTING_DOWN()) {
+			break;
+		}
 
 		if (buf_dump_should_start) {
 			buf_dump_should_start = FALSE;
-			buf_dump(TRUE /* quit on shutdown */);
+			buf_dump(TRUE /* quit on shutdown */, false);
 		}
 
 		if (buf_load_should_start) {
@@ -603,12 +737,12 @@ DECLARE_THREAD(buf_dump_thread)(
 			buf_load();
 		}
 
-		os_event_reset(srv_buf_dump_event);
+		buf_dump_periodic();
 	}
 
 	if (srv_buffer_pool_dump_at_shutdown && srv_fast_shutdown != 2) {
 		buf_dump(FALSE /* ignore shutdown down flag,
-		keep going even if we are in a shutdown state */);
+		keep going even if we are in a shutdown state */, false);
 	}
 
 	srv_buf_dump_thread_active = FALSE;
@@ -955,7 +955,14 @@ buf_flush_write_block_low(
 		break;
 	}
 
-	if (!srv_use_doublewrite_buf || !buf_dblwr) {
+	/* Pages of temporary tables are not needed after a crash,
+	so a torn write of them does not matter. The decision is
+	recorded for buf_dblwr_update(), because the tablespace may be
+	dropped before the write completes. */
+	bpage->dblwr_bypassed = !srv_use_doublewrite_buf || !buf_dblwr
+		|| fil_space_is_temporary(buf_page_get_space(bpage));
+
+	if (bpage->dblwr_bypassed) {
 		fil_io(OS_FILE_WRITE | OS_AIO_SIMULATED_WAKE_LATER,
 		       sync, buf_page_get_space(bpage), zip_size,
 		       buf_page_get_page_no(bpage), 0,
@@ -1729,10 +1736,11 @@ static
 void
 buf_flush_common(
 /*=============*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
 	buf_flush_t	flush_type,	/*!< in: type of flush */
 	ulint		page_count)	/*!< in: number of pages flushed */
 {
-	buf_dblwr_flush_buffered_writes();
+	buf_dblwr_flush_batch(buf_pool, flush_type);
 
 	ut_a(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
 
@@ -1867,7 +1875,7 @@ buf_flush_LRU(
 
 	buf_flush_end(buf_pool, BUF_FLUSH_LRU);
 
-	buf_flush_common(BUF_FLUSH_LRU, page_count);
+	buf_flush_common(buf_pool, BUF_FLUSH_LRU, page_count);
 
 	if (n_processed) {
 		*n_processed = page_count;
@@ -1944,7 +1952,7 @@ buf_flush_list(
 
 		buf_flush_end(buf_pool, BUF_FLUSH_LIST);
 
-		buf_flush_common(BUF_FLUSH_LIST, page_count);
+		buf_flush_common(buf_pool, BUF_FLUSH_LIST, page_count);
 
 		if (n_processed) {
 			*n_processed += page_count;
@@ -1110,7 +1110,7 @@ buf_LRU_get_free_only(
 
 	block = (buf_block_t*) UT_LIST_GET_FIRST(buf_pool->free);
 
-	if (block) {
+	while (block != NULL) {
 
 		ut_ad(block->page.in_free_list);
 		ut_d(block->page.in_free_list = FALSE);
@@ -1119,6 +1119,17 @@ buf_LRU_get_free_only(
 		ut_a(!buf_page_in_file(&block->page));
 		UT_LIST_REMOVE(list, buf_pool->free, (&block->page));
 
+		if (UNIV_UNLIKELY(buf_pool->withdraw_target > 0)
+		    && buf_block_will_be_withdrawn(buf_pool, block)) {
+			/* The chunk of this block is being withdrawn
+			by buf_pool_resize(). */
+			UT_LIST_ADD_LAST(list, buf_pool->withdraw,
+					 (&block->page));
+			block = (buf_block_t*) UT_LIST_GET_FIRST(
+				buf_pool->free);
+			continue;
+		}
+
 		mutex_enter(&block->mutex);
 
 		buf_block_set_state(block, BUF_BLOCK_READY_FOR_USE);
@@ -1127,6 +1138,7 @@ buf_LRU_get_free_only(
 		ut_ad(buf_pool_from_block(block) == buf_pool);
 
 		mutex_exit(&block->mutex);
+		break;
 	}
 
 	return(block);
@@ -1908,6 +1920,10 @@ func_exit:
 	if (b) {
 		buf_page_t*	prev_b	= UT_LIST_GET_PREV(LRU, b);
 
+		/* buf_LRU_block_remove_hashed() may have released
+		buf_pool->mutex, and the page_hash may have been
+		resized meanwhile. */
+		hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 		rw_lock_x_lock(hash_lock);
 		mutex_enter(block_mutex);
 
@@ -2130,8 +2146,15 @@ buf_LRU_block_free_non_file_page(
 		page_zip_set_size(&block->page.zip, 0);
 	}
 
-	UT_LIST_ADD_FIRST(list, buf_pool->free, (&block->page));
-	ut_d(block->page.in_free_list = TRUE);
+	if (UNIV_UNLIKELY(buf_pool->withdraw_target > 0)
+	    && buf_block_will_be_withdrawn(buf_pool, block)) {
+		/* buf_pool_resize() is about to free the chunk of
+		this block. Do not hand the block out again. */
+		UT_LIST_ADD_LAST(list, buf_pool->withdraw, (&block->page));
+	} else {
+		UT_LIST_ADD_FIRST(list, buf_pool->free, (&block->page));
+		ut_d(block->page.in_free_list = TRUE);
+	}
 
 	UNIV_MEM_ASSERT_AND_FREE(block->frame, UNIV_PAGE_SIZE);
 }
@@ -2329,6 +2352,7 @@ buf_LRU_block_remove_hashed(
 			rw_lock_x_unlock(hash_lock);
  			fc_LRU_move(bpage);
  			buf_pool_mutex_enter(buf_pool);
+			hash_lock = buf_page_hash_lock_get(buf_pool, fold);
 			rw_lock_x_lock(hash_lock);
  		}
 
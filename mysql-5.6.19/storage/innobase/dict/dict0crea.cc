@@ -1796,6 +1796,114 @@ dict_create_or_check_sys_tablespace(void)
 	return(err);
 }
 
+/****************************************************************//**
+Creates the SYS_COLUMN_DEFAULTS system table, which holds the default
+values of the columns that were added by instant ADD COLUMN, at server
+bootstrap or server start if it is not found or is not of the right form.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+dict_create_or_check_sys_column_defaults(void)
+/*==========================================*/
+{
+	trx_t*		trx;
+	my_bool		srv_file_per_table_backup;
+	dberr_t		err;
+	dberr_t		sys_column_defaults_err;
+
+	ut_a(srv_get_active_thread_type() == SRV_NONE);
+
+	/* Note: The master thread has not been started at this point. */
+
+	sys_column_defaults_err = dict_check_if_system_table_exists(
+		"SYS_COLUMN_DEFAULTS",
+		DICT_NUM_FIELDS__SYS_COLUMN_DEFAULTS + 1, 1);
+
+	if (sys_column_defaults_err == DB_SUCCESS) {
+		return(DB_SUCCESS);
+	}
+
+	if (srv_read_only_mode || srv_force_recovery) {
+		/* Instant ADD COLUMN will not be available. */
+		return(DB_SUCCESS);
+	}
+
+	trx = trx_allocate_for_mysql();
+
+	trx_set_dict_operation(trx, TRX_DICT_OP_TABLE);
+
+	trx->op_info = "creating column defaults sys table";
+
+	row_mysql_lock_data_dictionary(trx);
+
+	if (sys_column_defaults_err == DB_CORRUPTION) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Dropping incompletely created "
+			"SYS_COLUMN_DEFAULTS table.");
+		row_drop_table_for_mysql("SYS_COLUMN_DEFAULTS", trx, TRUE);
+	}
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Creating column defaults system table.");
+
+	/* We always want SYSTEM tables to be created inside the system
+	tablespace. */
+	srv_file_per_table_backup = srv_file_per_table;
+	srv_file_per_table = 0;
+
+	err = que_eval_sql(
+		NULL,
+		"PROCEDURE CREATE_SYS_COLUMN_DEFAULTS_PROC () IS\n"
+		"BEGIN\n"
+		"CREATE TABLE SYS_COLUMN_DEFAULTS(\n"
+		" TABLE_ID BINARY(8), POS INT,"
+		" DEFAULT_VALUE BLOB);\n"
+		"CREATE UNIQUE CLUSTERED INDEX SYS_COLUMN_DEFAULTS_ID"
+		" ON SYS_COLUMN_DEFAULTS (TABLE_ID, POS);\n"
+		"END;\n",
+		FALSE, trx);
+
+	if (err != DB_SUCCESS) {
+		ib_logf(IB_LOG_LEVEL_ERROR,
+			"Creation of SYS_COLUMN_DEFAULTS "
+			"has failed with error %lu.  Tablespace is full. "
+			"Dropping incompletely created tables.",
+			(ulong) err);
+
+		ut_a(err == DB_OUT_OF_FILE_SPACE
+		     || err == DB_TOO_MANY_CONCURRENT_TRXS);
+
+		row_drop_table_for_mysql("SYS_COLUMN_DEFAULTS", trx, TRUE);
+
+		if (err == DB_OUT_OF_FILE_SPACE) {
+			err = DB_MUST_GET_MORE_FILE_SPACE;
+		}
+	}
+
+	trx_commit_for_mysql(trx);
+
+	row_mysql_unlock_data_dictionary(trx);
+
+	trx_free_for_mysql(trx);
+
+	srv_file_per_table = srv_file_per_table_backup;
+
+	if (err == DB_SUCCESS) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Column defaults system table created.");
+	}
+
+	/* Note: The master thread has not been started at this point. */
+	/* Confirm and move to the non-LRU part of the table LRU list. */
+
+	sys_column_defaults_err = dict_check_if_system_table_exists(
+		"SYS_COLUMN_DEFAULTS",
+		DICT_NUM_FIELDS__SYS_COLUMN_DEFAULTS + 1, 1);
+	ut_a(sys_column_defaults_err == DB_SUCCESS);
+
+	return(err);
+}
+
 /********************************************************************//**
 Add a single tablespace definition to the data dictionary tables in the
 database.
@@ -2233,6 +2233,13 @@ dict_index_too_big_for_tree(
 		/* Include the "null" flags in the
 		maximum possible record size. */
 		rec_max_size += UT_BITS_IN_BYTES(new_index->n_nullable);
+
+		if (dict_index_is_clust(new_index)
+		    && dict_index_is_instant(new_index)) {
+			/* The number of fields is stored in
+			1 or 2 bytes. */
+			rec_max_size += 2;
+		}
 	} else {
 		/* For each column, include a 2-byte offset and a
 		"null" flag.  The 1-byte format is only used in short
@@ -2707,6 +2714,227 @@ dict_index_add_col(
 }
 
 #ifndef UNIV_HOTBACKUP
+/*******************************************************************//**
+Determines if the records of the clustered index of a table could
+become too big for a B-tree page if columns were added to the table
+by instant ADD COLUMN.
+@return	true if the index records could become too big */
+UNIV_INTERN
+bool
+dict_table_instant_too_big(
+/*=======================*/
+	const dict_table_t*	table,	/*!< in: table */
+	ulint			n_add,	/*!< in: number of columns to add */
+	const dict_col_t*	cols)	/*!< in: columns to add */
+{
+	const dict_index_t*	clust_index
+		= dict_table_get_first_index(table);
+	dict_index_t*		index;
+	bool			too_big;
+
+	/* Build a scratch copy of the clustered index definition
+	that includes the added columns. */
+	index = dict_mem_index_create(
+		table->name, clust_index->name, table->space,
+		clust_index->type, clust_index->n_fields + n_add);
+
+	memcpy(index->fields, clust_index->fields,
+	       clust_index->n_fields * sizeof *index->fields);
+
+	index->n_def = index->n_fields = clust_index->n_fields + n_add;
+	index->n_nullable = clust_index->n_nullable;
+	index->n_instant_fields = clust_index->n_instant_fields + n_add;
+
+	for (ulint i = 0; i < n_add; i++) {
+		dict_field_t*	field = dict_index_get_nth_field(
+			index, clust_index->n_fields + i);
+
+		field->col = const_cast<dict_col_t*>(&cols[i]);
+		field->name = "";
+		field->prefix_len = 0;
+		field->fixed_len = (unsigned int) dict_col_get_fixed_size(
+			&cols[i], dict_table_is_comp(table));
+
+		if (field->fixed_len > DICT_MAX_FIXED_COL_LEN) {
+			field->fixed_len = 0;
+		}
+
+		if (!(cols[i].prtype & DATA_NOT_NULL)) {
+			index->n_nullable++;
+		}
+	}
+
+	too_big = dict_index_too_big_for_tree(table, index);
+
+	dict_mem_index_free(index);
+
+	return(too_big);
+}
+
+/*******************************************************************//**
+Adds columns to a table in the dictionary cache by instant ADD COLUMN.
+The columns are added after the existing user columns, and they are
+appended to the fields of the clustered index. The records of the
+clustered index are not modified; the records that lack the added
+fields take the default values of the columns. */
+UNIV_INTERN
+void
+dict_table_instant_add_cols(
+/*========================*/
+	dict_table_t*		table,	/*!< in/out: table */
+	ulint			n_add,	/*!< in: number of columns to add */
+	const dict_col_t*	cols,	/*!< in: columns to add, with
+					def_val and def_val_len */
+	const char* const*	names)	/*!< in: names of the columns */
+{
+	dict_index_t*	clust_index = dict_table_get_first_index(table);
+	dict_col_t*	old_cols = table->cols;
+	const char*	old_names = table->col_names;
+	ulint		n_old = table->n_cols;
+	ulint		n_user = n_old - DATA_N_SYS_COLS;
+	dict_col_t*	new_cols;
+	char*		new_names;
+	const char*	s;
+	ulint		user_names_len;
+	ulint		sys_names_len;
+	ulint		add_names_len = 0;
+	dict_field_t*	fields;
+
+	ut_ad(mutex_own(&dict_sys->mutex));
+	ut_ad(table->n_def == table->n_cols);
+	ut_ad(n_add > 0);
+	ut_ad(dict_index_is_clust(clust_index));
+	ut_ad(dict_table_is_comp(table));
+	ut_ad(!dict_table_zip_size(table));
+
+	/* Copy the columns, placing the added ones between the
+	user columns and the system columns. */
+	new_cols = static_cast<dict_col_t*>(
+		mem_heap_alloc(table->heap,
+			       (n_old + n_add) * sizeof *new_cols));
+
+	memcpy(new_cols, old_cols, n_user * sizeof *new_cols);
+
+	for (ulint i = 0; i < n_add; i++) {
+		dict_col_t*	col = &new_cols[n_user + i];
+
+		*col = cols[i];
+		col->ind = (unsigned int) (n_user + i);
+		col->ord_part = 0;
+		col->max_prefix = 0;
+
+		if (col->def_val_len != UNIV_SQL_NULL) {
+			col->def_val = static_cast<const byte*>(
+				mem_heap_dup(table->heap, cols[i].def_val,
+					     cols[i].def_val_len));
+		}
+
+		add_names_len += strlen(names[i]) + 1;
+	}
+
+	memcpy(new_cols + n_user + n_add, old_cols + n_user,
+	       DATA_N_SYS_COLS * sizeof *new_cols);
+
+	for (ulint i = n_user + n_add; i < n_old + n_add; i++) {
+		new_cols[i].ind = (unsigned int) i;
+	}
+
+	/* Copy the column names in the same order. */
+	s = old_names;
+
+	for (ulint i = 0; i < n_user; i++) {
+		s += strlen(s) + 1;
+	}
+
+	user_names_len = s - old_names;
+
+	for (ulint i = n_user; i < n_old; i++) {
+		s += strlen(s) + 1;
+	}
+
+	sys_names_len = (s - old_names) - user_names_len;
+
+	new_names = static_cast<char*>(
+		mem_heap_alloc(table->heap,
+			       user_names_len + add_names_len
+			       + sys_names_len));
+
+	memcpy(new_names, old_names, user_names_len);
+
+	char*	p = new_names + user_names_len;
+
+	for (ulint i = 0; i < n_add; i++) {
+		ulint	len = strlen(names[i]) + 1;
+
+		memcpy(p, names[i], len);
+		p += len;
+	}
+
+	memcpy(p, old_names + user_names_len, sys_names_len);
+
+	table->cols = new_cols;
+	table->col_names = new_names;
+	table->n_cols = table->n_def = (unsigned int) (n_old + n_add);
+
+	/* Repoint the fields of every index to the new columns. */
+	for (dict_index_t* index = clust_index;
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
+
+		for (ulint i = 0; i < index->n_def; i++) {
+			dict_field_t*	field = &index->fields[i];
+			ulint		col_no = field->col - old_cols;
+
+			ut_ad(col_no < n_old);
+
+			if (col_no >= n_user) {
+				col_no += n_add;
+			}
+
+			field->col = &new_cols[col_no];
+			field->name = dict_table_get_col_name(table, col_no);
+		}
+	}
+
+	/* Append the added columns to the clustered index. */
+	fields = static_cast<dict_field_t*>(
+		mem_heap_alloc(clust_index->heap,
+			       (clust_index->n_fields + n_add)
+			       * sizeof *fields));
+
+	memcpy(fields, clust_index->fields,
+	       clust_index->n_fields * sizeof *fields);
+
+	clust_index->fields = fields;
+
+	for (ulint i = 0; i < n_add; i++) {
+		dict_col_t*	col = &new_cols[n_user + i];
+
+		dict_index_add_col(clust_index, table, col, 0);
+
+		if (!(col->prtype & DATA_NOT_NULL)) {
+			clust_index->n_instant_nullable++;
+		}
+	}
+
+	clust_index->n_fields = clust_index->n_def;
+	clust_index->n_instant_fields += (unsigned int) n_add;
+
+	/* Replace the column names in the foreign key constraints,
+	which point to table->col_names. */
+	for (dict_foreign_t* foreign = UT_LIST_GET_FIRST(table->foreign_list);
+	     foreign != NULL;
+	     foreign = UT_LIST_GET_NEXT(foreign_list, foreign)) {
+		for (unsigned f = 0; f < foreign->n_fields; f++) {
+			foreign->foreign_col_names[f]
+				= dict_index_get_nth_field(
+					foreign->foreign_index, f)->name;
+		}
+	}
+
+	DICT_TF2_FLAG_SET(table, DICT_TF2_INSTANT);
+}
+
 /*******************************************************************//**
 Copies fields contained in index2 to index1. */
 static
@@ -1778,6 +1778,157 @@ err_len:
 	return(NULL);
 }
 
+/********************************************************************//**
+Loads the default values of the columns that were added to a table by
+instant ADD COLUMN, and marks the trailing fields of the clustered index
+as instantly added.
+@return DB_SUCCESS, or DB_CORRUPTION if the defaults do not match the
+table definition */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+dict_load_column_defaults(
+/*======================*/
+	dict_table_t*	table,	/*!< in/out: table */
+	mem_heap_t*	heap)	/*!< in/out: memory heap
+				for temporary storage */
+{
+	dict_table_t*	sys_column_defaults;
+	dict_index_t*	sys_index;
+	dict_index_t*	clust_index;
+	btr_pcur_t	pcur;
+	dtuple_t*	tuple;
+	dfield_t*	dfield;
+	byte*		buf;
+	ulint		n_instant	= 0;
+	ulint		n_user_cols;
+	dberr_t		err		= DB_SUCCESS;
+	mtr_t		mtr;
+
+	ut_ad(mutex_own(&(dict_sys->mutex)));
+	ut_ad(DICT_TF2_FLAG_IS_SET(table, DICT_TF2_INSTANT));
+
+	sys_column_defaults = dict_table_get_low("SYS_COLUMN_DEFAULTS");
+	clust_index = dict_table_get_first_index(table);
+
+	if (sys_column_defaults == NULL || clust_index == NULL) {
+		return(DB_CORRUPTION);
+	}
+
+	sys_index = UT_LIST_GET_FIRST(sys_column_defaults->indexes);
+	ut_ad(!dict_table_is_comp(sys_column_defaults));
+	ut_ad(name_of_col_is(sys_column_defaults, sys_index,
+			     DICT_FLD__SYS_COLUMN_DEFAULTS__POS, "POS"));
+	ut_ad(name_of_col_is(sys_column_defaults, sys_index,
+			     DICT_FLD__SYS_COLUMN_DEFAULTS__DEFAULT_VALUE,
+			     "DEFAULT_VALUE"));
+
+	n_user_cols = table->n_cols - DATA_N_SYS_COLS;
+
+	mtr_start(&mtr);
+
+	tuple = dtuple_create(heap, 1);
+	dfield = dtuple_get_nth_field(tuple, 0);
+
+	buf = static_cast<byte*>(mem_heap_alloc(heap, 8));
+	mach_write_to_8(buf, table->id);
+
+	dfield_set_data(dfield, buf, 8);
+	dict_index_copy_types(tuple, sys_index, 1);
+
+	btr_pcur_open_on_user_rec(sys_index, tuple, PAGE_CUR_GE,
+				  BTR_SEARCH_LEAF, &pcur, &mtr);
+
+	for (; btr_pcur_is_on_user_rec(&pcur);
+	     btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+		const rec_t*	rec = btr_pcur_get_rec(&pcur);
+		const byte*	field;
+		ulint		len;
+		ulint		pos;
+		dict_col_t*	col;
+
+		field = rec_get_nth_field_old(
+			rec, DICT_FLD__SYS_COLUMN_DEFAULTS__TABLE_ID, &len);
+
+		if (len != 8 || mach_read_from_8(field) != table->id) {
+			break;
+		}
+
+		if (rec_get_deleted_flag(rec, 0)) {
+			continue;
+		}
+
+		if (rec_get_n_fields_old(rec)
+		    != DICT_NUM_FIELDS__SYS_COLUMN_DEFAULTS) {
+			err = DB_CORRUPTION;
+			break;
+		}
+
+		field = rec_get_nth_field_old(
+			rec, DICT_FLD__SYS_COLUMN_DEFAULTS__POS, &len);
+
+		if (len != 4) {
+			err = DB_CORRUPTION;
+			break;
+		}
+
+		pos = mach_read_from_4(field);
+
+		if (pos >= n_user_cols) {
+			err = DB_CORRUPTION;
+			break;
+		}
+
+		col = dict_table_get_nth_col(table, pos);
+
+		field = rec_get_nth_field_old(
+			rec, DICT_FLD__SYS_COLUMN_DEFAULTS__DEFAULT_VALUE,
+			&len);
+
+		col->def_val_len = len;
+		col->def_val = len == UNIV_SQL_NULL
+			? NULL
+			: static_cast<const byte*>(
+				mem_heap_dup(table->heap, field, len));
+
+		n_instant++;
+	}
+
+	btr_pcur_close(&pcur);
+	mtr_commit(&mtr);
+
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
+	/* The instantly added columns are the last user columns,
+	and they are the last fields of the clustered index. */
+	if (n_instant == 0 || n_instant >= n_user_cols
+	    || n_instant >= dict_index_get_n_fields(clust_index)) {
+		return(DB_CORRUPTION);
+	}
+
+	clust_index->n_instant_fields = 0;
+	clust_index->n_instant_nullable = 0;
+
+	for (ulint i = dict_index_get_n_fields(clust_index) - n_instant;
+	     i < dict_index_get_n_fields(clust_index); i++) {
+		const dict_col_t*	col
+			= dict_index_get_nth_col(clust_index, i);
+
+		if (dict_col_get_no(col) < n_user_cols - n_instant) {
+			return(DB_CORRUPTION);
+		}
+
+		if (!(col->prtype & DATA_NOT_NULL)) {
+			clust_index->n_instant_nullable++;
+		}
+	}
+
+	clust_index->n_instant_fields = n_instant;
+
+	return(DB_SUCCESS);
+}
+
 /********************************************************************//**
 Loads definitions for table indexes. Adds them to the data dictionary
 cache.
@@ -2420,6 +2571,11 @@ err_exit:
 		}
 	}
 
+	if (DICT_TF2_FLAG_IS_SET(table, DICT_TF2_PAGE_COMPRESSED)
+	    && !table->ibd_file_missing) {
+		fil_space_set_page_compressed(table->space);
+	}
+
 	dict_load_columns(table, heap);
 
 	if (cached) {
@@ -2466,6 +2622,18 @@ err_exit:
 		}
 	}
 
+	if (err == DB_SUCCESS
+	    && DICT_TF2_FLAG_IS_SET(table, DICT_TF2_INSTANT)) {
+		err = dict_load_column_defaults(table, heap);
+
+		if (err != DB_SUCCESS) {
+			ib_logf(IB_LOG_LEVEL_ERROR,
+				"Cannot load the default values of the "
+				"instantly added columns of table '%s' "
+				"from SYS_COLUMN_DEFAULTS.", table->name);
+		}
+	}
+
 	/* Initialize table foreign_child value. Its value could be
 	changed when dict_load_foreigns() is called below */
 	table->fk_max_recusive_level = 0;
@@ -424,6 +424,8 @@ dict_mem_fill_column_struct(
 	column->ind = (unsigned int) col_pos;
 	column->ord_part = 0;
 	column->max_prefix = 0;
+	column->def_val = NULL;
+	column->def_val_len = UNIV_SQL_NULL;
 	column->mtype = (unsigned int) mtype;
 	column->prtype = (unsigned int) prtype;
 	column->len = (unsigned int) col_len;
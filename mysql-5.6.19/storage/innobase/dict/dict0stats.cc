@@ -32,6 +32,7 @@ Created Jan 06, 2010 Vasil Dimov
 #include "dict0dict.h" /* dict_table_get_first_index(), dict_fs2utf8() */
 #include "dict0mem.h" /* DICT_TABLE_MAGIC_N */
 #include "dict0stats.h"
+#include "dict0stats_bg.h" /* dict_stats_pool_run() */
 #include "data0type.h" /* dtype_t */
 #include "db0err.h" /* dberr_t */
 #include "page0page.h" /* page_align() */
@@ -2172,10 +2173,53 @@ found_level:
 	DBUG_VOID_RETURN;
 }
 
+/** Indexes of a table that are analyzed by several threads */
+struct dict_stats_analyze_t {
+	os_ib_mutex_t		mutex;		/*!< protects next */
+	const dict_table_t*	table;		/*!< table of the indexes */
+	std::vector<dict_index_t*>
+				indexes;	/*!< indexes to analyze; the
+						clustered index is first */
+	ulint			next;		/*!< next index to analyze */
+};
+
+/*********************************************************************//**
+Claims indexes to analyze until none are left. The secondary indexes are
+skipped if the background stats thread has been asked to stop using the
+table. Run by dict_stats_pool_run(). */
+static
+void
+dict_stats_analyze_indexes(
+/*=======================*/
+	void*	arg)	/*!< in/out: dict_stats_analyze_t* */
+{
+	dict_stats_analyze_t*	analyze
+		= static_cast<dict_stats_analyze_t*>(arg);
+
+	for (;;) {
+		ulint	i;
+
+		os_mutex_enter(analyze->mutex);
+		i = analyze->next++;
+		os_mutex_exit(analyze->mutex);
+
+		if (i >= analyze->indexes.size()) {
+			break;
+		}
+
+		if (i == 0
+		    || !(analyze->table->stats_bg_flag
+			 & BG_STAT_SHOULD_QUIT)) {
+			dict_stats_analyze_index(analyze->indexes[i]);
+		}
+	}
+}
+
 /*********************************************************************//**
 Calculates new estimates for table and index statistics. This function
 is relatively slow and is used to calculate persistent statistics that
-will be saved on disk.
+will be saved on disk. The indexes are analyzed by up to
+srv_stats_threads threads.
 @return DB_SUCCESS or error code */
 static
 dberr_t
@@ -2183,7 +2227,8 @@ dict_stats_update_persistent(
 /*=========================*/
 	dict_table_t*	table)		/*!< in/out: table */
 {
-	dict_index_t*	index;
+	dict_index_t*		index;
+	dict_stats_analyze_t	analyze;
 
 	DEBUG_PRINTF("%s(table=%s)\n", __func__, table->name);
 
@@ -2206,18 +2251,12 @@ dict_stats_update_persistent(
 
 	ut_ad(!dict_index_is_univ(index));
 
-	dict_stats_analyze_index(index);
-
-	ulint	n_unique = dict_index_get_n_unique(index);
-
-	table->stat_n_rows = index->stat_n_diff_key_vals[n_unique - 1];
-
-	table->stat_clustered_index_size = index->stat_index_size;
+	analyze.table = table;
+	analyze.next = 0;
+	analyze.indexes.push_back(index);
 
 	/* analyze other indexes from the table, if any */
 
-	table->stat_sum_of_other_index_sizes = 0;
-
 	for (index = dict_table_get_next_index(index);
 	     index != NULL;
 	     index = dict_table_get_next_index(index)) {
@@ -2230,16 +2269,38 @@ dict_stats_update_persistent(
 
 		dict_stats_empty_index(index);
 
-		if (dict_stats_should_ignore_index(index)) {
-			continue;
+		if (!dict_stats_should_ignore_index(index)) {
+			analyze.indexes.push_back(index);
 		}
+	}
 
-		if (!(table->stats_bg_flag & BG_STAT_SHOULD_QUIT)) {
-			dict_stats_analyze_index(index);
-		}
+	analyze.mutex = os_mutex_create();
+
+	/* The calling thread analyzes indexes too. */
+	dict_stats_pool_run(
+		dict_stats_analyze_indexes, &analyze,
+		ut_min(srv_stats_threads, analyze.indexes.size()) - 1);
+
+	os_mutex_free(analyze.mutex);
+
+	index = dict_table_get_first_index(table);
+
+	ulint	n_unique = dict_index_get_n_unique(index);
+
+	table->stat_n_rows = index->stat_n_diff_key_vals[n_unique - 1];
+
+	table->stat_clustered_index_size = index->stat_index_size;
+
+	table->stat_sum_of_other_index_sizes = 0;
+
+	for (index = dict_table_get_next_index(index);
+	     index != NULL;
+	     index = dict_table_get_next_index(index)) {
 
-		table->stat_sum_of_other_index_sizes
-			+= index->stat_index_size;
+		if (!(index->type & DICT_FTS)) {
+			table->stat_sum_of_other_index_sizes
+				+= index->stat_index_size;
+		}
 	}
 
 	table->stats_last_recalc = ut_time();
@@ -2401,6 +2462,13 @@ dict_stats_save(
 	pars_info_add_ull_literal(pinfo, "sum_of_other_index_sizes",
 		table->stat_sum_of_other_index_sizes);
 
+	/* The table and index statistics are saved in one transaction.
+	The rows of innodb_table_stats are always locked before those of
+	innodb_index_stats, and all writers hold dict_operation_lock. */
+
+	trx_t*	trx = trx_allocate_for_background();
+	trx_start_if_not_started(trx);
+
 	ret = dict_stats_exec_sql(
 		pinfo,
 		"PROCEDURE TABLE_STATS_SAVE () IS\n"
@@ -2421,7 +2489,7 @@ dict_stats_save(
 		":clustered_index_size,\n"
 		":sum_of_other_index_sizes\n"
 		");\n"
-		"END;", NULL);
+		"END;", trx);
 
 	if (ret != DB_SUCCESS) {
 		char	buf[MAX_FULL_NAME_LEN];
@@ -2432,6 +2500,8 @@ dict_stats_save(
 			ut_format_name(table->name, TRUE, buf, sizeof(buf)),
 			ut_strerr(ret));
 
+		trx_free_for_background(trx);
+
 		mutex_exit(&dict_sys->mutex);
 		rw_lock_x_unlock(&dict_operation_lock);
 
@@ -2440,13 +2510,10 @@ dict_stats_save(
 		return(ret);
 	}
 
-	trx_t*	trx = trx_allocate_for_background();
-	trx_start_if_not_started(trx);
-
 	dict_index_t*	index;
 	index_map_t	indexes;
 
-	/* Below we do all the modifications in innodb_index_stats in a single
+	/* Below we do all the modifications in innodb_index_stats in the same
 	transaction for performance reasons. Modifying more than one row in a
 	single transaction may deadlock with other transactions if they
 	lock the rows in different order. Other transaction could be for
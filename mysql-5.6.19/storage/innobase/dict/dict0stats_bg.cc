@@ -32,6 +32,7 @@ Created Apr 25, 2012 Vasil Dimov
 # include "dict0stats_bg.ic"
 #endif
 
+#include <list>
 #include <vector>
 
 /** Minimum time interval between stats recalc for a given table */
@@ -59,6 +60,44 @@ static recalc_pool_t		recalc_pool;
 
 typedef recalc_pool_t::iterator	recalc_pool_iterator_t;
 
+#ifdef UNIV_PFS_THREAD
+UNIV_INTERN mysql_pfs_key_t	dict_stats_worker_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
+/** A call of dict_stats_pool_run() that worker threads may join */
+struct dict_stats_task_t {
+	void		(*func)(void*);	/*!< function to run */
+	void*		arg;		/*!< argument of func */
+	ulint		n_wanted;	/*!< number of workers that may
+					still join */
+	ulint		n_active;	/*!< number of workers running
+					func */
+	os_event_t	done;		/*!< set when n_active drops
+					to 0 */
+};
+
+/** The tasks that workers may still join, oldest first */
+typedef std::list<dict_stats_task_t*>	dict_stats_task_list_t;
+
+/** Pool of worker threads shared by the background stats thread and
+ANALYZE TABLE; see dict_stats_pool_run() */
+static struct {
+	os_ib_mutex_t		mutex;		/*!< protects the fields
+						and the tasks; NULL if
+						the pool is not in use */
+	os_event_t		event;		/*!< set when a task is
+						added or at shutdown */
+	dict_stats_task_list_t*	tasks;		/*!< tasks to join */
+	ulint			n_workers;	/*!< number of worker
+						threads */
+	bool			exiting;	/*!< true when the workers
+						must exit */
+} dict_stats_pool;
+
+/** Maximum number of threads in dict_stats_pool, one less than the
+maximum of innodb_stats_threads */
+static const ulint	DICT_STATS_POOL_MAX = 63;
+
 /*****************************************************************//**
 Initialize the recalc pool, called once during thread initialization. */
 static
@@ -228,6 +267,12 @@ dict_stats_thread_init()
 		     SYNC_STATS_AUTO_RECALC);
 
 	dict_stats_recalc_pool_init();
+
+	dict_stats_pool.event = os_event_create();
+	dict_stats_pool.tasks = new dict_stats_task_list_t();
+	dict_stats_pool.n_workers = 0;
+	dict_stats_pool.exiting = false;
+	dict_stats_pool.mutex = os_mutex_create();
 }
 
 /*****************************************************************//**
@@ -248,6 +293,14 @@ dict_stats_thread_deinit()
 
 	os_event_free(dict_stats_event);
 	dict_stats_event = NULL;
+
+	ut_ad(dict_stats_pool.n_workers == 0);
+	ut_ad(dict_stats_pool.tasks->empty());
+
+	os_mutex_free(dict_stats_pool.mutex);
+	dict_stats_pool.mutex = NULL;
+	os_event_free(dict_stats_pool.event);
+	delete dict_stats_pool.tasks;
 }
 
 /*****************************************************************//**
@@ -288,6 +341,22 @@ dict_stats_process_entry_from_recalc_pool()
 		return;
 	}
 
+	if (table->stats_bg_flag & BG_STAT_IN_PROGRESS) {
+		/* Another thread of the batch popped the table before
+		it was added again. Two threads must not use the table,
+		because dict_stats_wait_bg_to_stop_using_table() only
+		waits for the flag to be cleared. */
+
+		mutex_exit(&dict_sys->mutex);
+
+		dict_stats_recalc_pool_add(table);
+
+		mutex_enter(&dict_sys->mutex);
+		dict_table_close(table, TRUE, FALSE);
+		mutex_exit(&dict_sys->mutex);
+		return;
+	}
+
 	table->stats_bg_flag = BG_STAT_IN_PROGRESS;
 
 	mutex_exit(&dict_sys->mutex);
@@ -322,6 +391,232 @@ dict_stats_process_entry_from_recalc_pool()
 	mutex_exit(&dict_sys->mutex);
 }
 
+/*****************************************************************//**
+Worker thread of dict_stats_pool. It joins the oldest task that still
+wants helpers, until the pool is shut down.
+@return a dummy parameter */
+extern "C"
+os_thread_ret_t
+DECLARE_THREAD(dict_stats_worker_thread)(
+/*=====================================*/
+	void*	arg __attribute__((unused)))	/*!< in: a dummy parameter */
+{
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(dict_stats_worker_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	os_mutex_enter(dict_stats_pool.mutex);
+
+	while (!dict_stats_pool.exiting) {
+		dict_stats_task_t*	task;
+
+		if (dict_stats_pool.tasks->empty()) {
+			ib_int64_t	sig_count;
+
+			sig_count = os_event_reset(dict_stats_pool.event);
+			os_mutex_exit(dict_stats_pool.mutex);
+
+			os_event_wait_low(dict_stats_pool.event, sig_count);
+
+			os_mutex_enter(dict_stats_pool.mutex);
+			continue;
+		}
+
+		task = dict_stats_pool.tasks->front();
+
+		ut_ad(task->n_wanted > 0);
+
+		if (--task->n_wanted == 0) {
+			dict_stats_pool.tasks->pop_front();
+		}
+
+		task->n_active++;
+
+		os_mutex_exit(dict_stats_pool.mutex);
+
+		task->func(task->arg);
+
+		os_mutex_enter(dict_stats_pool.mutex);
+
+		if (--task->n_active == 0) {
+			os_event_set(task->done);
+		}
+	}
+
+	dict_stats_pool.n_workers--;
+
+	os_mutex_exit(dict_stats_pool.mutex);
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*****************************************************************//**
+Runs func(arg) in the calling thread and in up to n_helpers threads of
+the stats worker pool, and returns when all of them have returned. The
+callers of func must share the work among themselves; if no worker
+joins in, the calling thread does all of it. The pool grows on demand
+and its threads are reused until shutdown. */
+UNIV_INTERN
+void
+dict_stats_pool_run(
+/*================*/
+	void		(*func)(void*),	/*!< in: function to run */
+	void*		arg,		/*!< in/out: argument of func */
+	ulint		n_helpers)	/*!< in: number of worker threads
+					that may join the calling thread */
+{
+	dict_stats_task_t	task;
+
+	n_helpers = ut_min(n_helpers, DICT_STATS_POOL_MAX);
+
+	/* The pool does not exist in read-only mode. */
+	if (n_helpers == 0 || dict_stats_pool.mutex == NULL) {
+		func(arg);
+		return;
+	}
+
+	os_mutex_enter(dict_stats_pool.mutex);
+
+	if (dict_stats_pool.exiting) {
+		os_mutex_exit(dict_stats_pool.mutex);
+		func(arg);
+		return;
+	}
+
+	while (dict_stats_pool.n_workers < n_helpers) {
+		dict_stats_pool.n_workers++;
+		os_thread_create(dict_stats_worker_thread, NULL, NULL);
+	}
+
+	task.func = func;
+	task.arg = arg;
+	task.n_wanted = n_helpers;
+	task.n_active = 0;
+	task.done = os_event_create();
+
+	dict_stats_pool.tasks->push_back(&task);
+	os_event_set(dict_stats_pool.event);
+
+	os_mutex_exit(dict_stats_pool.mutex);
+
+	func(arg);
+
+	/* The work is done. Workers that have not joined yet must not
+	join any more, and those that did must return first. */
+
+	os_mutex_enter(dict_stats_pool.mutex);
+
+	if (task.n_wanted > 0) {
+		dict_stats_pool.tasks->remove(&task);
+	}
+
+	while (task.n_active > 0) {
+		ib_int64_t	sig_count = os_event_reset(task.done);
+
+		os_mutex_exit(dict_stats_pool.mutex);
+		os_event_wait_low(task.done, sig_count);
+		os_mutex_enter(dict_stats_pool.mutex);
+	}
+
+	os_mutex_exit(dict_stats_pool.mutex);
+
+	os_event_free(task.done);
+}
+
+/*****************************************************************//**
+Makes the threads of the stats worker pool exit and waits for them.
+Tasks that are still running are completed by their callers. */
+static
+void
+dict_stats_pool_shutdown()
+/*======================*/
+{
+	os_mutex_enter(dict_stats_pool.mutex);
+
+	dict_stats_pool.exiting = true;
+	os_event_set(dict_stats_pool.event);
+
+	while (dict_stats_pool.n_workers > 0) {
+		os_mutex_exit(dict_stats_pool.mutex);
+		os_thread_sleep(10000);
+		os_mutex_enter(dict_stats_pool.mutex);
+	}
+
+	os_mutex_exit(dict_stats_pool.mutex);
+}
+
+/** Batch of tables whose stats are recalculated by several threads */
+struct dict_stats_batch_t {
+	os_ib_mutex_t	mutex;		/*!< protects n_left */
+	ulint		n_left;		/*!< number of tables still to be
+					taken from the recalc pool */
+};
+
+/*****************************************************************//**
+Takes tables from the auto recalc pool until the batch is complete or
+the server is shutting down. Run by dict_stats_pool_run(). */
+static
+void
+dict_stats_process_batch(
+/*=====================*/
+	void*	arg)	/*!< in/out: dict_stats_batch_t* */
+{
+	dict_stats_batch_t*	batch = static_cast<dict_stats_batch_t*>(arg);
+
+	for (;;) {
+		bool	more;
+
+		os_mutex_enter(batch->mutex);
+
+		more = batch->n_left > 0 && !SHUTTING_DOWN();
+
+		if (more) {
+			batch->n_left--;
+		}
+
+		os_mutex_exit(batch->mutex);
+
+		if (!more) {
+			break;
+		}
+
+		dict_stats_process_entry_from_recalc_pool();
+	}
+}
+
+/*****************************************************************//**
+Recalculates the stats of the tables that are in the auto recalc pool,
+with up to srv_stats_threads threads. Tables that are added to the pool
+while the batch is processed are left for the next batch. */
+static
+void
+dict_stats_process_recalc_pool()
+/*============================*/
+{
+	dict_stats_batch_t	batch;
+
+	mutex_enter(&recalc_pool_mutex);
+	batch.n_left = recalc_pool.size();
+	mutex_exit(&recalc_pool_mutex);
+
+	if (batch.n_left == 0) {
+		return;
+	}
+
+	batch.mutex = os_mutex_create();
+
+	/* The calling thread processes tables too. */
+	dict_stats_pool_run(dict_stats_process_batch, &batch,
+			    ut_min(srv_stats_threads, batch.n_left) - 1);
+
+	os_mutex_free(batch.mutex);
+}
+
 /*****************************************************************//**
 This is the thread for background stats gathering. It pops tables, from
 the auto recalc list and proceeds them, eventually recalculating their
@@ -342,7 +637,7 @@ DECLARE_THREAD(dict_stats_thread)(
 
 		/* Wake up periodically even if not signaled. This is
 		because we may lose an event - if the below call to
-		dict_stats_process_entry_from_recalc_pool() puts the entry back
+		dict_stats_process_recalc_pool() puts an entry back
 		in the list, the os_event_set() will be lost by the subsequent
 		os_event_reset(). */
 		os_event_wait_time(
@@ -352,11 +647,13 @@ DECLARE_THREAD(dict_stats_thread)(
 			break;
 		}
 
-		dict_stats_process_entry_from_recalc_pool();
+		dict_stats_process_recalc_pool();
 
 		os_event_reset(dict_stats_event);
 	}
 
+	dict_stats_pool_shutdown();
+
 	srv_dict_stats_thread_active = FALSE;
 
 	/* We count the number of threads in os_thread_exit(). A created
@@ -430,7 +430,8 @@ fc_recv_dwb_pages_to_disk(void)
                    zip_size ? zip_size : UNIV_PAGE_SIZE, read_buf, NULL);
 			lsn_in_disk  = mach_read_from_8(read_buf + FIL_PAGE_LSN);
 			
-			if (buf_page_is_corrupted(true, read_buf, zip_size)
+			if ((!zip_size && !os_file_decompress_page(read_buf))
+					|| buf_page_is_corrupted(true, read_buf, zip_size)
 					|| lsn_in_dwb > lsn_in_disk) {
                 /* write back from doublewrite buffer to disk */
 				fil_io(OS_FILE_WRITE, TRUE, space_id, zip_size, page_no, 0,
@@ -28,6 +28,9 @@ Created 10/25/1995 Heikki Tuuri
 #include <debug_sync.h>
 #include <my_dbug.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "fc0fc.h"
 #include "mem0mem.h"
 #include "hash0hash.h"
@@ -110,7 +113,15 @@ file at the end of the LRU-list. When an i/o-operation is pending on a file,
 the file cannot be closed. We take the file nodes with pending i/o-operations
 out of the LRU-list and keep a count of pending operations. When an operation
 completes, we decrement the count and return the file node to the LRU-list if
-the count drops to zero. */
+the count drops to zero.
+
+An i/o on a file that is open and already has pending i/o's, or that is not
+in the LRU-list, does not need fil_system->mutex: the space is looked up in
+fil_system->spaces under an s-latch of the hash table, and the count of
+pending i/o's of the file is incremented atomically before the latch is
+released. The count can only drop to zero, and a file can only be closed and
+a tablespace renamed or dropped, by a thread that holds both the mutex and
+the x-latch of the space in the hash table. */
 
 /** When mysqld is run, the default directory "." is the mysqld datadir,
 but in the MySQL Embedded Server Library and ibbackup it is not the default
@@ -144,6 +155,27 @@ UNIV_INTERN mysql_pfs_key_t	fil_system_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	fil_space_latch_key;
 #endif /* UNIV_PFS_RWLOCK */
 
+#ifdef UNIV_PFS_THREAD
+/* Key to register the tablespace discovery threads with performance schema */
+UNIV_INTERN mysql_pfs_key_t	fil_load_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
+#if defined HAVE_ATOMIC_BUILTINS && !defined UNIV_HOTBACKUP
+/** Define this to do i/o on open files without fil_system->mutex */
+# define FIL_IO_LATCH_FREE
+#endif /* HAVE_ATOMIC_BUILTINS && !UNIV_HOTBACKUP */
+
+/** Number of rw-locks protecting fil_system->spaces; must be a power of 2 */
+#define FIL_SPACE_HASH_LOCKS		64
+
+/** Maximum number of threads that discover the single-table tablespaces
+at startup */
+#define FIL_LOAD_MAX_THREADS		16
+
+/** Number of .ibd files per thread below which fewer threads are used
+to open the discovered tablespaces */
+#define FIL_LOAD_FILES_PER_THREAD	64
+
 /** File node of a tablespace or the log data space */
 struct fil_node_t {
 	fil_space_t*	space;	/*!< backpointer to the space where this node
@@ -161,7 +193,12 @@ struct fil_node_t {
 	ulint		n_pending;
 				/*!< count of pending i/o's on this file;
 				closing of the file is not allowed if
-				this is > 0 */
+				this is > 0; modified atomically; can be
+				incremented under an s-latch on
+				fil_system->spaces if it is > 0 or the
+				file is not in the LRU list, and only
+				drops to zero under fil_system->mutex and
+				the x-latch of the space */
 	ulint		n_pending_flushes;
 				/*!< count of pending flushes on this file;
 				closing of the file is not allowed if
@@ -226,6 +263,17 @@ struct fil_space_t {
 	ulint		flags;	/*!< tablespace flags; see
 				fsp_flags_is_valid(),
 				fsp_flags_get_zip_size() */
+	bool		is_temporary;
+				/*!< true if the tablespace holds a
+				table created with CREATE TEMPORARY TABLE;
+				its pages are not written through the
+				doublewrite buffer, because the file is
+				discarded after a crash */
+	bool		page_compressed;
+				/*!< true if the pages of the tablespace
+				are compressed when they are written
+				and the unused tail of each page is
+				punched out of the file */
 	ulint		n_reserved_extents;
 				/*!< number of reserved free extents for
 				ongoing operations like B-tree page split */
@@ -268,7 +316,8 @@ struct fil_system_t {
 #endif /* !UNIV_HOTBACKUP */
 	hash_table_t*	spaces;		/*!< The hash table of spaces in the
 					system; they are hashed on the space
-					id */
+					id; modified under both the mutex
+					and the x-latch of the space id */
 	hash_table_t*	name_hash;	/*!< hash table based on the space
 					name */
 	UT_LIST_BASE_NODE_T(fil_node_t) LRU;
@@ -378,9 +427,8 @@ fil_space_belongs_in_lru(
 NOTE: you must call fil_mutex_enter_and_prepare_for_io() first!
 
 Prepares a file node for i/o. Opens the file if it is closed. Updates the
-pending i/o's field in the node and the system appropriately. Takes the node
-off the LRU list if it is in the LRU list. The caller must hold the fil_sys
-mutex.
+pending i/o's field in the node and the system appropriately. The caller must
+hold the fil_sys mutex.
 @return false if the file can't be opened, otherwise true */
 static
 bool
@@ -391,7 +439,8 @@ fil_node_prepare_for_io(
 	fil_space_t*	space);	/*!< in: space */
 /********************************************************************//**
 Updates the data structures when an i/o operation finishes. Updates the
-pending i/o's field in the node appropriately. */
+pending i/o's field in the node appropriately. The caller must hold the
+fil_sys mutex. */
 static
 void
 fil_node_complete_io(
@@ -707,7 +756,9 @@ fil_node_create(
 
 	node->space = space;
 
+	hash_lock_x(fil_system->spaces, id);
 	UT_LIST_ADD_LAST(chain, space->chain, node);
+	hash_unlock_x(fil_system->spaces, id);
 
 	if (id < SRV_LOG_SPACE_FIRST_ID && fil_system->max_assigned_id < id) {
 
@@ -903,7 +954,9 @@ add_size:
 
 	ut_a(ret);
 
+	hash_lock_x(system->spaces, space->id);
 	node->open = TRUE;
+	hash_unlock_x(system->spaces, space->id);
 
 	system->n_open++;
 	fil_n_file_opened++;
@@ -930,6 +983,11 @@ fil_node_close_file(
 
 	ut_ad(node && system);
 	ut_ad(mutex_own(&(system->mutex)));
+
+	/* The x-latch prevents i/o's from being started on the file
+	without the mutex while we check and close it. */
+	hash_lock_x(system->spaces, node->space->id);
+
 	ut_a(node->open);
 	ut_a(node->n_pending == 0);
 	ut_a(node->n_pending_flushes == 0);
@@ -945,6 +1003,8 @@ fil_node_close_file(
 	/* printf("Closing file %s\n", node->name); */
 
 	node->open = FALSE;
+
+	hash_unlock_x(system->spaces, node->space->id);
 	ut_a(system->n_open > 0);
 	system->n_open--;
 	fil_n_file_opened--;
@@ -1212,7 +1272,9 @@ fil_node_free(
 
 	space->size -= node->size;
 
+	hash_lock_x(system->spaces, space->id);
 	UT_LIST_REMOVE(chain, space->chain, node);
+	hash_unlock_x(system->spaces, space->id);
 
 	os_event_free(node->sync_event);
 	mem_free(node->name);
@@ -1353,7 +1415,9 @@ fil_space_create(
 
 	rw_lock_create(fil_space_latch_key, &space->latch, SYNC_FSP);
 
+	hash_lock_x(fil_system->spaces, id);
 	HASH_INSERT(fil_space_t, hash, fil_system->spaces, id, space);
+	hash_unlock_x(fil_system->spaces, id);
 
 	HASH_INSERT(fil_space_t, name_hash, fil_system->name_hash,
 		    ut_fold_string(name), space);
@@ -1457,7 +1521,9 @@ fil_space_free(
 		return(FALSE);
 	}
 
+	hash_lock_x(fil_system->spaces, id);
 	HASH_DELETE(fil_space_t, hash, fil_system->spaces, id, space);
+	hash_unlock_x(fil_system->spaces, id);
 
 	fnamespace = fil_space_get_by_name(space->name);
 	ut_a(fnamespace);
@@ -1662,6 +1728,74 @@ fil_space_get_flags(
 	return(flags);
 }
 
+/*******************************************************************//**
+Checks if a tablespace holds a table created with CREATE TEMPORARY TABLE.
+The tablespace must be cached in the memory cache.
+@return	true if the space is a temporary tablespace */
+UNIV_INTERN
+bool
+fil_space_is_temporary(
+/*===================*/
+	ulint	id)	/*!< in: space id */
+{
+	fil_space_t*	space;
+	bool		is_temporary;
+
+	ut_ad(fil_system);
+
+	if (!id) {
+		return(false);
+	}
+
+#ifdef FIL_IO_LATCH_FREE
+	hash_lock_s(fil_system->spaces, id);
+
+	HASH_SEARCH(hash, fil_system->spaces, id,
+		    fil_space_t*, space,
+		    ut_ad(space->magic_n == FIL_SPACE_MAGIC_N),
+		    space->id == id);
+
+	is_temporary = space != NULL && space->is_temporary;
+
+	hash_unlock_s(fil_system->spaces, id);
+#else /* FIL_IO_LATCH_FREE */
+	mutex_enter(&fil_system->mutex);
+
+	space = fil_space_get_by_id(id);
+
+	is_temporary = space != NULL && space->is_temporary;
+
+	mutex_exit(&fil_system->mutex);
+#endif /* FIL_IO_LATCH_FREE */
+
+	return(is_temporary);
+}
+
+/*******************************************************************//**
+Makes the pages of a single-table tablespace compressed when they are
+written. Pages that were written before keep their format until they
+are written again; reads accept both formats. */
+UNIV_INTERN
+void
+fil_space_set_page_compressed(
+/*==========================*/
+	ulint	id)	/*!< in: space id */
+{
+	fil_space_t*	space;
+
+	ut_ad(fil_is_user_tablespace_id(id));
+
+	mutex_enter(&fil_system->mutex);
+
+	space = fil_space_get_by_id(id);
+
+	if (space != NULL) {
+		space->page_compressed = true;
+	}
+
+	mutex_exit(&fil_system->mutex);
+}
+
 /*******************************************************************//**
 Returns the compressed page size of the space, or 0 if the space
 is not compressed. The tablespace must be cached in the memory cache.
@@ -1726,6 +1860,11 @@ fil_init(
 	fil_system->spaces = hash_create(hash_size);
 	fil_system->name_hash = hash_create(hash_size);
 
+#ifndef UNIV_HOTBACKUP
+	hash_create_sync_obj(fil_system->spaces, HASH_TABLE_SYNC_RW_LOCK,
+			     FIL_SPACE_HASH_LOCKS, SYNC_FIL_SPACE_HASH);
+#endif /* !UNIV_HOTBACKUP */
+
 	UT_LIST_INIT(fil_system->LRU);
 
 	fil_system->max_n_open = max_n_open;
@@ -2582,7 +2721,10 @@ fil_check_pending_operations(
 	mutex_enter(&fil_system->mutex);
 	fil_space_t* sp = fil_space_get_by_id(id);
 	if (sp) {
+		/* Let no read start without fil_system->mutex */
+		hash_lock_x(fil_system->spaces, id);
 		sp->stop_new_ops = TRUE;
+		hash_unlock_x(fil_system->spaces, id);
 	}
 	mutex_exit(&fil_system->mutex);
 
@@ -3092,7 +3234,9 @@ retry:
 	operating systems can rename an open file. For the closing we have to
 	wait until there are no pending i/o's or flushes on the file. */
 
+	hash_lock_x(fil_system->spaces, id);
 	space->stop_ios = TRUE;
+	hash_unlock_x(fil_system->spaces, id);
 
 	/* The following code must change when InnoDB supports
 	multiple datafiles per tablespace. */
@@ -3555,6 +3699,16 @@ fil_create_new_single_table_tablespace(
 		goto error_exit_1;
 	}
 
+	if (is_temp) {
+		mutex_enter(&fil_system->mutex);
+		fil_space_get_by_id(space_id)->is_temporary = true;
+		mutex_exit(&fil_system->mutex);
+	}
+
+	if (flags2 & DICT_TF2_PAGE_COMPRESSED) {
+		fil_space_set_page_compressed(space_id);
+	}
+
 #ifndef UNIV_HOTBACKUP
 	{
 		mtr_t		mtr;
@@ -4631,6 +4785,248 @@ fil_file_readdir_next_file(
 	return(-1);
 }
 
+/** A tablespace file found in a database directory */
+struct fil_load_file_t {
+	const char*	dbname;		/*!< database name */
+	char*		filename;	/*!< file name, ending in .ibd
+					or .isl */
+};
+
+/** Shared state of the tablespace discovery threads */
+struct fil_load_t {
+	os_ib_mutex_t	mutex;		/*!< protects the members below,
+					except the vectors while the
+					threads only read them */
+	os_event_t	done;		/*!< set when the last helper
+					thread exits */
+	ulint		n_helpers;	/*!< number of helper threads
+					still running */
+	bool		scanning;	/*!< true while the database
+					directories are being listed,
+					false while the files are opened */
+	std::vector<char*>
+			dbnames;	/*!< database directories */
+	ulint		next_db;	/*!< next directory to list */
+	std::vector<fil_load_file_t>
+			files;		/*!< tablespace files found */
+	ulint		next_file;	/*!< next file to open */
+	dberr_t		err;		/*!< DB_ERROR if a directory
+					could not be read */
+};
+
+/********************************************************************//**
+Compares two file names without their .ibd or .isl extension.
+@return true if a sorts before b */
+static
+bool
+fil_load_file_less(
+/*===============*/
+	const fil_load_file_t&	a,	/*!< in: file */
+	const fil_load_file_t&	b)	/*!< in: file */
+{
+	ulint	a_len = strlen(a.filename) - 4;
+	ulint	b_len = strlen(b.filename) - 4;
+	int	cmp = memcmp(a.filename, b.filename, ut_min(a_len, b_len));
+
+	return(cmp < 0 || (cmp == 0 && a_len < b_len));
+}
+
+/********************************************************************//**
+Lists the .ibd and .isl files of a database directory. A table that
+has both an .ibd and an .isl file is listed once, because
+fil_load_single_table_tablespace() looks for both.
+@return DB_SUCCESS or DB_ERROR */
+static
+dberr_t
+fil_load_scan_db(
+/*=============*/
+	const char*			dbname,	/*!< in: database name */
+	std::vector<fil_load_file_t>&	files)	/*!< out: files found */
+{
+	ulint		len;
+	char*		dbpath;
+	os_file_dir_t	dbdir;
+	os_file_stat_t	fileinfo;
+	dberr_t		err = DB_SUCCESS;
+	ulint		first = files.size();
+
+	len = strlen(fil_path_to_mysql_datadir) + strlen(dbname) + 2;
+	dbpath = static_cast<char*>(mem_alloc(len));
+	ut_snprintf(dbpath, len, "%s/%s", fil_path_to_mysql_datadir, dbname);
+	srv_normalize_path_for_win(dbpath);
+
+	dbdir = os_file_opendir(dbpath, FALSE);
+
+	if (dbdir == NULL) {
+		/* A symlink that does not point to a directory */
+		mem_free(dbpath);
+		return(DB_SUCCESS);
+	}
+
+	while (fil_file_readdir_next_file(&err, dbpath, dbdir,
+					  &fileinfo) == 0) {
+		ulint	name_len = strlen(fileinfo.name);
+
+		/* We found a symlink or a file whose name
+		ends in .ibd or .isl */
+		if (fileinfo.type != OS_FILE_TYPE_DIR
+		    && name_len > 4
+		    && (0 == strcmp(fileinfo.name + name_len - 4, ".ibd")
+			|| 0 == strcmp(fileinfo.name + name_len - 4,
+				       ".isl"))) {
+			fil_load_file_t	file;
+
+			file.dbname = dbname;
+			file.filename = mem_strdup(fileinfo.name);
+			files.push_back(file);
+		}
+	}
+
+	if (0 != os_file_closedir(dbdir)) {
+		fputs("InnoDB: Warning: could not"
+		      " close database directory ", stderr);
+		ut_print_filename(stderr, dbpath);
+		putc('\n', stderr);
+
+		err = DB_ERROR;
+	}
+
+	mem_free(dbpath);
+
+	std::sort(files.begin() + first, files.end(), fil_load_file_less);
+
+	ulint	n = first;
+
+	for (ulint i = first; i < files.size(); i++) {
+		if (n > first
+		    && !fil_load_file_less(files[n - 1], files[i])) {
+			mem_free(files[i].filename);
+		} else {
+			files[n++] = files[i];
+		}
+	}
+
+	files.resize(n);
+
+	return(err);
+}
+
+/********************************************************************//**
+Claims database directories or tablespace files from the shared state
+and processes them until none are left. */
+static
+void
+fil_load_work(
+/*==========*/
+	fil_load_t*	load)	/*!< in/out: shared state */
+{
+	std::vector<fil_load_file_t>	files;
+	dberr_t				err = DB_SUCCESS;
+
+	for (;;) {
+		ulint	i;
+
+		os_mutex_enter(load->mutex);
+
+		if (load->scanning) {
+			i = load->next_db < load->dbnames.size()
+				? load->next_db++ : ULINT_UNDEFINED;
+		} else {
+			i = load->next_file < load->files.size()
+				? load->next_file++ : ULINT_UNDEFINED;
+		}
+
+		os_mutex_exit(load->mutex);
+
+		if (i == ULINT_UNDEFINED) {
+			break;
+		} else if (!load->scanning) {
+			fil_load_single_table_tablespace(
+				load->files[i].dbname,
+				load->files[i].filename);
+		} else if (fil_load_scan_db(load->dbnames[i], files)
+			   != DB_SUCCESS) {
+			err = DB_ERROR;
+		}
+	}
+
+	if (load->scanning) {
+		os_mutex_enter(load->mutex);
+
+		load->files.insert(load->files.end(),
+				   files.begin(), files.end());
+
+		if (err != DB_SUCCESS) {
+			load->err = err;
+		}
+
+		os_mutex_exit(load->mutex);
+	}
+}
+
+/********************************************************************//**
+Thread helping fil_load_single_table_tablespaces() to list the database
+directories and to open the tablespace files.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(fil_load_thread)(
+/*============================*/
+	void*	arg)	/*!< in: fil_load_t* */
+{
+	fil_load_t*	load = static_cast<fil_load_t*>(arg);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(fil_load_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	fil_load_work(load);
+
+	os_mutex_enter(load->mutex);
+
+	ut_ad(load->n_helpers > 0);
+
+	if (--load->n_helpers == 0) {
+		os_event_set(load->done);
+	}
+
+	os_mutex_exit(load->mutex);
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/********************************************************************//**
+Processes the database directories or the tablespace files with up to
+n_threads threads, including the calling thread. */
+static
+void
+fil_load_run(
+/*=========*/
+	fil_load_t*	load,		/*!< in/out: shared state */
+	ulint		n_threads)	/*!< in: number of threads */
+{
+	ulint	n_helpers = ut_min(ut_max(n_threads, 1),
+				    FIL_LOAD_MAX_THREADS) - 1;
+
+	os_event_reset(load->done);
+	load->n_helpers = n_helpers;
+
+	for (ulint i = 0; i < n_helpers; i++) {
+		os_thread_create(fil_load_thread, load, NULL);
+	}
+
+	fil_load_work(load);
+
+	if (n_helpers > 0) {
+		os_event_wait(load->done);
+	}
+}
+
 /********************************************************************//**
 At the server startup, if we need crash recovery, scans the database
 directories under the MySQL datadir, looking for .ibd files. Those files are
@@ -4638,20 +5034,20 @@ single-table tablespaces. We need to know the space id in each of them so that
 we know into which file we should look to check the contents of a page stored
 in the doublewrite buffer, also to know where to apply log records where the
 space id is != 0.
+
+The database directories are listed and the first pages of the files are
+read by several threads. The files are only opened to read the space id;
+fil_node_open() opens them again when recovery accesses the tablespace.
 @return	DB_SUCCESS or error number */
 UNIV_INTERN
 dberr_t
 fil_load_single_table_tablespaces(void)
 /*===================================*/
 {
-	int		ret;
-	char*		dbpath		= NULL;
-	ulint		dbpath_len	= 100;
 	os_file_dir_t	dir;
-	os_file_dir_t	dbdir;
 	os_file_stat_t	dbinfo;
-	os_file_stat_t	fileinfo;
-	dberr_t		err		= DB_SUCCESS;
+	fil_load_t	load;
+	dberr_t		err = DB_SUCCESS;
 
 	/* The datadir of MySQL is always the default directory of mysqld */
 
@@ -4662,102 +5058,56 @@ fil_load_single_table_tablespaces(void)
 		return(DB_ERROR);
 	}
 
-	dbpath = static_cast<char*>(mem_alloc(dbpath_len));
-
 	/* Scan all directories under the datadir. They are the database
-	directories of MySQL. */
+	directories of MySQL. We found a symlink or a directory; whether
+	a symlink is a directory is checked when it is opened. */
 
-	ret = fil_file_readdir_next_file(&err, fil_path_to_mysql_datadir, dir,
-					 &dbinfo);
-	while (ret == 0) {
-		ulint len;
-		/* printf("Looking at %s in datadir\n", dbinfo.name); */
+	while (fil_file_readdir_next_file(&err, fil_path_to_mysql_datadir,
+					  dir, &dbinfo) == 0) {
 
-		if (dbinfo.type == OS_FILE_TYPE_FILE
-		    || dbinfo.type == OS_FILE_TYPE_UNKNOWN) {
+		if (dbinfo.type != OS_FILE_TYPE_FILE
+		    && dbinfo.type != OS_FILE_TYPE_UNKNOWN) {
 
-			goto next_datadir_item;
+			load.dbnames.push_back(mem_strdup(dbinfo.name));
 		}
+	}
 
-		/* We found a symlink or a directory; try opening it to see
-		if a symlink is a directory */
-
-		len = strlen(fil_path_to_mysql_datadir)
-			+ strlen (dbinfo.name) + 2;
-		if (len > dbpath_len) {
-			dbpath_len = len;
-
-			if (dbpath) {
-				mem_free(dbpath);
-			}
-
-			dbpath = static_cast<char*>(mem_alloc(dbpath_len));
-		}
-		ut_snprintf(dbpath, dbpath_len,
-			    "%s/%s", fil_path_to_mysql_datadir, dbinfo.name);
-		srv_normalize_path_for_win(dbpath);
-
-		dbdir = os_file_opendir(dbpath, FALSE);
-
-		if (dbdir != NULL) {
-
-			/* We found a database directory; loop through it,
-			looking for possible .ibd files in it */
-
-			ret = fil_file_readdir_next_file(&err, dbpath, dbdir,
-							 &fileinfo);
-			while (ret == 0) {
+	if (0 != os_file_closedir(dir)) {
+		fprintf(stderr,
+			"InnoDB: Error: could not close MySQL datadir\n");
 
-				if (fileinfo.type == OS_FILE_TYPE_DIR) {
+		err = DB_ERROR;
+	}
 
-					goto next_file_item;
-				}
+	load.mutex = os_mutex_create();
+	load.done = os_event_create();
+	load.next_db = 0;
+	load.next_file = 0;
+	load.err = err;
 
-				/* We found a symlink or a file */
-				if (strlen(fileinfo.name) > 4
-				    && (0 == strcmp(fileinfo.name
-						   + strlen(fileinfo.name) - 4,
-						   ".ibd")
-					|| 0 == strcmp(fileinfo.name
-						   + strlen(fileinfo.name) - 4,
-						   ".isl"))) {
-					/* The name ends in .ibd or .isl;
-					try opening the file */
-					fil_load_single_table_tablespace(
-						dbinfo.name, fileinfo.name);
-				}
-next_file_item:
-				ret = fil_file_readdir_next_file(&err,
-								 dbpath, dbdir,
-								 &fileinfo);
-			}
+	load.scanning = true;
+	fil_load_run(&load, load.dbnames.size());
 
-			if (0 != os_file_closedir(dbdir)) {
-				fputs("InnoDB: Warning: could not"
-				      " close database directory ", stderr);
-				ut_print_filename(stderr, dbpath);
-				putc('\n', stderr);
+	load.scanning = false;
+	fil_load_run(&load,
+		     load.files.size() / FIL_LOAD_FILES_PER_THREAD + 1);
 
-				err = DB_ERROR;
-			}
-		}
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Found %lu tablespace files in %lu database directories.",
+		(ulong) load.files.size(), (ulong) load.dbnames.size());
 
-next_datadir_item:
-		ret = fil_file_readdir_next_file(&err,
-						 fil_path_to_mysql_datadir,
-						 dir, &dbinfo);
+	for (ulint i = 0; i < load.files.size(); i++) {
+		mem_free(load.files[i].filename);
 	}
 
-	mem_free(dbpath);
-
-	if (0 != os_file_closedir(dir)) {
-		fprintf(stderr,
-			"InnoDB: Error: could not close MySQL datadir\n");
-
-		return(DB_ERROR);
+	for (ulint i = 0; i < load.dbnames.size(); i++) {
+		mem_free(load.dbnames[i]);
 	}
 
-	return(err);
+	os_event_free(load.done);
+	os_mutex_free(load.mutex);
+
+	return(load.err);
 }
 
 /*******************************************************************//**
@@ -5207,6 +5557,80 @@ retry:
 	return(success);
 }
 
+/**********************************************************************//**
+Truncates a single-file tablespace to the given number of pages. The
+caller must ensure that no pages beyond the new size are in the buffer
+pool or will be accessed again.
+@return	TRUE if success */
+UNIV_INTERN
+ibool
+fil_truncate_space(
+/*===============*/
+	ulint	space_id,	/*!< in: space id */
+	ulint	size)		/*!< in: new size in pages */
+{
+	fil_node_t*	node;
+	fil_space_t*	space;
+	ibool		success;
+
+	ut_ad(!srv_read_only_mode);
+
+retry:
+	fil_mutex_enter_and_prepare_for_io(space_id);
+
+	space = fil_space_get_by_id(space_id);
+	ut_a(space);
+	ut_a(UT_LIST_GET_LEN(space->chain) == 1);
+	ut_a(!fsp_flags_get_zip_size(space->flags));
+
+	if (space->size <= size) {
+		mutex_exit(&fil_system->mutex);
+
+		return(TRUE);
+	}
+
+	node = UT_LIST_GET_FIRST(space->chain);
+
+	if (node->being_extended) {
+		mutex_exit(&fil_system->mutex);
+		os_thread_sleep(100000);
+		goto retry;
+	}
+
+	if (!fil_node_prepare_for_io(node, fil_system, space)) {
+		mutex_exit(&fil_system->mutex);
+
+		return(FALSE);
+	}
+
+	/* The being_extended flag keeps other threads from closing,
+	renaming or extending the file while we are resizing it. */
+	node->being_extended = TRUE;
+
+	mutex_exit(&fil_system->mutex);
+
+	success = os_file_truncate(
+		node->name, node->handle,
+		((os_offset_t) size) << UNIV_PAGE_SIZE_SHIFT);
+
+	mutex_enter(&fil_system->mutex);
+
+	if (success) {
+		space->size = size;
+		node->size = size;
+	}
+
+	node->being_extended = FALSE;
+
+	fil_node_complete_io(node, fil_system, OS_FILE_WRITE);
+
+	mutex_exit(&fil_system->mutex);
+
+	fil_flush(space_id);
+
+	return(success);
+}
+
 #ifdef UNIV_HOTBACKUP
 /********************************************************************//**
 Extends all tablespaces to the size stored in the space header. During the
@@ -5364,9 +5788,8 @@ fil_space_get_n_reserved_extents(
 NOTE: you must call fil_mutex_enter_and_prepare_for_io() first!
 
 Prepares a file node for i/o. Opens the file if it is closed. Updates the
-pending i/o's field in the node and the system appropriately. Takes the node
-off the LRU list if it is in the LRU list. The caller must hold the fil_sys
-mutex.
+pending i/o's field in the node and the system appropriately. The caller must
+hold the fil_sys mutex.
 @return false if the file can't be opened, otherwise true */
 static
 bool
@@ -5398,21 +5821,115 @@ fil_node_prepare_for_io(
 	}
 
 	if (node->n_pending == 0 && fil_space_belongs_in_lru(space)) {
-		/* The node is in the LRU list, remove it */
+		/* The node is in the LRU list, remove it. No i/o can
+		be started on it without the mutex, because the count
+		is zero. */
 
 		ut_a(UT_LIST_GET_LEN(system->LRU) > 0);
 
 		UT_LIST_REMOVE(LRU, system->LRU, node);
 	}
 
+#ifdef FIL_IO_LATCH_FREE
+	os_atomic_increment_ulint(&node->n_pending, 1);
+#else /* FIL_IO_LATCH_FREE */
 	node->n_pending++;
+#endif /* FIL_IO_LATCH_FREE */
 
 	return(true);
 }
 
+#ifdef FIL_IO_LATCH_FREE
+/********************************************************************//**
+Looks up an open file node for an i/o without acquiring the fil_sys mutex
+and increments its count of pending i/o's. This fails if the file is closed,
+if it is in the LRU list (it has no pending i/o's), if the tablespace is
+being renamed or, for a read, being dropped; the caller must then use
+fil_mutex_enter_and_prepare_for_io() and fil_node_prepare_for_io().
+@return file node, or NULL if the mutex must be acquired */
+static
+fil_node_t*
+fil_node_prepare_for_io_latch_free(
+/*===============================*/
+	ulint	space_id,	/*!< in: space id */
+	ulint	type,		/*!< in: OS_FILE_READ or OS_FILE_WRITE */
+	ulint*	block_offset)	/*!< in: page offset in the space;
+				out: page offset in the file, if found */
+{
+	fil_space_t*	space;
+	fil_node_t*	node = NULL;
+	ulint		offset = *block_offset;
+
+	hash_lock_s(fil_system->spaces, space_id);
+
+	HASH_SEARCH(hash, fil_system->spaces, space_id,
+		    fil_space_t*, space,
+		    ut_ad(space->magic_n == FIL_SPACE_MAGIC_N),
+		    space->id == space_id);
+
+	if (space != NULL && !space->stop_ios
+	    && (type != OS_FILE_READ || !space->stop_new_ops)) {
+
+		for (node = UT_LIST_GET_FIRST(space->chain);
+		     node != NULL && node->size <= offset;
+		     node = UT_LIST_GET_NEXT(chain, node)) {
+
+			offset -= node->size;
+		}
+
+		/* A file in the LRU list must be taken out of it
+		under the mutex. The count cannot drop to zero while
+		we hold the s-latch. */
+		if (node != NULL && node->open
+		    && (node->n_pending > 0
+			|| !fil_space_belongs_in_lru(space))) {
+			os_atomic_increment_ulint(&node->n_pending, 1);
+		} else {
+			node = NULL;
+		}
+	}
+
+	hash_unlock_s(fil_system->spaces, space_id);
+
+	if (node != NULL) {
+		*block_offset = offset;
+	}
+
+	return(node);
+}
+#endif /* FIL_IO_LATCH_FREE */
+
+#ifdef FIL_IO_LATCH_FREE
+/********************************************************************//**
+Decrements the count of pending i/o's of a file node without the fil_sys
+mutex, unless the count would drop to zero on a file that belongs in the
+LRU list; putting the file back to the list requires the mutex.
+@return true if the count was decremented */
+static
+bool
+fil_node_complete_io_latch_free(
+/*============================*/
+	fil_node_t*	node)	/*!< in: file node */
+{
+	if (!fil_space_belongs_in_lru(node->space)) {
+		os_atomic_decrement_ulint(&node->n_pending, 1);
+		return(true);
+	}
+
+	for (ulint n = node->n_pending; n > 1; n = node->n_pending) {
+		if (os_compare_and_swap_ulint(&node->n_pending, n, n - 1)) {
+			return(true);
+		}
+	}
+
+	return(false);
+}
+#endif /* FIL_IO_LATCH_FREE */
+
 /********************************************************************//**
 Updates the data structures when an i/o operation finishes. Updates the
-pending i/o's field in the node appropriately. */
+pending i/o's field in the node appropriately. The caller must hold the
+fil_sys mutex. */
 static
 void
 fil_node_complete_io(
@@ -5429,8 +5946,6 @@ fil_node_complete_io(
 
 	ut_a(node->n_pending > 0);
 
-	node->n_pending--;
-
 	if (type == OS_FILE_WRITE) {
 		ut_ad(!srv_read_only_mode);
 		system->modification_counter++;
@@ -5453,11 +5968,54 @@ fil_node_complete_io(
 		}
 	}
 
+#ifdef FIL_IO_LATCH_FREE
+	if (fil_node_complete_io_latch_free(node)) {
+		return;
+	}
+
+	/* The count drops to zero. The x-latch prevents i/o's from
+	being started on the file without the mutex until it is back
+	in the LRU list. */
+	hash_lock_x(system->spaces, node->space->id);
+	os_atomic_decrement_ulint(&node->n_pending, 1);
+#else /* FIL_IO_LATCH_FREE */
+	node->n_pending--;
+#endif /* FIL_IO_LATCH_FREE */
+
 	if (node->n_pending == 0 && fil_space_belongs_in_lru(node->space)) {
 
 		/* The node must be put back to the LRU list */
 		UT_LIST_ADD_FIRST(LRU, system->LRU, node);
 	}
+
+#ifdef FIL_IO_LATCH_FREE
+	hash_unlock_x(system->spaces, node->space->id);
+#endif /* FIL_IO_LATCH_FREE */
+}
+
+/********************************************************************//**
+Updates the data structures when an i/o operation posted by fil_io()
+finishes. A write needs the fil_sys mutex to record the file as modified,
+and a read needs it if it was the last pending i/o on a file that must be
+returned to the LRU list. */
+static
+void
+fil_io_complete(
+/*============*/
+	fil_node_t*	node,	/*!< in: file node */
+	ulint		type)	/*!< in: OS_FILE_WRITE or OS_FILE_READ */
+{
+#ifdef FIL_IO_LATCH_FREE
+	if (type != OS_FILE_WRITE && fil_node_complete_io_latch_free(node)) {
+		return;
+	}
+#endif /* FIL_IO_LATCH_FREE */
+
+	mutex_enter(&fil_system->mutex);
+
+	fil_node_complete_io(node, fil_system, type);
+
+	mutex_exit(&fil_system->mutex);
 }
 
 /********************************************************************//**
@@ -5604,6 +6162,18 @@ fil_io(
 		srv_stats.data_written.add(len);
 	}
 
+#ifdef FIL_IO_LATCH_FREE
+	/* Most i/o's are on files that are already open */
+
+	node = fil_node_prepare_for_io_latch_free(
+		space_id, type, &block_offset);
+
+	if (node != NULL) {
+		space = node->space;
+		goto prepared;
+	}
+#endif /* FIL_IO_LATCH_FREE */
+
 	/* Reserve the fil_system mutex and make sure that we can open at
 	least one file while holding it, if the file is not already open */
 
@@ -5699,6 +6269,9 @@ fil_io(
 	/* Now we have made the changes in the data structures of fil_system */
 	mutex_exit(&fil_system->mutex);
 
+#ifdef FIL_IO_LATCH_FREE
+prepared:
+#endif /* FIL_IO_LATCH_FREE */
 	/* Calculate the low 32 bits and the high 32 bits of the file offset */
 
 	if (!zip_size) {
@@ -5739,6 +6312,18 @@ fil_io(
 				    offset, len);
 	}
 #else
+	/* Whole uncompressed pages are compressed on the way to a
+	tablespace that uses page compression. Page 0 is kept as is,
+	because it is read directly when the file is opened. */
+	if (type == OS_FILE_WRITE
+	    && space->page_compressed
+	    && !zip_size
+	    && len == UNIV_PAGE_SIZE
+	    && offset > 0) {
+
+		mode |= OS_AIO_PAGE_COMPRESS;
+	}
+
 	/* Queue the aio request */
 	ret = os_aio(type, mode | wake_later, node->name, node->handle, buf,
 		     offset, len, node, message);
@@ -5749,11 +6334,7 @@ fil_io(
 		/* The i/o operation is already completed when we return from
 		os_aio: */
 
-		mutex_enter(&fil_system->mutex);
-
-		fil_node_complete_io(node, fil_system, type);
-
-		mutex_exit(&fil_system->mutex);
+		fil_io_complete(node, type);
 
 		ut_ad(fil_validate_skip());
 	}
@@ -5808,14 +6389,18 @@ fil_aio_wait(
 
 	srv_set_io_thread_op_info(segment, "complete io for fil node");
 
-	mutex_enter(&fil_system->mutex);
-
-	fil_node_complete_io(fil_node, fil_system, type);
-
-	mutex_exit(&fil_system->mutex);
+	fil_io_complete(fil_node, type);
 
 	ut_ad(fil_validate_skip());
 
+	/* Let a DROP TABLE of a temporary table run between the
+	completion of the write in the file and the completion of
+	the page write in the buffer pool. */
+	DBUG_EXECUTE_IF("fil_aio_wait_delay_temporary",
+			if (fil_node->space->is_temporary) {
+				os_thread_sleep(100000);
+			});
+
 	/* Do the i/o handling */
 	/* IMPORTANT: since i/o handling for reads will read also the insert
 	buffer in tablespace 0, you have to be very careful not to introduce
@@ -6182,6 +6767,8 @@ fil_close(void)
 #ifndef UNIV_HOTBACKUP
 	/* The mutex should already have been freed. */
 	ut_ad(fil_system->mutex.magic_n == 0);
+
+	mem_free(fil_system->spaces->sync_obj.rw_locks);
 #endif /* !UNIV_HOTBACKUP */
 
 	hash_table_free(fil_system->spaces);
@@ -6308,7 +6895,18 @@ fil_iterate(
 
 			dberr_t	err;
 
-			if ((err = callback(page_off, block)) != DB_SUCCESS) {
+			if (!callback.get_zip_size()
+			    && !os_file_decompress_page(block->frame)) {
+
+				ib_logf(IB_LOG_LEVEL_ERROR,
+					"Page %lu of the tablespace is "
+					"compressed and corrupted.",
+					(ulong) (page_no - 1));
+
+				return(DB_CORRUPTION);
+
+			} else if ((err = callback(page_off, block))
+				   != DB_SUCCESS) {
 
 				return(err);
 
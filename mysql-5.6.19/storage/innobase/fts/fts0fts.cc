@@ -268,6 +268,26 @@ fts_sync(
 	fts_sync_t*	sync)		/*!< in: sync state */
 	__attribute__((nonnull));
 
+/****************************************************************//**
+Wait until no SYNC is writing the cache. The caller must hold the
+cache lock in X mode; the lock is released while waiting. */
+static
+void
+fts_sync_wait(
+/*==========*/
+	fts_cache_t*	cache)		/*!< in: cache */
+	__attribute__((nonnull));
+
+/****************************************************************//**
+Acquire the cache lock in X mode for a DDL operation that holds
+dict_sys->mutex, and wait until no SYNC is writing the cache. */
+static
+void
+fts_cache_x_lock_for_ddl(
+/*=====================*/
+	fts_cache_t*	cache)		/*!< in: cache */
+	__attribute__((nonnull));
+
 /****************************************************************//**
 Release all resources help by the words rb tree e.g., the node ilist. */
 static
@@ -669,6 +689,7 @@ fts_cache_create(
 		mem_heap_zalloc(heap, sizeof(fts_sync_t)));
 
 	cache->sync->table = table;
+	cache->sync->event = os_event_create();
 
 	/* Create the index cache vector that will hold the inverted indexes. */
 	cache->indexes = ib_vector_create(
@@ -702,6 +723,10 @@ fts_add_index(
 	ut_ad(fts);
 	cache = table->fts->cache;
 
+	/* Adding to cache->indexes may move the index caches
+	that a SYNC is writing. */
+	fts_cache_x_lock_for_ddl(cache);
+
 	rw_lock_x_lock(&cache->init_lock);
 
 	ib_vector_push(fts->indexes, &index);
@@ -714,6 +739,7 @@ fts_add_index(
 	}
 
 	rw_lock_x_unlock(&cache->init_lock);
+	rw_lock_x_unlock(&cache->lock);
 }
 
 /*******************************************************************//**
@@ -864,6 +890,10 @@ fts_drop_index(
 		remove it from optimize thread */
 		fts_optimize_remove_table(table);
 
+		/* The cache is about to be freed. */
+		fts_cache_x_lock_for_ddl(table->fts->cache);
+		rw_lock_x_unlock(&table->fts->cache->lock);
+
 		DICT_TF2_FLAG_UNSET(table, DICT_TF2_FTS);
 
 		/* If Doc ID column is not added internally by FTS index,
@@ -893,6 +923,10 @@ fts_drop_index(
 		fts_cache_t*            cache = table->fts->cache;
 		fts_index_cache_t*      index_cache;
 
+		/* Do not free the index cache while a SYNC is
+		writing it. */
+		fts_cache_x_lock_for_ddl(cache);
+
 		rw_lock_x_lock(&cache->init_lock);
 
 		index_cache = fts_find_index_cache(cache, index);
@@ -909,6 +943,7 @@ fts_drop_index(
 		}
 
 		rw_lock_x_unlock(&cache->init_lock);
+		rw_lock_x_unlock(&cache->lock);
 	}
 
 	err = fts_drop_index_tables(trx, index);
@@ -1213,6 +1248,9 @@ fts_cache_destroy(
 /*==============*/
 	fts_cache_t*	cache)			/*!< in: cache*/
 {
+	ut_ad(!cache->sync->in_progress);
+
+	os_event_free(cache->sync->event);
 	rw_lock_free(&cache->lock);
 	rw_lock_free(&cache->init_lock);
 	mutex_free(&cache->optimize_lock);
@@ -1446,6 +1484,7 @@ fts_cache_add_doc(
 		}
 
 		if (fts_node == NULL
+		    || fts_node->synced
 		    || fts_node->ilist_size > FTS_ILIST_MAX_SIZE
 		    || doc_id < fts_node->last_doc_id) {
 
@@ -3921,7 +3960,12 @@ fts_sync_add_deleted_cache(
 }
 
 /*********************************************************************//**
-Write the words and ilist to disk.
+Write the nodes of the words that have not been written by this SYNC
+yet to disk. The words and the nodes stay in the cache until the SYNC
+is committed, and the nodes are marked synced, so that no positions
+are added to them. If unlock_cache is set, the cache lock is released
+while each node is written, so that documents can be added to the
+cache meanwhile.
 @return DB_SUCCESS if all went well else error code */
 static __attribute__((nonnull, warn_unused_result))
 dberr_t
@@ -3929,8 +3973,11 @@ fts_sync_write_words(
 /*=================*/
 	trx_t*		trx,			/*!< in: transaction */
 	fts_index_cache_t*
-			index_cache)		/*!< in: index cache */
+			index_cache,		/*!< in: index cache */
+	bool		unlock_cache)		/*!< in: whether to release
+						the cache lock while writing */
 {
+	fts_cache_t*	cache = index_cache->index->table->fts->cache;
 	fts_table_t	fts_table;
 	ulint		n_nodes = 0;
 	ulint		n_words = 0;
@@ -3947,11 +3994,13 @@ fts_sync_write_words(
 
 	n_words = rbt_size(index_cache->words);
 
-	/* We iterate over the entire tree, even if there is an error,
-	since we want to free the memory used during caching. */
+	/* The words are not removed from the tree before the SYNC
+	completes, so rbt_node stays valid while the cache lock is
+	released. Words that are added to the tree meanwhile ahead of
+	rbt_node will be written by the next call. */
 	for (rbt_node = rbt_first(index_cache->words);
-	     rbt_node;
-	     rbt_node = rbt_first(index_cache->words)) {
+	     rbt_node && error == DB_SUCCESS;
+	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
 
 		ulint			i;
 		ulint			selected;
@@ -3984,25 +4033,42 @@ fts_sync_write_words(
 		}
 #endif /* FTS_DOC_STATS_DEBUG */
 
-		n_nodes += ib_vector_size(word->nodes);
-
-		/* We iterate over all the nodes even if there was an error,
-		this is to free the memory of the fts_node_t elements. */
-		for (i = 0; i < ib_vector_size(word->nodes); ++i) {
+		for (i = 0;
+		     i < ib_vector_size(word->nodes) && error == DB_SUCCESS;
+		     ++i) {
 
 			fts_node_t* fts_node = static_cast<fts_node_t*>(
 				ib_vector_get(word->nodes, i));
+			fts_node_t	node;
+			fts_string_t	text;
+
+			if (fts_node->synced) {
+				continue;
+			}
+
+			fts_node->synced = TRUE;
+
+			/* fts_cache_add_doc() does not modify a synced
+			node, but it may move the elements of word->nodes
+			when appending to it. */
+			node = *fts_node;
+			text = word->text;
 
-			if (error == DB_SUCCESS) {
+			if (unlock_cache) {
+				rw_lock_x_unlock(&cache->lock);
 
-				error = fts_write_node(
-					trx,
-					&index_cache->ins_graph[selected],
-					&fts_table, &word->text, fts_node);
+				DEBUG_SYNC_C("fts_sync_write_words_unlocked");
 			}
 
-			ut_free(fts_node->ilist);
-			fts_node->ilist = NULL;
+			error = fts_write_node(
+				trx, &index_cache->ins_graph[selected],
+				&fts_table, &text, &node);
+
+			if (unlock_cache) {
+				rw_lock_x_lock(&cache->lock);
+			}
+
+			++n_nodes;
 		}
 
 		if (error != DB_SUCCESS && !print_error) {
@@ -4013,9 +4079,6 @@ fts_sync_write_words(
 
 			print_error = TRUE;
 		}
-
-		/* NOTE: We are responsible for free'ing the node */
-		ut_free(rbt_remove_node(index_cache->words, rbt_node));
 	}
 
 #ifdef FTS_DOC_STATS_DEBUG
@@ -4280,6 +4343,7 @@ fts_sync_begin(
 	elapsed_time = 0;
 
 	sync->start_time = ut_time();
+	sync->interrupted = false;
 
 	sync->trx = trx_allocate_for_background();
 
@@ -4302,7 +4366,10 @@ dberr_t
 fts_sync_index(
 /*===========*/
 	fts_sync_t*		sync,		/*!< in: sync state */
-	fts_index_cache_t*	index_cache)	/*!< in: index cache */
+	fts_index_cache_t*	index_cache,	/*!< in: index cache */
+	bool			unlock_cache)	/*!< in: whether to release
+						the cache lock while writing
+						the nodes */
 {
 	trx_t*		trx = sync->trx;
 	dberr_t		error = DB_SUCCESS;
@@ -4316,7 +4383,7 @@ fts_sync_index(
 
 	ut_ad(rbt_validate(index_cache->words));
 
-	error = fts_sync_write_words(trx, index_cache);
+	error = fts_sync_write_words(trx, index_cache, unlock_cache);
 
 #ifdef FTS_DOC_STATS_DEBUG
 	/* FTS_RESOLVE: the word counter info in auxiliary table "DOC_ID"
@@ -4367,6 +4434,9 @@ fts_sync_commit(
 	attempt to add a deleted doc id to the cache deleted id array. */
 	fts_cache_clear(cache);
 	fts_cache_init(cache);
+
+	sync->in_progress = FALSE;
+	os_event_set(sync->event);
 	rw_lock_x_unlock(&cache->lock);
 
 	if (error == DB_SUCCESS) {
@@ -4407,12 +4477,96 @@ fts_sync_rollback(
 	trx_t*		trx = sync->trx;
 	fts_cache_t*	cache = sync->table->fts->cache;
 
+	/* The nodes that were written will be written again
+	by the next SYNC. */
+	for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+		fts_index_cache_t*	index_cache;
+		const ib_rbt_node_t*	rbt_node;
+
+		index_cache = static_cast<fts_index_cache_t*>(
+			ib_vector_get(cache->indexes, i));
+
+		for (rbt_node = rbt_first(index_cache->words);
+		     rbt_node;
+		     rbt_node = rbt_next(index_cache->words, rbt_node)) {
+
+			fts_tokenizer_word_t*	word = rbt_value(
+				fts_tokenizer_word_t, rbt_node);
+
+			for (ulint j = 0; j < ib_vector_size(word->nodes);
+			     ++j) {
+				static_cast<fts_node_t*>(
+					ib_vector_get(word->nodes, j))
+					->synced = FALSE;
+			}
+		}
+	}
+
+	sync->in_progress = FALSE;
+	os_event_set(sync->event);
 	rw_lock_x_unlock(&cache->lock);
 
 	fts_sql_rollback(trx);
 	trx_free_for_background(trx);
 }
 
+/****************************************************************//**
+Wait until no SYNC is writing the cache. The caller must hold the
+cache lock in X mode; the lock is released while waiting. */
+static
+void
+fts_sync_wait(
+/*==========*/
+	fts_cache_t*	cache)		/*!< in: cache */
+{
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(&cache->lock, RW_LOCK_EX));
+#endif /* UNIV_SYNC_DEBUG */
+
+	while (cache->sync->in_progress) {
+		rw_lock_x_unlock(&cache->lock);
+		os_event_wait(cache->sync->event);
+		rw_lock_x_lock(&cache->lock);
+	}
+}
+
+/****************************************************************//**
+Acquire the cache lock in X mode for a DDL operation that holds
+dict_sys->mutex, and wait until no SYNC is writing the cache.
+
+A SYNC acquires dict_sys->mutex in fts_parse_sql() both while it
+holds the cache lock and while it is in progress with the lock
+released, so neither the lock nor sync->event may be waited for
+while holding dict_sys->mutex. The mutex is released while waiting,
+as in dict_stats_wait_bg_to_stop_using_table(). The caller keeps
+dict_operation_lock, which a SYNC does not need. */
+static
+void
+fts_cache_x_lock_for_ddl(
+/*=====================*/
+	fts_cache_t*	cache)		/*!< in: cache */
+{
+	ut_ad(mutex_own(&dict_sys->mutex));
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(&dict_operation_lock, RW_LOCK_EX));
+#endif /* UNIV_SYNC_DEBUG */
+
+	for (;;) {
+		if (rw_lock_x_lock_nowait(&cache->lock)) {
+
+			if (!cache->sync->in_progress) {
+				return;
+			}
+
+			rw_lock_x_unlock(&cache->lock);
+		}
+
+		mutex_exit(&dict_sys->mutex);
+		os_thread_sleep(10000);
+		mutex_enter(&dict_sys->mutex);
+	}
+}
+
 /****************************************************************//**
 Run SYNC on the table, i.e., write out data from the cache to the
 FTS auxiliary INDEX table and clear the cache at the end.
@@ -4423,29 +4577,41 @@ fts_sync(
 /*=====*/
 	fts_sync_t*	sync)		/*!< in: sync state */
 {
-	ulint		i;
 	dberr_t		error = DB_SUCCESS;
 	fts_cache_t*	cache = sync->table->fts->cache;
 
 	rw_lock_x_lock(&cache->lock);
 
+	/* Let a SYNC that is writing the cache finish first. */
+	fts_sync_wait(cache);
+
 	fts_sync_begin(sync);
 
-	for (i = 0; i < ib_vector_size(cache->indexes); ++i) {
-		fts_index_cache_t*	index_cache;
+	sync->in_progress = TRUE;
+	os_event_reset(sync->event);
 
-		index_cache = static_cast<fts_index_cache_t*>(
-			ib_vector_get(cache->indexes, i));
+	/* The first pass writes the cache while letting documents be
+	added to it. The second pass holds the cache lock, and writes
+	the nodes that were added during the first one, so that the
+	SYNC cannot be held back by a steady stream of documents. */
+	for (ulint pass = 0; pass < 2 && error == DB_SUCCESS; ++pass) {
 
-		if (index_cache->index->to_be_dropped) {
-			continue;
-		}
+		for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+			fts_index_cache_t*	index_cache;
+
+			index_cache = static_cast<fts_index_cache_t*>(
+				ib_vector_get(cache->indexes, i));
 
-		error = fts_sync_index(sync, index_cache);
+			if (index_cache->index->to_be_dropped) {
+				continue;
+			}
 
-		if (error != DB_SUCCESS && !sync->interrupted) {
+			error = fts_sync_index(sync, index_cache, pass == 0);
 
-			break;
+			if (error != DB_SUCCESS && !sync->interrupted) {
+
+				break;
+			}
 		}
 	}
 
@@ -243,6 +243,10 @@ static ulint FTS_ZIP_BLOCK_SIZE	= 1024;
 /** The amount of time optimizing in a single pass, in milliseconds. */
 static ib_time_t fts_optimize_time_limit = 0;
 
+/** The number of words whose rewrite is committed in one transaction.
+Committing each word separately would flush the redo log per word. */
+static const ulint FTS_OPTIMIZE_WORDS_PER_COMMIT = 64;
+
 /** SQL Statement for changing state of rows to be deleted from FTS Index. */
 static	const char* fts_init_delete_sql =
 	"BEGIN\n"
@@ -1788,6 +1792,7 @@ fts_optimize_words(
 	ib_time_t	start_time;
 	que_t*		graph = NULL;
 	CHARSET_INFO*	charset = optim->fts_index_table.charset;
+	ulint		n_uncommitted = 0;
 
 	ut_a(!optim->done);
 
@@ -1827,10 +1832,15 @@ fts_optimize_words(
 			back to DB. */
 			error = fts_optimize_compact(optim, index, start_time);
 
-			if (error == DB_SUCCESS) {
-				fts_sql_commit(optim->trx);
-			} else {
+			if (error != DB_SUCCESS) {
+				/* This rolls back the last optimized
+				word in the config table as well. */
 				fts_sql_rollback(optim->trx);
+				n_uncommitted = 0;
+			} else if (++n_uncommitted
+				   >= FTS_OPTIMIZE_WORDS_PER_COMMIT) {
+				fts_sql_commit(optim->trx);
+				n_uncommitted = 0;
 			}
 		}
 
@@ -1864,6 +1874,10 @@ fts_optimize_words(
 		}
 	}
 
+	if (n_uncommitted > 0) {
+		fts_sql_commit(optim->trx);
+	}
+
 	if (graph != NULL) {
 		fts_que_graph_free(graph);
 	}
@@ -282,6 +282,68 @@ hash_unlock_x_all_but(
 	}
 }
 
+/************************************************************//**
+Makes sure that the s-latched lock still protects a fold value after
+the cell array of the hash table may have been replaced while the
+lock was being waited for. If it does not, the lock is released and
+the lock that now protects the fold is s-latched instead.
+@return	s-latched lock protecting the fold */
+UNIV_INTERN
+rw_lock_t*
+hash_lock_s_confirm(
+/*================*/
+	rw_lock_t*	hash_lock,	/*!< in: s-latched lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold)		/*!< in: fold */
+{
+	rw_lock_t*	lock = hash_get_lock(table, fold);
+
+	ut_ad(table->type == HASH_TABLE_SYNC_RW_LOCK);
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(hash_lock, RW_LOCK_SHARED));
+#endif /* UNIV_SYNC_DEBUG */
+
+	while (lock != hash_lock) {
+		rw_lock_s_unlock(hash_lock);
+		hash_lock = lock;
+		rw_lock_s_lock(hash_lock);
+		lock = hash_get_lock(table, fold);
+	}
+
+	return(hash_lock);
+}
+
+/************************************************************//**
+Makes sure that the x-latched lock still protects a fold value after
+the cell array of the hash table may have been replaced while the
+lock was being waited for. If it does not, the lock is released and
+the lock that now protects the fold is x-latched instead.
+@return	x-latched lock protecting the fold */
+UNIV_INTERN
+rw_lock_t*
+hash_lock_x_confirm(
+/*================*/
+	rw_lock_t*	hash_lock,	/*!< in: x-latched lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold)		/*!< in: fold */
+{
+	rw_lock_t*	lock = hash_get_lock(table, fold);
+
+	ut_ad(table->type == HASH_TABLE_SYNC_RW_LOCK);
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(rw_lock_own(hash_lock, RW_LOCK_EX));
+#endif /* UNIV_SYNC_DEBUG */
+
+	while (lock != hash_lock) {
+		rw_lock_x_unlock(hash_lock);
+		hash_lock = lock;
+		rw_lock_x_lock(hash_lock);
+		lock = hash_get_lock(table, fold);
+	}
+
+	return(hash_lock);
+}
+
 #endif /* !UNIV_HOTBACKUP */
 
 /*************************************************************//**
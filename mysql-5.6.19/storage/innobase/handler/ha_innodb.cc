@@ -74,6 +74,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "fil0fil.h"
 #include "trx0xa.h"
 #include "row0merge.h"
+#include "row0pread.h"
 #include "dict0boot.h"
 #include "dict0stats.h"
 #include "dict0stats_bg.h"
@@ -187,6 +188,7 @@ static my_bool	innobase_log_archive			= FALSE;
 static char*	innobase_log_arch_dir			= NULL;
 #endif /* UNIV_LOG_ARCHIVE */
 static my_bool	innobase_use_doublewrite		= TRUE;
+static my_bool	innobase_use_transparent_huge_pages	= FALSE;
 static my_bool	innobase_use_checksums			= TRUE;
 static my_bool	innobase_locks_unsafe_for_binlog	= FALSE;
 static my_bool	innobase_rollback_on_timeout		= FALSE;
@@ -342,6 +344,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	{&sync_thread_mutex_key, "sync_thread_mutex", 0},
 #  endif /* UNIV_SYNC_DEBUG */
 	{&buf_dblwr_mutex_key, "buf_dblwr_mutex", 0},
+	{&buf_dblwr_file_mutex_key, "buf_dblwr_file_mutex", 0},
 	{&trx_undo_mutex_key, "trx_undo_mutex", 0},
 	{&srv_sys_mutex_key, "srv_sys_mutex", 0},
 	{&lock_sys_mutex_key, "lock_mutex", 0},
@@ -407,7 +410,13 @@ static PSI_thread_info	all_innodb_threads[] = {
 	{&srv_master_thread_key, "srv_master_thread", 0},
 	{&srv_purge_thread_key, "srv_purge_thread", 0},
 	{&buf_page_cleaner_thread_key, "page_cleaner_thread", 0},
-	{&recv_writer_thread_key, "recv_writer_thread", 0}
+	{&recv_writer_thread_key, "recv_writer_thread", 0},
+	{&recv_apply_thread_key, "recv_apply_thread", 0},
+	{&row_merge_thread_key, "row_merge_thread", 0},
+	{&row_pread_thread_key, "parallel_read_thread", 0},
+	{&row_log_apply_thread_key, "row_log_apply_thread", 0},
+	{&fil_load_thread_key, "tablespace_load_thread", 0},
+	{&dict_stats_worker_thread_key, "dict_stats_worker_thread", 0}
 };
 # endif /* UNIV_PFS_THREAD */
 
@@ -420,6 +429,17 @@ static PSI_file_info	all_innodb_files[] = {
 	{&innodb_file_temp_key, "innodb_temp_file", 0}
 };
 # endif /* UNIV_PFS_IO */
+
+# ifdef HAVE_PSI_STAGE_INTERFACE
+/* all_innodb_stages array contains the stages of index creation that
+are reported to performance schema */
+static PSI_stage_info*	all_innodb_stages[] = {
+	&row_merge_stage_read,
+	&row_merge_stage_merge_sort,
+	&row_merge_stage_insert,
+	&row_merge_stage_log_apply
+};
+# endif /* HAVE_PSI_STAGE_INTERFACE */
 #endif /* HAVE_PSI_INTERFACE */
 
 /** Always normalize table name to lower case on Windows */
@@ -540,6 +560,12 @@ static MYSQL_THDVAR_BOOL(strict_mode, PLUGIN_VAR_OPCMDARG,
   "Use strict mode when evaluating create options.",
   NULL, NULL, FALSE);
 
+static MYSQL_THDVAR_BOOL(page_compression, PLUGIN_VAR_OPCMDARG,
+  "Compress the pages of tables created in their own tablespace by this "
+  "session when they are written to disk, punching holes for the unused "
+  "tail of each page. Ignored for ROW_FORMAT=COMPRESSED.",
+  NULL, NULL, FALSE);
+
 static MYSQL_THDVAR_BOOL(ft_enable_stopword, PLUGIN_VAR_OPCMDARG,
   "Create FTS index with stopword.",
   NULL, NULL,
@@ -559,6 +585,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_buffer_pool_dump_status,	  SHOW_CHAR},
   {"buffer_pool_load_status",
   (char*) &export_vars.innodb_buffer_pool_load_status,	  SHOW_CHAR},
+  {"buffer_pool_resize_status",
+  (char*) &export_vars.innodb_buffer_pool_resize_status,  SHOW_CHAR},
   {"buffer_pool_pages_data",
   (char*) &export_vars.innodb_buffer_pool_pages_data,	  SHOW_LONG},
   {"buffer_pool_bytes_data",
@@ -2305,7 +2333,8 @@ ha_innobase::ha_innobase(
 		  HA_BINLOG_ROW_CAPABLE |
 		  HA_CAN_GEOMETRY | HA_PARTIAL_COLUMN_READ |
 		  HA_TABLE_SCAN_ON_INDEX | HA_CAN_FULLTEXT |
-		  HA_CAN_FULLTEXT_EXT | HA_CAN_EXPORT),
+		  HA_CAN_FULLTEXT_EXT | HA_CAN_EXPORT |
+		  HA_HAS_RECORDS),
 	start_of_scan(0),
 	num_write_row(0)
 {}
@@ -3265,6 +3294,8 @@ innobase_change_buffering_inited_ok:
 		os_large_page_size = (ulint) opt_large_page_size;
 	}
 #endif
+	os_use_transparent_huge_pages
+		= (ibool) innobase_use_transparent_huge_pages;
 
 	row_rollback_on_timeout = (ibool) innobase_rollback_on_timeout;
 
@@ -3346,6 +3377,11 @@ innobase_change_buffering_inited_ok:
 	mysql_file_register("innodb", all_innodb_files, count);
 # endif /* UNIV_PFS_IO */
 
+# ifdef HAVE_PSI_STAGE_INTERFACE
+	count = array_elements(all_innodb_stages);
+	mysql_stage_register("innodb", all_innodb_stages, count);
+# endif /* HAVE_PSI_STAGE_INTERFACE */
+
 	count = array_elements(all_innodb_conds);
 	mysql_cond_register("innodb", all_innodb_conds, count);
 #endif /* HAVE_PSI_INTERFACE */
@@ -9521,6 +9557,10 @@ index_bad:
 
 	if (use_tablespace) {
 		*flags2 |= DICT_TF2_USE_TABLESPACE;
+
+		if (!zip_ssize && THDVAR(thd, page_compression)) {
+			*flags2 |= DICT_TF2_PAGE_COMPRESSED;
+		}
 	}
 
 	/* Set the flags2 when create table or alter tables */
@@ -9966,6 +10006,18 @@ ha_innobase::discard_or_import_tablespace(
 			ER_TABLESPACE_EXISTS, table->s->table_name.str);
 
 		DBUG_RETURN(HA_ERR_TABLE_EXIST);
+	} else if (DICT_TF2_FLAG_IS_SET(dict_table, DICT_TF2_INSTANT)) {
+		/* The records of the imported tablespace would not
+		match the instantly added columns of the table. */
+		trx_commit_for_mysql(prebuilt->trx);
+
+		ib_senderrf(
+			prebuilt->trx->mysql_thd, IB_LOG_LEVEL_ERROR,
+			ER_NOT_SUPPORTED_YET,
+			"IMPORT TABLESPACE on a table to which columns"
+			" were added instantly; rebuild the table first");
+
+		DBUG_RETURN(HA_ERR_UNSUPPORTED);
 	} else {
 		err = row_import_for_mysql(dict_table, prebuilt);
 
@@ -10565,6 +10617,69 @@ func_exit:
 	DBUG_RETURN((ha_rows) n_rows);
 }
 
+/*********************************************************************//**
+Counts the rows of the table that are visible to the current consistent
+read, by scanning the clustered index with innodb_parallel_read_threads
+threads. This is used for SELECT COUNT(*) without a WHERE condition.
+The rows are not counted for EXPLAIN, which would otherwise scan the
+whole table only to show the plan.
+@return	number of rows, or HA_POS_ERROR if the rows must be counted by
+scanning the table */
+UNIV_INTERN
+ha_rows
+ha_innobase::records()
+/*==================*/
+{
+	dict_index_t*	index;
+	ulint		n_rows;
+	dberr_t		err;
+
+	DBUG_ENTER("ha_innobase::records");
+
+	update_thd(ha_thd());
+
+	/* EXPLAIN keeps the COUNT(*) in the plan. Locking reads and
+	READ UNCOMMITTED do not use a read view. */
+	if (thd_is_explain(ha_thd())
+	    || prebuilt->select_lock_type != LOCK_NONE
+	    || prebuilt->trx->isolation_level == TRX_ISO_READ_UNCOMMITTED
+	    || dict_table_is_discarded(prebuilt->table)
+	    || prebuilt->table->ibd_file_missing
+	    || prebuilt->table->corrupted) {
+
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	index = dict_table_get_first_index(prebuilt->table);
+
+	if (dict_index_is_corrupted(index)
+	    || !row_merge_is_index_usable(prebuilt->trx, index)) {
+
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	prebuilt->trx->op_info = "counting records";
+
+	trx_search_latch_release_if_reserved(prebuilt->trx);
+
+	innobase_srv_conc_enter_innodb(prebuilt->trx);
+
+	trx_start_if_not_started(prebuilt->trx);
+	trx_assign_read_view(prebuilt->trx);
+
+	err = row_pread_count(prebuilt->trx, index, false, &n_rows);
+
+	innobase_srv_conc_exit_innodb(prebuilt->trx);
+
+	prebuilt->trx->op_info = "";
+
+	if (err != DB_SUCCESS) {
+		DBUG_RETURN(HA_POS_ERROR);
+	}
+
+	DBUG_RETURN((ha_rows) n_rows);
+}
+
 /*********************************************************************//**
 Gives an UPPER BOUND to the number of rows in a table. This is used in
 filesort.cc.
@@ -11474,7 +11589,25 @@ ha_innobase::check(
 
 		prebuilt->select_lock_type = LOCK_NONE;
 
-		if (!row_check_index_for_mysql(prebuilt, index, &n_rows)) {
+		bool	index_ok;
+
+		if (dict_index_is_clust(index)) {
+			/* Count and check the clustered index with
+			innodb_parallel_read_threads threads. Other
+			errors than corruption are ignored, as in
+			row_check_index_for_mysql(). */
+			trx_start_if_not_started(prebuilt->trx);
+			trx_assign_read_view(prebuilt->trx);
+
+			index_ok = row_pread_count(
+				prebuilt->trx, index, true, &n_rows)
+				!= DB_CORRUPTION;
+		} else {
+			index_ok = row_check_index_for_mysql(
+				prebuilt, index, &n_rows);
+		}
+
+		if (!index_ok) {
 			innobase_format_name(
 				index_name, sizeof index_name,
 				index->name, TRUE);
@@ -13979,6 +14112,56 @@ innodb_io_capacity_update(
 	srv_io_capacity = in_val;
 }
 
+/****************************************************************//**
+Update the system variable innodb_buffer_pool_size using the "saved"
+value and wake up the buffer pool resize thread. The size is rounded
+up to a multiple of innodb_buffer_pool_chunk_size times
+innodb_buffer_pool_instances. This function is registered as a callback
+with MySQL. */
+static
+void
+innodb_buffer_pool_size_update(
+/*===========================*/
+	THD*				thd,	/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,	/*!< in: pointer to
+						system variable */
+	void*				var_ptr,/*!< out: where the
+						formal string goes */
+	const void*			save)	/*!< in: immediate result
+						from check function */
+{
+	long long	in_val = *static_cast<const long long*>(save);
+	long long	unit = static_cast<long long>(srv_buf_pool_chunk_unit)
+		* static_cast<long long>(srv_buf_pool_instances);
+
+	if (srv_read_only_mode) {
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "innodb_buffer_pool_size cannot be"
+				    " changed in read-only mode.");
+		return;
+	}
+
+	if (in_val == innobase_buffer_pool_size) {
+		return;
+	}
+
+	if (in_val % unit != 0) {
+		in_val = (in_val / unit + 1) * unit;
+		push_warning_printf(thd, Sql_condition::WARN_LEVEL_WARN,
+				    ER_WRONG_ARGUMENTS,
+				    "Setting innodb_buffer_pool_size to %lld,"
+				    " a multiple of innodb_buffer_pool_chunk_size"
+				    " * innodb_buffer_pool_instances",
+				    in_val);
+	}
+
+	innobase_buffer_pool_size = in_val;
+	srv_buf_pool_size = static_cast<ulint>(in_val);
+
+	os_event_set(srv_buf_resize_event);
+}
+
 /****************************************************************//**
 Update the system variable innodb_max_dirty_pages_pct using the "saved"
 value. This function is registered as a callback with MySQL. */
@@ -15925,6 +16108,32 @@ buffer_pool_load_abort(
 	}
 }
 
+/****************************************************************//**
+Update innodb_buffer_pool_dump_interval and wake up the buffer pool
+dump/load thread, so that it starts waiting with the new interval.
+This function is registered as a callback with MySQL. */
+static
+void
+innodb_buffer_pool_dump_interval_update(
+/*====================================*/
+	THD*				thd	/*!< in: thread handle */
+					__attribute__((unused)),
+	struct st_mysql_sys_var*	var	/*!< in: pointer to system
+						variable */
+					__attribute__((unused)),
+	void*				var_ptr	/*!< out: where the formal
+						string goes */
+					__attribute__((unused)),
+	const void*			save)	/*!< in: immediate result from
+						check function */
+{
+	srv_buf_dump_interval = *static_cast<const ulong*>(save);
+
+	if (!srv_read_only_mode) {
+		os_event_set(srv_buf_dump_event);
+	}
+}
+
 /** Update innodb_status_output or innodb_status_output_locks,
 which control InnoDB "status monitor" output to the error log.
 @param[in]	thd	thread handle
@@ -15998,6 +16207,13 @@ static MYSQL_SYSVAR_BOOL(doublewrite, innobase_use_doublewrite,
   "Disable with --skip-innodb-doublewrite.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(doublewrite_files, srv_dblwr_files,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Write the LRU and flush list batches of every buffer pool instance "
+  "through separate doublewrite files ib_dblwr_N in the data home "
+  "directory instead of the doublewrite buffer in the system tablespace.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_ULONG(io_capacity, srv_io_capacity,
   PLUGIN_VAR_RQCMDARG,
   "Number of IOPs the server can do. Tunes the background IO rate",
@@ -16038,7 +16254,23 @@ static MYSQL_SYSVAR_ULONG(purge_batch_size, srv_purge_batch_size,
   NULL, NULL,
   300,			/* Default setting */
   1,			/* Minimum value */
-  5000, 0);		/* Maximum value */
+  SRV_PURGE_MAX_BATCH_SIZE, 0);	/* Maximum value */
+
+static MYSQL_SYSVAR_BOOL(undo_log_truncate, srv_undo_log_truncate,
+  PLUGIN_VAR_OPCMDARG,
+  "Truncate an undo tablespace that has grown beyond"
+  " innodb_max_undo_log_size once purge has drained it."
+  " Requires at least two undo tablespaces.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_ULONGLONG(max_undo_log_size, srv_max_undo_log_size,
+  PLUGIN_VAR_OPCMDARG,
+  "Size in bytes beyond which an undo tablespace is marked for"
+  " truncation when innodb_undo_log_truncate is enabled.",
+  NULL, NULL,
+  1024 * 1024 * 1024ULL,	/* Default setting */
+  10 * 1024 * 1024ULL,		/* Minimum value */
+  ~0ULL, 0);			/* Maximum value */
 
 static MYSQL_SYSVAR_ULONG(purge_threads, srv_n_purge_threads,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
@@ -16046,7 +16278,16 @@ static MYSQL_SYSVAR_ULONG(purge_threads, srv_n_purge_threads,
   NULL, NULL,
   1,			/* Default setting */
   1,			/* Minimum value */
-  32, 0);		/* Maximum value */
+  SRV_MAX_N_PURGE_THREADS, 0);	/* Maximum value */
+
+static MYSQL_SYSVAR_ULONG(recovery_apply_threads, srv_n_recv_apply_threads,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads applying redo log records to pages during crash"
+  " recovery, from 1 to 64. Default is 4.",
+  NULL, NULL,
+  4,			/* Default setting */
+  1,			/* Minimum value */
+  64, 0);		/* Maximum value */
 
 static MYSQL_SYSVAR_ULONG(sync_array_size, srv_sync_array_size,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
@@ -16236,6 +16477,12 @@ static MYSQL_SYSVAR_BOOL(stats_auto_recalc, srv_stats_auto_recalc,
   "new statistics)",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(stats_threads, srv_stats_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that recalculate persistent statistics in the"
+  " background, and that analyze the indexes of a table in parallel",
+  NULL, NULL, 4, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONGLONG(stats_persistent_sample_pages,
   srv_stats_persistent_sample_pages,
   PLUGIN_VAR_RQCMDARG,
@@ -16284,9 +16531,33 @@ static MYSQL_SYSVAR_ULONG(autoextend_increment, srv_auto_extend_increment,
   NULL, NULL, 64L, 1L, 1000L, 0);
 
 static MYSQL_SYSVAR_LONGLONG(buffer_pool_size, innobase_buffer_pool_size,
+  PLUGIN_VAR_RQCMDARG,
+  "The size of the memory buffer InnoDB uses to cache data and indexes of its tables."
+  " It can be changed at run time; the buffer pool is then resized in the background,"
+  " see innodb_buffer_pool_resize_status.",
+  NULL, innodb_buffer_pool_size_update,
+  128*1024*1024L, 5*1024*1024L, LONGLONG_MAX, 1024*1024L);
+
+static MYSQL_SYSVAR_ULONG(buffer_pool_chunk_size, srv_buf_pool_chunk_unit,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
-  "The size of the memory buffer InnoDB uses to cache data and indexes of its tables.",
-  NULL, NULL, 128*1024*1024L, 5*1024*1024L, LONGLONG_MAX, 1024*1024L);
+  "Size of the chunks that the buffer pool instances are allocated in,"
+  " which is the unit of online resizing. Reduced at startup so that"
+  " every instance has at least one chunk.",
+  NULL, NULL, 128 * 1024 * 1024, 1024 * 1024, ULONG_MAX, 1024 * 1024);
+
+static MYSQL_SYSVAR_BOOL(buffer_pool_numa, srv_buf_pool_numa,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Bind the memory of every buffer pool instance to a NUMA node, assigning"
+  " the instances to the nodes in turn. Has no effect on a machine with a"
+  " single node.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_BOOL(transparent_huge_pages,
+  innobase_use_transparent_huge_pages,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Ask the kernel to back the buffer pool with transparent huge pages."
+  " Only used when --large-pages is not in effect.",
+  NULL, NULL, FALSE);
 
 #if defined UNIV_DEBUG || defined UNIV_PERF_DEBUG
 static MYSQL_SYSVAR_ULONG(page_hash_locks, srv_n_page_hash_locks,
@@ -16320,6 +16591,11 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_dump_at_shutdown, srv_buffer_pool_dump_at_s
   "Dump the buffer pool into a file named @@innodb_buffer_pool_filename",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_dump_interval, srv_buf_dump_interval,
+  PLUGIN_VAR_RQCMDARG,
+  "Refresh the dump of the buffer pool in @@innodb_buffer_pool_filename every this many seconds if the buffer pool has changed. 0 (the default) disables the periodic dump.",
+  NULL, innodb_buffer_pool_dump_interval_update, 0, 0, 86400, 0);
+
 #ifdef UNIV_DEBUG
 static MYSQL_SYSVAR_STR(buffer_pool_evict, srv_buffer_pool_evict,
   PLUGIN_VAR_RQCMDARG,
@@ -16428,11 +16704,36 @@ static MYSQL_SYSVAR_ULONG(sort_buffer_size, srv_sort_buf_size,
   "Memory buffer size for index creation",
   NULL, NULL, 1048576, 65536, 64<<20, 0);
 
+static MYSQL_SYSVAR_ULONG(sort_threads, srv_sort_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that merge sort and insert the entries of the indexes"
+  " being created, each using 3 * innodb_sort_buffer_size of memory",
+  NULL, NULL, 4, 1, 64, 0);
+
+static MYSQL_SYSVAR_ULONG(fill_factor, srv_fill_factor,
+  PLUGIN_VAR_RQCMDARG,
+  "Percentage of each B-tree page to fill during index creation;"
+  " the rest is left free for future growth",
+  NULL, NULL, 100, 10, 100, 0);
+
+static MYSQL_SYSVAR_ULONG(parallel_read_threads, srv_parallel_read_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that scan the clustered index in parallel"
+  " for SELECT COUNT(*) and CHECK TABLE",
+  NULL, NULL, 4, 1, 256, 0);
+
 static MYSQL_SYSVAR_ULONGLONG(online_alter_log_max_size, srv_online_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum modification log file size for online index creation",
   NULL, NULL, 128<<20, 65536, ~0ULL, 0);
 
+static MYSQL_SYSVAR_ULONG(online_alter_apply_threads,
+  srv_online_alter_apply_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that apply the modification log of a table being"
+  " rebuilt online, partitioned by PRIMARY KEY",
+  NULL, NULL, 4, 1, 64, 0);
+
 static MYSQL_SYSVAR_BOOL(optimize_fulltext_only, innodb_optimize_fulltext_only,
   PLUGIN_VAR_NOCMDARG,
   "Only optimize the Fulltext index of the table",
@@ -16603,6 +16904,12 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(use_io_uring, srv_use_io_uring,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Use io_uring instead of libaio for native AIO on Linux if the kernel "
+  "supports it.",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_BOOL(api_enable_binlog, ib_binlog_enabled,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "Enable binlog for applications direct access InnoDB through InnoDB APIs",
@@ -16765,6 +17072,19 @@ static MYSQL_SYSVAR_UINT(change_buffer_max_size,
   NULL, innodb_change_buffer_max_size_update,
   CHANGE_BUFFER_DEFAULT_SIZE, 0, 50, 0);
 
+static MYSQL_SYSVAR_ULONG(change_buffer_merge_io_pct, srv_ibuf_merge_io_pct,
+  PLUGIN_VAR_RQCMDARG,
+  "Percentage of innodb_io_capacity that the background change buffer"
+  " merge reads per second while the change buffer is less than half"
+  " full.",
+  NULL, NULL, 5, 1, 100, 0);
+
+static MYSQL_SYSVAR_ULONG(change_buffer_merge_batch, srv_ibuf_merge_batch,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of pages read in key order by one background change"
+  " buffer merge batch.",
+  NULL, NULL, 64, 8, 256, 0);
+
 static MYSQL_SYSVAR_ENUM(stats_method, srv_innodb_stats_method,
    PLUGIN_VAR_RQCMDARG,
   "Specifies how InnoDB index statistics collection code should "
@@ -16917,10 +17237,14 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(api_bk_commit_interval),
   MYSQL_SYSVAR(autoextend_increment),
   MYSQL_SYSVAR(buffer_pool_size),
+  MYSQL_SYSVAR(buffer_pool_chunk_size),
+  MYSQL_SYSVAR(buffer_pool_numa),
+  MYSQL_SYSVAR(transparent_huge_pages),
   MYSQL_SYSVAR(buffer_pool_instances),
   MYSQL_SYSVAR(buffer_pool_filename),
   MYSQL_SYSVAR(buffer_pool_dump_now),
   MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
+  MYSQL_SYSVAR(buffer_pool_dump_interval),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(buffer_pool_evict),
 #endif /* UNIV_DEBUG */
@@ -16934,9 +17258,11 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(commit_concurrency),
   MYSQL_SYSVAR(concurrency_tickets),
   MYSQL_SYSVAR(compression_level),
+  MYSQL_SYSVAR(page_compression),
   MYSQL_SYSVAR(data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(doublewrite_files),
   MYSQL_SYSVAR(api_enable_binlog),
   MYSQL_SYSVAR(api_enable_mdl),
   MYSQL_SYSVAR(api_disable_rowlock),
@@ -17002,6 +17328,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(stats_persistent),
   MYSQL_SYSVAR(stats_persistent_sample_pages),
   MYSQL_SYSVAR(stats_auto_recalc),
+  MYSQL_SYSVAR(stats_threads),
   MYSQL_SYSVAR(adaptive_hash_index),
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(replication_delay),
@@ -17009,7 +17336,11 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(strict_mode),
   MYSQL_SYSVAR(support_xa),
   MYSQL_SYSVAR(sort_buffer_size),
+  MYSQL_SYSVAR(sort_threads),
+  MYSQL_SYSVAR(fill_factor),
+  MYSQL_SYSVAR(parallel_read_threads),
   MYSQL_SYSVAR(online_alter_log_max_size),
+  MYSQL_SYSVAR(online_alter_apply_threads),
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
   MYSQL_SYSVAR(table_locks),
@@ -17022,8 +17353,11 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_sys_malloc),
   MYSQL_SYSVAR(use_native_aio),
+  MYSQL_SYSVAR(use_io_uring),
   MYSQL_SYSVAR(change_buffering),
   MYSQL_SYSVAR(change_buffer_max_size),
+  MYSQL_SYSVAR(change_buffer_merge_io_pct),
+  MYSQL_SYSVAR(change_buffer_merge_batch),
 #if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
   MYSQL_SYSVAR(change_buffering_debug),
   MYSQL_SYSVAR(disable_background_merge),
@@ -17038,7 +17372,10 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(monitor_reset),
   MYSQL_SYSVAR(monitor_reset_all),
   MYSQL_SYSVAR(purge_threads),
+  MYSQL_SYSVAR(recovery_apply_threads),
   MYSQL_SYSVAR(purge_batch_size),
+  MYSQL_SYSVAR(undo_log_truncate),
+  MYSQL_SYSVAR(max_undo_log_size),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(purge_run_now),
   MYSQL_SYSVAR(purge_stop_now),
@@ -173,6 +173,7 @@ class ha_innobase: public handler
 	ha_rows records_in_range(uint inx, key_range *min_key, key_range
 								*max_key);
 	ha_rows estimate_rows_upper_bound();
+	ha_rows records();
 
 	void update_create_info(HA_CREATE_INFO* create_info);
 	int parse_table_name(const char*name,
@@ -445,6 +446,12 @@ __attribute__((nonnull));
 */
 bool thd_is_strict_mode(const MYSQL_THD thd)
 __attribute__((nonnull));
+
+/** Is the statement being explained.
+@param thd	Thread object
+@return True if the statement is EXPLAIN, false otherwise. */
+bool thd_is_explain(const MYSQL_THD thd)
+__attribute__((nonnull));
 } /* extern "C" */
 
 struct trx_t;
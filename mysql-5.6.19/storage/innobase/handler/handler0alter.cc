@@ -210,6 +210,72 @@ innobase_need_rebuild(
 	return(!!(ha_alter_info->handler_flags & INNOBASE_ALTER_REBUILD));
 }
 
+/*******************************************************************//**
+Determine if ALTER TABLE can add columns instantly, by only updating
+the data dictionary. This is possible when columns are only appended
+to a ROW_FORMAT=COMPACT or ROW_FORMAT=DYNAMIC table, and the records
+that lack the columns can take the default values of the columns.
+@param ha_alter_info		the DDL operation
+@param altered_table		MySQL table that is being altered
+@param table			InnoDB table as it is before the ALTER
+@return whether the columns can be added instantly */
+static __attribute__((nonnull, warn_unused_result))
+bool
+innobase_instant_add_column_possible(
+/*=================================*/
+	const Alter_inplace_info*	ha_alter_info,
+	const TABLE*			altered_table,
+	const dict_table_t*		table)
+{
+	/* ALTER_COLUMN_ORDER would be set for ADD COLUMN
+	with FIRST or AFTER. */
+	if ((ha_alter_info->handler_flags & ~INNOBASE_INPLACE_IGNORE)
+	    != Alter_inplace_info::ADD_COLUMN) {
+		return(false);
+	}
+
+	if (!dict_table_is_comp(table)
+	    || dict_table_zip_size(table)
+	    || table->ibd_file_missing
+	    || dict_table_is_discarded(table)
+	    || table->fts
+	    || DICT_TF2_FLAG_IS_SET(table, DICT_TF2_FTS_HAS_DOC_ID)
+	    || innobase_fulltext_exist(altered_table)) {
+		return(false);
+	}
+
+	const ulint	n_old = dict_table_get_n_user_cols(table);
+
+	if (altered_table->s->fields <= n_old) {
+		return(false);
+	}
+
+	for (uint i = n_old; i < altered_table->s->fields; i++) {
+		Field*	field = altered_table->field[i];
+
+		if ((field->flags & AUTO_INCREMENT_FLAG)
+		    || field->has_insert_default_function()) {
+			/* The value would differ from row to row. */
+			return(false);
+		}
+
+		/* Keep the default values short, so that they
+		can be copied to a record without storing
+		anything off-page. */
+		if (!field->is_real_null()
+		    && field->data_length() >= DICT_MAX_FIXED_COL_LEN) {
+			return(false);
+		}
+	}
+
+	mutex_enter(&dict_sys->mutex);
+	const bool	have_defaults
+		= dict_table_get_low("SYS_COLUMN_DEFAULTS") != NULL;
+	mutex_exit(&dict_sys->mutex);
+
+	return(have_defaults);
+}
+
 /** Check if InnoDB supports a particular alter table in-place
 @param altered_table	TABLE object for new version of table.
 @param ha_alter_info	Structure describing changes to be done
@@ -285,6 +351,13 @@ ha_innobase::check_if_supported_inplace_alter(
 		DBUG_RETURN(HA_ALTER_INPLACE_NO_LOCK);
 	}
 
+	if (innobase_instant_add_column_possible(
+		    ha_alter_info, altered_table, prebuilt->table)) {
+		/* Only the data dictionary will be modified, in
+		commit_inplace_alter_table(). */
+		DBUG_RETURN(HA_ALTER_INPLACE_NO_LOCK);
+	}
+
 	/* Only support NULL -> NOT NULL change if strict table sql_mode
 	is set. Fall back to COPY for conversion if not strict tables.
 	In-Place will fail with an error when trying to convert
@@ -1999,6 +2072,12 @@ struct ha_innobase_inplace_ctx : public inplace_alter_handler_ctx
 	const ulint	add_autoinc;
 	/** default values of ADD COLUMN, or NULL */
 	const dtuple_t*	add_cols;
+	/** number of columns added by instant ADD COLUMN, or 0 */
+	ulint		n_instant_cols;
+	/** columns added by instant ADD COLUMN, with default values */
+	dict_col_t*	instant_cols;
+	/** names of the columns added by instant ADD COLUMN */
+	const char**	instant_col_names;
 	/** autoinc sequence to use */
 	ib_sequence_t	sequence;
 	/** maximum auto-increment value */
@@ -2032,6 +2111,7 @@ struct ha_innobase_inplace_ctx : public inplace_alter_handler_ctx
 		col_map (0), col_names (col_names_arg),
 		add_autoinc (add_autoinc_arg),
 		add_cols (0),
+		n_instant_cols (0), instant_cols (0), instant_col_names (0),
 		sequence(prebuilt->trx->mysql_thd,
 			 autoinc_col_min_value_arg, autoinc_col_max_value_arg),
 		max_autoinc (0),
@@ -2338,6 +2418,152 @@ innobase_build_col_map_add(
 		dfield, buf, TRUE, field->ptr, size, comp);
 }
 
+/** Determine the InnoDB data type of a column.
+
+@param field	MySQL column
+@param mtype	InnoDB main type
+@param prtype	InnoDB precise type
+@param len	maximum length of the column in bytes
+@retval 0 if the column can be stored in InnoDB
+@retval ER_WRONG_KEY_COLUMN if the collation is not supported
+@retval ER_WRONG_COLUMN_NAME if the name is reserved for InnoDB */
+static __attribute__((nonnull, warn_unused_result))
+int
+innobase_get_col_type(
+/*==================*/
+	const Field*	field,
+	ulint*		mtype,
+	ulint*		prtype,
+	ulint*		len)
+{
+	ulint		is_unsigned;
+	ulint		field_type	= (ulint) field->type();
+	ulint		charset_no;
+
+	*mtype = get_innobase_type_from_mysql_type(&is_unsigned, field);
+
+	/* we assume in dtype_form_prtype() that this
+	fits in two bytes */
+	ut_a(field_type <= MAX_CHAR_COLL_NUM);
+
+	if (!field->real_maybe_null()) {
+		field_type |= DATA_NOT_NULL;
+	}
+
+	if (field->binary()) {
+		field_type |= DATA_BINARY_TYPE;
+	}
+
+	if (is_unsigned) {
+		field_type |= DATA_UNSIGNED;
+	}
+
+	if (dtype_is_string_type(*mtype)) {
+		charset_no = (ulint) field->charset()->number;
+
+		if (charset_no > MAX_CHAR_COLL_NUM) {
+			return(ER_WRONG_KEY_COLUMN);
+		}
+	} else {
+		charset_no = 0;
+	}
+
+	*len = field->pack_length();
+
+	/* The MySQL pack length contains 1 or 2 bytes
+	length field for a true VARCHAR. Let us
+	subtract that, so that the InnoDB column
+	length in the InnoDB data dictionary is the
+	real maximum byte length of the actual data. */
+
+	if (field->type() == MYSQL_TYPE_VARCHAR) {
+		uint32	length_bytes
+			= static_cast<const Field_varstring*>(
+				field)->length_bytes;
+
+		*len -= length_bytes;
+
+		if (length_bytes == 2) {
+			field_type |= DATA_LONG_TRUE_VARCHAR;
+		}
+	}
+
+	if (dict_col_name_is_reserved(field->field_name)) {
+		return(ER_WRONG_COLUMN_NAME);
+	}
+
+	*prtype = dtype_form_prtype(field_type, charset_no);
+
+	return(0);
+}
+
+/** Prepare instant ADD COLUMN by determining the data types and
+the default values of the added columns.
+
+@param ctx		In-place ALTER TABLE context
+@param altered_table	MySQL table that is being altered
+@param table_name	Table name in MySQL
+@retval true		Failure (my_error() was called)
+@retval false		Success */
+static __attribute__((nonnull, warn_unused_result))
+bool
+innobase_instant_add_column_prepare(
+/*================================*/
+	ha_innobase_inplace_ctx*ctx,
+	const TABLE*		altered_table,
+	const char*		table_name)
+{
+	const dict_table_t*	table	= ctx->new_table;
+	const ulint		n_old	= dict_table_get_n_user_cols(table);
+	const ulint		n_add	= altered_table->s->fields - n_old;
+
+	DBUG_ASSERT(!ctx->need_rebuild());
+	DBUG_ASSERT(altered_table->s->fields > n_old);
+
+	ctx->instant_cols = static_cast<dict_col_t*>(
+		mem_heap_zalloc(ctx->heap, n_add * sizeof *ctx->instant_cols));
+	ctx->instant_col_names = static_cast<const char**>(
+		mem_heap_alloc(ctx->heap,
+			       n_add * sizeof *ctx->instant_col_names));
+
+	for (ulint i = 0; i < n_add; i++) {
+		const Field*	field	= altered_table->field[n_old + i];
+		dict_col_t*	col	= &ctx->instant_cols[i];
+		dfield_t	dfield;
+		ulint		mtype;
+		ulint		prtype;
+		ulint		len;
+
+		if (int err = innobase_get_col_type(
+			    field, &mtype, &prtype, &len)) {
+			my_error(err, MYF(0), field->field_name);
+			return(true);
+		}
+
+		dict_mem_fill_column_struct(col, n_old + i, mtype, prtype, len);
+
+		/* The records that lack the column will
+		take this value. */
+		dict_col_copy_type(col, dfield_get_type(&dfield));
+		innobase_build_col_map_add(ctx->heap, &dfield, field, TRUE);
+
+		col->def_val = static_cast<const byte*>(
+			dfield_get_data(&dfield));
+		col->def_val_len = dfield_get_len(&dfield);
+
+		ctx->instant_col_names[i] = mem_heap_strdup(
+			ctx->heap, field->field_name);
+	}
+
+	if (dict_table_instant_too_big(table, n_add, ctx->instant_cols)) {
+		my_error_innodb(DB_TOO_BIG_RECORD, table_name, table->flags);
+		return(true);
+	}
+
+	ctx->n_instant_cols = n_add;
+	return(false);
+}
+
 /** Construct the translation table for reordering, dropping or
 adding columns.
 
@@ -2746,78 +2972,21 @@ prepare_inplace_alter_table_dict(
 
 		for (uint i = 0; i < altered_table->s->fields; i++) {
 			const Field*	field = altered_table->field[i];
-			ulint		is_unsigned;
-			ulint		field_type
-				= (ulint) field->type();
-			ulint		col_type
-				= get_innobase_type_from_mysql_type(
-					&is_unsigned, field);
-			ulint		charset_no;
+			ulint		col_type;
+			ulint		prtype;
 			ulint		col_len;
 
-			/* we assume in dtype_form_prtype() that this
-			fits in two bytes */
-			ut_a(field_type <= MAX_CHAR_COLL_NUM);
-
-			if (!field->real_maybe_null()) {
-				field_type |= DATA_NOT_NULL;
-			}
-
-			if (field->binary()) {
-				field_type |= DATA_BINARY_TYPE;
-			}
-
-			if (is_unsigned) {
-				field_type |= DATA_UNSIGNED;
-			}
-
-			if (dtype_is_string_type(col_type)) {
-				charset_no = (ulint) field->charset()->number;
-
-				if (charset_no > MAX_CHAR_COLL_NUM) {
-					dict_mem_table_free(
-						ctx->new_table);
-					my_error(ER_WRONG_KEY_COLUMN, MYF(0),
-						 field->field_name);
-					goto new_clustered_failed;
-				}
-			} else {
-				charset_no = 0;
-			}
-
-			col_len = field->pack_length();
-
-			/* The MySQL pack length contains 1 or 2 bytes
-			length field for a true VARCHAR. Let us
-			subtract that, so that the InnoDB column
-			length in the InnoDB data dictionary is the
-			real maximum byte length of the actual data. */
-
-			if (field->type() == MYSQL_TYPE_VARCHAR) {
-				uint32	length_bytes
-					= static_cast<const Field_varstring*>(
-						field)->length_bytes;
-
-				col_len -= length_bytes;
-
-				if (length_bytes == 2) {
-					field_type |= DATA_LONG_TRUE_VARCHAR;
-				}
-			}
-
-			if (dict_col_name_is_reserved(field->field_name)) {
+			if (int err = innobase_get_col_type(
+				    field, &col_type, &prtype, &col_len)) {
 				dict_mem_table_free(ctx->new_table);
-				my_error(ER_WRONG_COLUMN_NAME, MYF(0),
-					 field->field_name);
+				my_error(err, MYF(0), field->field_name);
 				goto new_clustered_failed;
 			}
 
 			dict_mem_table_add_col(
 				ctx->new_table, ctx->heap,
 				field->field_name,
-				col_type,
-				dtype_form_prtype(field_type, charset_no),
-				col_len);
+				col_type, prtype, col_len);
 		}
 
 		if (add_fts_doc_id) {
@@ -3730,6 +3899,30 @@ err_exit:
 		}
 	}
 
+	if (innobase_instant_add_column_possible(
+		    ha_alter_info, altered_table, indexed_table)) {
+		DBUG_ASSERT(heap);
+
+		ha_innobase_inplace_ctx*	ctx
+			= new ha_innobase_inplace_ctx(
+				prebuilt,
+				drop_index, n_drop_index,
+				drop_fk, n_drop_fk,
+				add_fk, n_add_fk,
+				ha_alter_info->online,
+				heap, indexed_table,
+				col_names, ULINT_UNDEFINED, 0, 0);
+
+		ha_alter_info->handler_ctx = ctx;
+
+		if (innobase_instant_add_column_prepare(
+			    ctx, altered_table, table_share->table_name.str)) {
+			goto err_exit_no_heap;
+		}
+
+		goto func_exit;
+	}
+
 	if (!(ha_alter_info->handler_flags & INNOBASE_ALTER_DATA)
 	    || (ha_alter_info->handler_flags
 		== Alter_inplace_info::CHANGE_CREATE_OPTION
@@ -3908,6 +4101,13 @@ ok_exit:
 		(ha_alter_info->handler_ctx);
 
 	DBUG_ASSERT(ctx);
+
+	if (ctx->n_instant_cols) {
+		/* Instant ADD COLUMN only modifies the data
+		dictionary, in commit_inplace_alter_table(). */
+		goto ok_exit;
+	}
+
 	DBUG_ASSERT(ctx->trx);
 	DBUG_ASSERT(ctx->prebuilt == prebuilt);
 
@@ -4954,6 +5154,95 @@ commit_cache_rebuild(
 	DBUG_VOID_RETURN;
 }
 
+/** Add the columns of instant ADD COLUMN to the data dictionary tables.
+@param ctx		In-place ALTER TABLE context
+@param trx		Data dictionary transaction
+@param table_name	Table name in MySQL
+@retval true		Failure
+@retval false		Success
+*/
+static __attribute__((nonnull, warn_unused_result))
+bool
+innobase_instant_add_column_try(
+/*============================*/
+	const ha_innobase_inplace_ctx*	ctx,
+	trx_t*				trx,
+	const char*			table_name)
+{
+	const dict_table_t*	table	= ctx->new_table;
+	const ulint		n_old	= dict_table_get_n_user_cols(table);
+	pars_info_t*		info;
+	dberr_t			error	= DB_SUCCESS;
+
+	DBUG_ENTER("innobase_instant_add_column_try");
+	DBUG_ASSERT(ctx->n_instant_cols > 0);
+	DBUG_ASSERT(trx->dict_operation_lock_mode == RW_X_LATCH);
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	trx->op_info = "adding columns to SYS_COLUMNS";
+
+	for (ulint i = 0; i < ctx->n_instant_cols && error == DB_SUCCESS;
+	     i++) {
+		const dict_col_t*	col = &ctx->instant_cols[i];
+
+		info = pars_info_create();
+
+		pars_info_add_ull_literal(info, "id", table->id);
+		pars_info_add_int4_literal(info, "pos", n_old + i);
+		pars_info_add_str_literal(info, "name",
+					  ctx->instant_col_names[i]);
+		pars_info_add_int4_literal(info, "mtype", col->mtype);
+		pars_info_add_int4_literal(info, "prtype", col->prtype);
+		pars_info_add_int4_literal(info, "len", col->len);
+		pars_info_add_literal(info, "def_val", col->def_val,
+				      col->def_val_len,
+				      DATA_BLOB, DATA_BINARY_TYPE);
+
+		error = que_eval_sql(
+			info,
+			"PROCEDURE ADD_INSTANT_COLUMN_PROC () IS\n"
+			"BEGIN\n"
+			"INSERT INTO SYS_COLUMNS VALUES"
+			"(:id, :pos, :name, :mtype, :prtype, :len, 0);\n"
+			"INSERT INTO SYS_COLUMN_DEFAULTS VALUES"
+			"(:id, :pos, :def_val);\n"
+			"END;\n",
+			FALSE, trx);
+	}
+
+	if (error == DB_SUCCESS) {
+		info = pars_info_create();
+
+		pars_info_add_ull_literal(info, "id", table->id);
+		pars_info_add_int4_literal(
+			info, "n_cols",
+			(n_old + ctx->n_instant_cols) | DICT_N_COLS_COMPACT);
+		pars_info_add_int4_literal(
+			info, "flags2", table->flags2 | DICT_TF2_INSTANT);
+
+		trx->op_info = "updating SYS_TABLES for instant ADD COLUMN";
+
+		error = que_eval_sql(
+			info,
+			"PROCEDURE UPDATE_INSTANT_TABLE_PROC () IS\n"
+			"BEGIN\n"
+			"UPDATE SYS_TABLES SET N_COLS = :n_cols,"
+			" MIX_LEN = :flags2\n"
+			"WHERE ID = :id;\n"
+			"END;\n",
+			FALSE, trx);
+	}
+
+	trx->op_info = "";
+
+	if (error != DB_SUCCESS) {
+		my_error_innodb(error, table_name, table->flags);
+		DBUG_RETURN(true);
+	}
+
+	DBUG_RETURN(false);
+}
+
 /** Commit the changes made during prepare_inplace_alter_table()
 and inplace_alter_table() inside the data dictionary tables,
 when not rebuilding the table.
@@ -5059,6 +5348,11 @@ commit_try_norebuild(
 		}
 	}
 
+	if (ctx->n_instant_cols
+	    && innobase_instant_add_column_try(ctx, trx, table_name)) {
+		DBUG_RETURN(true);
+	}
+
 	if (!(ha_alter_info->handler_flags
 	      & Alter_inplace_info::ALTER_COLUMN_NAME)) {
 		DBUG_RETURN(false);
@@ -5097,6 +5391,12 @@ commit_cache_norebuild(
 		index->name++;
 	}
 
+	if (ctx->n_instant_cols) {
+		dict_table_instant_add_cols(
+			ctx->new_table, ctx->n_instant_cols,
+			ctx->instant_cols, ctx->instant_col_names);
+	}
+
 	if (ctx->num_to_drop_index) {
 		/* Really drop the indexes that were dropped.
 		The transaction had to be committed first
@@ -4441,6 +4441,15 @@ static ST_FIELD_INFO	i_s_innodb_buffer_stats_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
+#define IDX_BUF_STATS_NUMA_NODE		32
+	{STRUCT_FLD(field_name,		"NUMA_NODE"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED | MY_I_S_MAYBE_NULL),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
 	END_OF_ST_FIELD_INFO
 };
 
@@ -4574,6 +4583,15 @@ i_s_innodb_stats_fill(
 	OK(fields[IDX_BUF_STATS_UNZIP_CUR]->store(
 		static_cast<double>(info->unzip_cur)));
 
+	/* NULL unless innodb_buffer_pool_numa bound the instance */
+	if (info->numa_node != ULINT_UNDEFINED) {
+		OK(fields[IDX_BUF_STATS_NUMA_NODE]->store(
+			static_cast<double>(info->numa_node)));
+		fields[IDX_BUF_STATS_NUMA_NODE]->set_notnull();
+	} else {
+		fields[IDX_BUF_STATS_NUMA_NODE]->set_null();
+	}
+
 	DBUG_RETURN(schema_table_store_record(thd, table));
 }
 
@@ -5232,10 +5250,12 @@ i_s_innodb_fill_buffer_pool(
 
 	heap = mem_heap_create(10000);
 
-	/* Go through each chunk of buffer pool. Currently, we only
-	have one single chunk for each buffer pool */
+	/* Go through each chunk of buffer pool. The chunks may be
+	added or removed by buf_pool_resize() while buf_pool->mutex
+	is released. */
 	for (ulint n = 0; n < buf_pool->n_chunks; n++) {
 		const buf_block_t*	block;
+		const buf_block_t*	chunk_blocks;
 		ulint			n_blocks;
 		buf_page_info_t*	info_buffer;
 		ulint			num_page;
@@ -5245,7 +5265,18 @@ i_s_innodb_fill_buffer_pool(
 		ulint			block_id = 0;
 
 		/* Get buffer block of the nth chunk */
-		block = buf_get_nth_chunk_block(buf_pool, n, &chunk_size);
+		buf_pool_mutex_enter(buf_pool);
+
+		if (n >= buf_pool->n_chunks) {
+			buf_pool_mutex_exit(buf_pool);
+			break;
+		}
+
+		block = chunk_blocks = buf_get_nth_chunk_block(
+			buf_pool, n, &chunk_size);
+
+		buf_pool_mutex_exit(buf_pool);
+
 		num_page = 0;
 
 		while (chunk_size > 0) {
@@ -5268,6 +5299,14 @@ i_s_innodb_fill_buffer_pool(
 			release mutex periodically */
 			buf_pool_mutex_enter(buf_pool);
 
+			if (n >= buf_pool->n_chunks
+			    || buf_get_nth_chunk_block(buf_pool, n, &n_blocks)
+			    != chunk_blocks) {
+				/* The chunk was removed meanwhile. */
+				buf_pool_mutex_exit(buf_pool);
+				break;
+			}
+
 			/* GO through each block in the chunk */
 			for (n_blocks = num_to_process; n_blocks--; block++) {
 				i_s_innodb_buffer_page_get_info(
@@ -310,6 +310,10 @@ page are merged along with the page whose buffer became full */
 batch, in order to merge the entries for them in the insert buffer */
 #define	IBUF_MAX_N_PAGES_MERGED		IBUF_MERGE_AREA
 
+/** Maximum number of pages that a background merge batch reads, see
+ibuf_merge_batch() and innodb_change_buffer_merge_batch */
+#define	IBUF_MAX_N_PAGES_BATCH		256
+
 /** If the combined size of the ibuf trees exceeds ibuf->max_size by this
 many pages, we start to contract it in connection to inserts there, using
 non-synchronous contract */
@@ -2623,6 +2627,150 @@ ibuf_merge_pages(
 	return(sum_sizes + 1);
 }
 
+/*********************************************************************//**
+Contracts insert buffer trees by reading a batch of pages to the buffer
+pool. Unlike ibuf_merge_pages(), which starts at a random position,
+the batches sweep the ibuf tree in key order, continuing where the
+previous batch stopped. Each batch collects up to
+innodb_change_buffer_merge_batch distinct pages, which are read in
+ascending (space, page) order.
+@return a lower limit for the combined size in bytes of entries which
+will be merged from ibuf trees to the pages read, 0 if ibuf is
+empty */
+static
+ulint
+ibuf_merge_batch(
+/*=============*/
+	ulint*	n_pages)	/*!< out: number of pages to which merged */
+{
+	mtr_t		mtr;
+	btr_pcur_t	pcur;
+	mem_heap_t*	heap;
+	dtuple_t*	tuple;
+	const rec_t*	rec;
+	ulint		space;
+	ulint		page_no;
+	ulint		limit;
+	ulint		volume = 0;
+	ulint		prev_space = ULINT_UNDEFINED;
+	ib_int64_t	version = 0;
+	ulint		page_nos[IBUF_MAX_N_PAGES_BATCH];
+	ulint		space_ids[IBUF_MAX_N_PAGES_BATCH];
+	ib_int64_t	space_versions[IBUF_MAX_N_PAGES_BATCH];
+
+	*n_pages = 0;
+
+	limit = ut_min(srv_ibuf_merge_batch, IBUF_MAX_N_PAGES_BATCH);
+	limit = ut_min(limit, buf_pool_get_curr_size() / 4);
+
+	mutex_enter(&ibuf_mutex);
+
+	space = ibuf->merge_space;
+	page_no = ibuf->merge_page_no;
+
+	if (!ibuf->merge_pass_start) {
+		ibuf->merge_pass_start = ut_time();
+	}
+
+	mutex_exit(&ibuf_mutex);
+
+	heap = mem_heap_create(512);
+	tuple = ibuf_search_tuple_build(space, page_no, heap);
+
+	ibuf_mtr_start(&mtr);
+
+	/* Position the cursor on the first record at or after the
+	position where the previous batch stopped. */
+
+	btr_pcur_open(
+		ibuf->index, tuple, PAGE_CUR_GE, BTR_SEARCH_LEAF, &pcur,
+		&mtr);
+
+	mem_heap_free(heap);
+
+	if (page_is_empty(btr_pcur_get_page(&pcur))) {
+		/* If a B-tree page is empty, it must be the root page
+		and the whole B-tree must be empty. InnoDB does not
+		allow empty B-tree pages other than the root. */
+		ut_ad(ibuf->empty);
+		ut_ad(page_get_space_id(btr_pcur_get_page(&pcur))
+		      == IBUF_SPACE_ID);
+		ut_ad(page_get_page_no(btr_pcur_get_page(&pcur))
+		      == FSP_IBUF_TREE_ROOT_PAGE_NO);
+
+		ibuf_mtr_commit(&mtr);
+		btr_pcur_close(&pcur);
+
+		return(0);
+	}
+
+	while (*n_pages < limit
+	       && (rec = ibuf_get_user_rec(&pcur, &mtr)) != NULL) {
+
+		space = ibuf_rec_get_space(&mtr, rec);
+		page_no = ibuf_rec_get_page_no(&mtr, rec);
+
+		if (space != prev_space) {
+			version = fil_space_get_version(space);
+			prev_space = space;
+		}
+
+		if (*n_pages == 0
+		    || page_nos[*n_pages - 1] != page_no
+		    || space_ids[*n_pages - 1] != space) {
+
+			space_ids[*n_pages] = space;
+			space_versions[*n_pages] = version;
+			page_nos[*n_pages] = page_no;
+			++*n_pages;
+		}
+
+		volume += ibuf_rec_get_volume(&mtr, rec);
+
+		btr_pcur_move_to_next(&pcur, &mtr);
+	}
+
+	/* The batch may have stopped in the middle of the records for
+	the last page; they will be merged when the page is read. */
+	rec = ibuf_get_user_rec(&pcur, &mtr);
+
+	ibuf_mtr_commit(&mtr);
+	btr_pcur_close(&pcur);
+
+	mutex_enter(&ibuf_mutex);
+
+	if (rec == NULL) {
+		/* We reached the end of the tree: start the next batch
+		from the beginning and account for the completed pass. */
+		ib_time_t	now = ut_time();
+
+		ibuf->merge_space = 0;
+		ibuf->merge_page_no = 0;
+
+		ibuf->merge_pass_secs = (ulint) ut_difftime(
+			now, ibuf->merge_pass_start);
+		ibuf->merge_pass_end = now;
+		ibuf->merge_pass_start = now;
+	} else {
+		ibuf->merge_space = space_ids[*n_pages - 1];
+		ibuf->merge_page_no = page_nos[*n_pages - 1] + 1;
+	}
+
+	if (*n_pages > 0) {
+		ibuf->n_merge_batches++;
+		ibuf->n_merge_batch_pages += *n_pages;
+	}
+
+	mutex_exit(&ibuf_mutex);
+
+	buf_read_ibuf_merge_pages(
+		false, space_ids, space_versions, page_nos, *n_pages);
+
+	/* If the sweep wrapped around without finding anything, the
+	caller may call us again to start from the beginning. */
+	return(volume + 1);
+}
+
 /*********************************************************************//**
 Get the table instance from the table id.
 @return table instance */
@@ -2735,10 +2883,14 @@ ibuf_merge(
 					should be 0 */
 	ulint*		n_pages,	/*!< out: number of pages to
 					which merged */
-	bool		sync)		/*!< in: TRUE if the caller
+	bool		sync,		/*!< in: TRUE if the caller
 					wants to wait for the issued
 					read with the highest
 					tablespace address to complete */
+	bool		batch)		/*!< in: whether to merge a
+					batch of pages in key order,
+					see ibuf_merge_batch(); only for
+					!sync and table_id == 0 */
 {
 	dict_table_t*	table;
 
@@ -2755,6 +2907,9 @@ ibuf_merge(
 	} else if (ibuf_debug) {
 		return(0);
 #endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
+	} else if (table_id == 0 && batch) {
+		ut_ad(!sync);
+		return(ibuf_merge_batch(n_pages));
 	} else if (table_id == 0) {
 		return(ibuf_merge_pages(n_pages, sync));
 	} else if ((table = ibuf_get_table(table_id)) == 0) {
@@ -2784,7 +2939,7 @@ ibuf_contract(
 {
 	ulint	n_pages;
 
-	return(ibuf_merge(0, &n_pages, sync));
+	return(ibuf_merge(0, &n_pages, sync, false));
 }
 
 /*********************************************************************//**
@@ -2807,6 +2962,7 @@ ibuf_contract_in_background(
 {
 	ulint	sum_bytes	= 0;
 	ulint	sum_pages	= 0;
+	ulint	n_empty_batches	= 0;
 	ulint	n_pag2;
 	ulint	n_pages;
 
@@ -2821,7 +2977,7 @@ ibuf_contract_in_background(
 		n_pages = PCT_IO(100);
 	} else {
 		/* By default we do a batch of 5% of the io_capacity */
-		n_pages = PCT_IO(5);
+		n_pages = PCT_IO(srv_ibuf_merge_io_pct);
 
 		mutex_enter(&ibuf_mutex);
 
@@ -2840,12 +2996,18 @@ ibuf_contract_in_background(
 	while (sum_pages < n_pages) {
 		ulint	n_bytes;
 
-		n_bytes = ibuf_merge(table_id, &n_pag2, FALSE);
+		n_bytes = ibuf_merge(table_id, &n_pag2, FALSE, true);
 
 		if (n_bytes == 0) {
 			return(sum_bytes);
 		}
 
+		if (n_pag2 == 0 && n_empty_batches++ > 0) {
+			/* The batches swept the whole tree
+			without finding anything to merge. */
+			return(sum_bytes);
+		}
+
 		sum_bytes += n_bytes;
 		sum_pages += n_pag2;
 	}
@@ -5093,6 +5255,21 @@ ibuf_print(
 		(ulong) ibuf->seg_size,
 		(ulong) ibuf->n_merges);
 
+	fprintf(file,
+		"merge batches %lu, pages read by them %lu",
+		(ulong) ibuf->n_merge_batches,
+		(ulong) ibuf->n_merge_batch_pages);
+
+	if (ibuf->merge_pass_end) {
+		fprintf(file,
+			", last full pass took %lu s and ended"
+			" %.0f s ago\n",
+			(ulong) ibuf->merge_pass_secs,
+			ut_difftime(ut_time(), ibuf->merge_pass_end));
+	} else {
+		putc('\n', file);
+	}
+
 	fputs("merged operations:\n ", file);
 	ibuf_print_ops(ibuf->n_merged_ops, file);
 
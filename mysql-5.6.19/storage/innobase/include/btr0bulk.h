@@ -0,0 +1,82 @@
+/*****************************************************************************
+
+Copyright (c) 2026, the authors of this file.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/btr0bulk.h
+Bottom-up loading of a B-tree from sorted index entries
+
+The entries are appended to the rightmost leaf page, which is filled
+without generating redo log for each record and is logged as a page
+image once it is full. The node pointer levels are built on the fly
+from the first record of each completed page, and the topmost page is
+finally copied to the root page of the index.
+
+The loader is used by row_merge_insert_index_tuples() for the indexes
+that ALTER TABLE creates or rebuilds. LOAD DATA does not use it: its
+rows arrive through handler::write_row() in file order, and each row
+is undo logged so that the statement can be rolled back and is not
+seen by older read views.
+*******************************************************/
+
+#ifndef btr0bulk_h
+#define btr0bulk_h
+
+#include "univ.i"
+#include "data0types.h"
+#include "dict0types.h"
+#include "trx0types.h"
+
+/** Bulk loader of an index tree */
+struct btr_bulk_t;
+
+/**********************************************************************//**
+Creates a bulk loader for an empty, uncompressed index tree.
+@return own: bulk loader */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,	/*!< in: index whose tree is empty */
+	trx_id_t	trx_id)	/*!< in: transaction building the index */
+	__attribute__((nonnull, warn_unused_result));
+/**********************************************************************//**
+Appends an entry to the index tree. The entries must be passed in
+ascending order.
+@return DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk loader */
+	dtuple_t*	tuple)	/*!< in/out: index entry; fields may be
+				temporarily moved off-page */
+	__attribute__((nonnull, warn_unused_result));
+/**********************************************************************//**
+Completes the index tree and frees the bulk loader. If err is not
+DB_SUCCESS, the latches are released without completing the tree;
+the caller is expected to drop the index.
+@return DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_finish(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in, own: bulk loader */
+	dberr_t		err)	/*!< in: error status of the load */
+	__attribute__((nonnull, warn_unused_result));
+
+#endif /* btr0bulk_h */
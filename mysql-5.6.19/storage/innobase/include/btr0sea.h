@@ -60,6 +60,14 @@ UNIV_INTERN
 void
 btr_search_enable(void);
 /*====================*/
+/*****************************************************************//**
+Resizes the hash table of the adaptive hash index. The index must be
+disabled. */
+UNIV_INTERN
+void
+btr_search_sys_resize(
+/*==================*/
+	ulint	hash_size);	/*!< in: hash index hash table size */
 
 /********************************************************************//**
 Returns search info for an index.
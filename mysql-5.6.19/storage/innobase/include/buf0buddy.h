@@ -70,6 +70,32 @@ buf_buddy_free(
 					up to UNIV_PAGE_SIZE */
 	__attribute__((nonnull));
 
+/**********************************************************************//**
+Try to reallocate a block to a frame that is not being withdrawn.
+@return	true if a free block was available; false if the free list
+was empty and the block was not moved */
+UNIV_INTERN
+bool
+buf_buddy_realloc(
+/*==============*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	void*		buf,		/*!< in: block to be reallocated,
+					the compressed frame of a page
+					in buf_pool->page_hash */
+	ulint		size)		/*!< in: block size,
+					up to UNIV_PAGE_SIZE */
+	__attribute__((nonnull));
+
+/**********************************************************************//**
+Combines the free buddy blocks in the frames that are being withdrawn,
+so that whole frames are returned to buf_pool->withdraw. */
+UNIV_INTERN
+void
+buf_buddy_condense_free(
+/*====================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+	__attribute__((nonnull));
+
 #ifndef UNIV_NONINL
 # include "buf0buddy.ic"
 #endif
@@ -84,6 +84,14 @@ Created 11/5/1995 Heikki Tuuri
 
 extern	buf_pool_t*	buf_pool_ptr;	/*!< The buffer pools
 					of the database */
+extern volatile bool	buf_pool_withdrawing;
+					/*!< true while buf_pool_resize()
+					is withdrawing blocks from the
+					chunks it is about to free */
+extern volatile ulint	buf_withdraw_clock;
+					/*!< incremented each time
+					buf_pool_resize() has freed
+					chunks of the buffer pool */
 #ifdef UNIV_DEBUG
 extern ibool		buf_debug_prints;/*!< If this is set TRUE, the program
 					prints info whenever read or flush
@@ -131,6 +139,7 @@ will be used to print table IO stats */
 struct buf_pool_info_t{
 	/* General buffer pool info */
 	ulint	pool_unique_id;		/*!< Buffer Pool ID */
+	ulint	numa_node;		/*!< buf_pool->numa_node */
 	ulint	pool_size;		/*!< Buffer Pool size in pages */
 	ulint	lru_len;		/*!< Length of buf_pool->LRU */
 	ulint	old_lru_len;		/*!< buf_pool->LRU_old_len */
@@ -246,6 +255,53 @@ void
 buf_pool_clear_hash_index(void);
 /*===========================*/
 
+/********************************************************************//**
+Determines whether a block belongs to a chunk that buf_pool_resize()
+is removing from the buffer pool instance.
+@return	true if the block will be removed from the buffer pool */
+UNIV_INTERN
+bool
+buf_block_will_be_withdrawn(
+/*========================*/
+	const buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const buf_block_t*	block)		/*!< in: block, not
+						dereferenced */
+	__attribute__((nonnull, warn_unused_result));
+/********************************************************************//**
+Determines whether a pointer points to the frames of a chunk that
+buf_pool_resize() is removing from the buffer pool instance.
+@return	true if the frame will be removed from the buffer pool */
+UNIV_INTERN
+bool
+buf_frame_will_be_withdrawn(
+/*========================*/
+	const buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	const byte*		ptr)		/*!< in: pointer to a frame,
+						not dereferenced */
+	__attribute__((nonnull, warn_unused_result));
+/********************************************************************//**
+Determines whether a block pointer that was saved when buf_withdraw_clock
+had the given value may point to a chunk that has been freed since.
+@return	true if the pointer must not be dereferenced */
+UNIV_INLINE
+bool
+buf_pool_is_obsolete(
+/*=================*/
+	ulint	withdraw_clock)	/*!< in: buf_withdraw_clock when the
+				pointer was saved */
+	__attribute__((warn_unused_result));
+/*****************************************************************//**
+This is the thread that resizes the buffer pool. It waits for an event
+and when woken up adds or removes chunks until the size of the buffer
+pool matches srv_buf_pool_size.
+@return this function does not return, it calls os_thread_exit() */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_resize_thread)(
+/*==============================*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
 /********************************************************************//**
 Relocate a buffer control block.  Relocates the block on the LRU list
 and in buf_pool->page_hash.  Does not relocate bpage->list.
@@ -1491,6 +1547,13 @@ struct buf_page_t{
 # if MAX_BUFFER_POOLS > 64
 #  error "MAX_BUFFER_POOLS > 64; redefine buf_pool_index:6"
 # endif
+	unsigned	dblwr_bypassed:1;/*!< TRUE if the write that is in
+					progress does not go through the
+					doublewrite buffer; set by
+					buf_flush_write_block_low() while
+					the page is io-fixed, and read by
+					buf_dblwr_update() when the write
+					completes */
 	/* @} */
 #endif /* !UNIV_HOTBACKUP */
 	page_zip_des_t	zip;		/*!< compressed page; zip.data
@@ -1817,6 +1880,19 @@ struct buf_buddy_stat_t {
 	ib_uint64_t	relocated_usec;
 };
 
+/** The chunks of a buffer pool instance as seen by threads that do not
+hold buf_pool->mutex. buf_pool_resize() publishes a new map instead of
+changing one, so that the count and the array are always read
+together. The replaced maps are kept until the buffer pool is freed,
+because a reader may still be using them. */
+struct buf_chunk_map_t {
+	ulint		n_chunks;	/*!< number of chunks */
+	buf_chunk_t*	chunks;		/*!< copy of the chunk descriptors;
+					allocated with the map */
+	buf_chunk_map_t* prev;		/*!< the map that this one
+					replaced, or NULL */
+};
+
 /** @brief The buffer pool structure.
 
 NOTE! The definition appears here only for other modules of this
@@ -1834,6 +1910,10 @@ struct buf_pool_t{
 					buf_block_t */
 	ulint		instance_no;	/*!< Array index of this buffer
 					pool instance */
+	ulint		numa_node;	/*!< NUMA node that the chunks of
+					this instance are bound to, or
+					ULINT_UNDEFINED if they are not
+					bound; see srv_buf_pool_numa */
 	ulint		old_pool_size;  /*!< Old pool size in bytes */
 	ulint		curr_pool_size;	/*!< Current pool size in bytes */
 	ulint		LRU_old_ratio;  /*!< Reserve this much of the buffer
@@ -1845,8 +1925,20 @@ struct buf_pool_t{
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 	ulint		mutex_exit_forbidden; /*!< Forbid release mutex */
 #endif
-	ulint		n_chunks;	/*!< number of buffer pool chunks */
+	ulint		n_chunks;	/*!< number of buffer pool chunks.
+					Changes are protected by
+					buf_pool->mutex and all the
+					page_hash locks */
+	ulint		n_chunks_new;	/*!< number of buffer pool chunks
+					that remain after the ongoing
+					withdrawal; equals n_chunks when
+					buf_pool_resize() is not
+					shrinking this instance */
 	buf_chunk_t*	chunks;		/*!< buffer pool chunks */
+	buf_chunk_map_t* chunk_map;	/*!< copy of n_chunks and chunks
+					for threads that do not hold
+					buf_pool->mutex; replaced by
+					buf_pool_resize() */
 	ulint		curr_size;	/*!< current pool size in pages */
 	hash_table_t*	page_hash;	/*!< hash table of buf_page_t or
 					buf_block_t file pages,
@@ -1948,6 +2040,16 @@ struct buf_pool_t{
 	UT_LIST_BASE_NODE_T(buf_page_t) free;
 					/*!< base node of the free
 					block list */
+	UT_LIST_BASE_NODE_T(buf_page_t) withdraw;
+					/*!< base node of the list of
+					free blocks in the chunks
+					[n_chunks_new, n_chunks) that
+					buf_pool_resize() is about to
+					free; these blocks are never
+					handed out again */
+	ulint		withdraw_target;/*!< number of blocks in the
+					chunks being withdrawn, 0 when
+					not withdrawing */
 	UT_LIST_BASE_NODE_T(buf_page_t) LRU;
 					/*!< base node of the LRU list */
 	buf_page_t*	LRU_old;	/*!< pointer to the about
@@ -65,6 +65,16 @@ void
 buf_dblwr_process(void);
 /*===================*/
 
+/****************************************************************//**
+Removes the doublewrite files that are not used by the current
+configuration and frees the pages that were read from the doublewrite
+files for crash recovery. Must be called after the crash recovery has
+completed. */
+UNIV_INTERN
+void
+buf_dblwr_files_cleanup(void);
+/*==========================*/
+
 /****************************************************************//**
 frees doublewrite buffer. */
 UNIV_INTERN
@@ -108,6 +118,19 @@ void
 buf_dblwr_flush_buffered_writes(void);
 /*=================================*/
 /********************************************************************//**
+Flushes the writes buffered for a flush batch of a buffer pool instance.
+If the doublewrite files are used, only the file of the buffer pool
+instance and flush type is written, so that batches of other instances
+and flush types are not waited for; otherwise this is the same as
+buf_dblwr_flush_buffered_writes(). */
+UNIV_INTERN
+void
+buf_dblwr_flush_batch(
+/*==================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	buf_flush_t	flush_type);	/*!< in: BUF_FLUSH_LRU or
+					BUF_FLUSH_LIST */
+/********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
 for single page flushes. If all the buffers allocated for single page
@@ -122,6 +145,31 @@ buf_dblwr_write_single_page(
 	buf_page_t*	bpage,	/*!< in: buffer block to write */
 	bool		sync);	/*!< in: true if sync IO requested */
 
+/** Doublewrite file used by the flush batches of one buffer pool
+instance and flush type */
+struct buf_dblwr_file_t{
+	ib_mutex_t	mutex;	/*!< mutex protecting the fields below */
+	char*		path;	/*!< path of the file */
+	os_file_t	file;	/*!< file handle */
+	ulint		first_free;/*!< first free position in write_buf
+				measured in units of UNIV_PAGE_SIZE */
+	ulint		b_reserved;/*!< number of slots currently reserved
+				for batch flush. */
+	os_event_t	b_event;/*!< event where threads wait for a
+				batch flush to end. */
+	bool		batch_running;/*!< set to TRUE if currently a batch
+				is being written from the doublewrite
+				file. */
+	byte*		write_buf;/*!< write buffer used in writing to the
+				doublewrite file, aligned to an
+				address divisible by UNIV_PAGE_SIZE */
+	byte*		write_buf_unaligned;/*!< pointer to write_buf,
+				but unaligned */
+	buf_page_t**	buf_block_arr;/*!< array to store pointers to
+				the buffer blocks which have been
+				cached to write_buf */
+};
+
 /** Doublewrite control struct */
 struct buf_dblwr_t{
 	ib_mutex_t	mutex;	/*!< mutex protecting the first_free
@@ -154,6 +202,17 @@ struct buf_dblwr_t{
 	buf_page_t**	buf_block_arr;/*!< array to store pointers to
 				the buffer blocks which have been
 				cached to write_buf */
+	ulint		n_files;/*!< number of doublewrite files, two
+				for each buffer pool instance; 0 if the
+				flush batches use the doublewrite buffer
+				in the system tablespace */
+	buf_dblwr_file_t* files;/*!< doublewrite files of the flush
+				batches, indexed by buffer pool instance
+				and flush type */
+	byte*		recv_buf_unaligned;/*!< buffer holding the pages
+				read from the doublewrite files at
+				startup, referenced by recv_sys->dblwr
+				during crash recovery */
 };
 
 
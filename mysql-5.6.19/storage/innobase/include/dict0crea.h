@@ -156,6 +156,15 @@ UNIV_INTERN
 dberr_t
 dict_create_or_check_sys_tablespace(void);
 /*=====================================*/
+/****************************************************************//**
+Creates the SYS_COLUMN_DEFAULTS system table, which holds the default
+values of the columns that were added by instant ADD COLUMN, at server
+bootstrap or server start if it is not found or is not of the right form.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+dict_create_or_check_sys_column_defaults(void);
+/*==========================================*/
 /********************************************************************//**
 Add a single tablespace definition to the data dictionary tables in the
 database.
@@ -42,6 +42,7 @@ Created 1/8/1996 Heikki Tuuri
 #include "ut0byte.h"
 #include "trx0types.h"
 #include "row0types.h"
+#include "mtr0types.h"
 
 #ifndef UNIV_HOTBACKUP
 # include "sync0sync.h"
@@ -359,6 +360,35 @@ dict_table_add_to_cache(
 	ibool		can_be_evicted,	/*!< in: TRUE if can be evicted*/
 	mem_heap_t*	heap)		/*!< in: temporary heap */
 	__attribute__((nonnull));
+/*******************************************************************//**
+Determines if the records of the clustered index of a table could
+become too big for a B-tree page if columns were added to the table
+by instant ADD COLUMN.
+@return	true if the index records could become too big */
+UNIV_INTERN
+bool
+dict_table_instant_too_big(
+/*=======================*/
+	const dict_table_t*	table,	/*!< in: table */
+	ulint			n_add,	/*!< in: number of columns to add */
+	const dict_col_t*	cols)	/*!< in: columns to add */
+	__attribute__((nonnull, warn_unused_result));
+/*******************************************************************//**
+Adds columns to a table in the dictionary cache by instant ADD COLUMN.
+The columns are added after the existing user columns, and they are
+appended to the fields of the clustered index. The records of the
+clustered index are not modified; the records that lack the added
+fields take the default values of the columns. */
+UNIV_INTERN
+void
+dict_table_instant_add_cols(
+/*========================*/
+	dict_table_t*		table,	/*!< in/out: table */
+	ulint			n_add,	/*!< in: number of columns to add */
+	const dict_col_t*	cols,	/*!< in: columns to add, with
+					def_val and def_val_len */
+	const char* const*	names)	/*!< in: names of the columns */
+	__attribute__((nonnull));
 /**********************************************************************//**
 Removes a table object from the dictionary cache. */
 UNIV_INTERN
@@ -1063,6 +1093,39 @@ dict_index_get_n_fields(
 					the dictionary cache) */
 	__attribute__((nonnull, warn_unused_result));
 /********************************************************************//**
+Determines whether fields were added to an index by instant ADD COLUMN,
+so that its leaf-page records may lack trailing fields.
+@return	nonzero if instant ADD COLUMN was executed on the index */
+UNIV_INLINE
+ulint
+dict_index_is_instant(
+/*==================*/
+	const dict_index_t*	index)	/*!< in: index */
+	__attribute__((nonnull, warn_unused_result));
+/********************************************************************//**
+Gets the number of fields that every leaf-page record of an index
+contains, that is, the fields that existed before any instant
+ADD COLUMN.
+@return	number of core fields */
+UNIV_INLINE
+ulint
+dict_index_get_n_core_fields(
+/*=========================*/
+	const dict_index_t*	index)	/*!< in: index */
+	__attribute__((nonnull, warn_unused_result));
+/********************************************************************//**
+Gets the number of null flags in a ROW_FORMAT=COMPACT record of an
+index that contains the first n fields. Records that contain at most
+the core fields reserve a null flag for every nullable core field.
+@return	number of null flags */
+UNIV_INLINE
+ulint
+dict_index_get_n_nullable(
+/*======================*/
+	const dict_index_t*	index,	/*!< in: index */
+	ulint			n)	/*!< in: number of leading fields */
+	__attribute__((nonnull, warn_unused_result));
+/********************************************************************//**
 Gets the number of fields in the internal representation of an index
 that uniquely determine the position of an index entry in the index, if
 we do not take multiversioning into account: in the B-tree use the value
@@ -1783,6 +1846,18 @@ dict_table_is_temporary(
 	const dict_table_t*	table)	/*!< in: table to check */
 	__attribute__((nonnull, pure, warn_unused_result));
 
+/********************************************************************//**
+Turns off redo logging in a mini-transaction that modifies a temporary
+table in its own tablespace. The tablespace file is discarded after a
+crash, so the redo log records would never be applied. */
+UNIV_INLINE
+void
+dict_disable_redo_if_temporary(
+/*===========================*/
+	const dict_table_t*	table,	/*!< in: table to be modified */
+	mtr_t*			mtr)	/*!< in/out: mini-transaction */
+	__attribute__((nonnull));
+
 #ifndef UNIV_HOTBACKUP
 /*********************************************************************//**
 This function should be called whenever a page is successfully
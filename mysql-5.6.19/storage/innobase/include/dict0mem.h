@@ -192,7 +192,7 @@ ROW_FORMAT=REDUNDANT.  InnoDB engines do not check these flags
 for unknown bits in order to protect backward incompatibility. */
 /* @{ */
 /** Total number of bits in table->flags2. */
-#define DICT_TF2_BITS			7
+#define DICT_TF2_BITS			9
 #define DICT_TF2_BIT_MASK		~(~0 << DICT_TF2_BITS)
 
 /** TEMPORARY; TRUE for tables from CREATE TEMPORARY TABLE. */
@@ -214,6 +214,16 @@ use its own tablespace instead of the system tablespace. */
 /** This bit is set if all aux table names (both common tables and
 index tables) of a FTS table are in HEX format. */
 #define DICT_TF2_FTS_AUX_HEX_NAME	64
+
+/** The pages of the tablespace of the table are compressed when they
+are written, and the unused tail of each page is punched out of the
+file. Only set for tables in their own tablespace. */
+#define DICT_TF2_PAGE_COMPRESSED	128
+
+/** Columns were added to the table by instant ADD COLUMN; their
+default values are stored in SYS_COLUMN_DEFAULTS and the records of
+the clustered index may lack the trailing fields. */
+#define DICT_TF2_INSTANT		256
 /* @} */
 
 #define DICT_TF2_FLAG_SET(table, flag)				\
@@ -436,6 +446,12 @@ struct dict_col_t{
 	unsigned	max_prefix:12;	/*!< maximum index prefix length on
 					this column. Our current max limit is
 					3072 for Barracuda table */
+	const byte*	def_val;	/*!< default value of a column that
+					was added by instant ADD COLUMN, for
+					records that predate the column;
+					NULL if none */
+	ulint		def_val_len;	/*!< length of def_val, or
+					UNIV_SQL_NULL */
 };
 
 /** @brief DICT_ANTELOPE_MAX_INDEX_COL_LEN is measured in bytes and
@@ -573,6 +589,13 @@ struct dict_index_t{
 	unsigned	n_def:10;/*!< number of fields defined so far */
 	unsigned	n_fields:10;/*!< number of fields in the index */
 	unsigned	n_nullable:10;/*!< number of nullable fields */
+	unsigned	n_instant_fields:10;
+				/*!< number of trailing fields that were
+				added by instant ADD COLUMN; records may
+				lack them and take the default values */
+	unsigned	n_instant_nullable:10;
+				/*!< number of nullable fields among the
+				n_instant_fields */
 	unsigned	cached:1;/*!< TRUE if the index object is in the
 				dictionary cache */
 	unsigned	to_be_dropped:1;
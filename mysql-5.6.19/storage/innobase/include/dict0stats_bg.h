@@ -93,6 +93,20 @@ dict_stats_wait_bg_to_stop_using_table(
 	trx_t*		trx);	/*!< in/out: transaction to use for
 				unlocking/locking the data dict */
 /*****************************************************************//**
+Runs func(arg) in the calling thread and in up to n_helpers threads of
+the stats worker pool, and returns when all of them have returned. The
+callers of func must share the work among themselves; if no worker
+joins in, the calling thread does all of it. The pool grows on demand
+and its threads are reused until shutdown. */
+UNIV_INTERN
+void
+dict_stats_pool_run(
+/*================*/
+	void		(*func)(void*),	/*!< in: function to run */
+	void*		arg,		/*!< in/out: argument of func */
+	ulint		n_helpers);	/*!< in: number of worker threads
+					that may join the calling thread */
+/*****************************************************************//**
 Initialize global variables needed for the operation of dict_stats_thread().
 Must be called before dict_stats_thread() is started. */
 UNIV_INTERN
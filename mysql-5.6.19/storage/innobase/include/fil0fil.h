@@ -158,6 +158,23 @@ extern fil_addr_t	fil_addr_null;
 #define FIL_PAGE_TYPE_ZBLOB2	12	/*!< Subsequent compressed BLOB page */
 #define FIL_PAGE_TYPE_LAST	FIL_PAGE_TYPE_ZBLOB2
 					/*!< Last page type */
+#define FIL_PAGE_COMPRESSED	14	/*!< Page compressed on write to a
+					tablespace that uses page
+					compression; only found in data
+					files, never in the buffer pool */
+/* @} */
+
+/** Header of a FIL_PAGE_COMPRESSED page, stored in the
+FIL_PAGE_FILE_FLUSH_LSN field @{ */
+#define FIL_PAGE_COMPRESS_ORIG_TYPE FIL_PAGE_FILE_FLUSH_LSN
+					/*!< FIL_PAGE_TYPE of the page
+					before compression */
+#define FIL_PAGE_COMPRESS_SIZE	(FIL_PAGE_FILE_FLUSH_LSN + 2)
+					/*!< length of the compressed data
+					that starts at FIL_PAGE_DATA */
+#define FIL_PAGE_COMPRESS_ALGORITHM (FIL_PAGE_FILE_FLUSH_LSN + 4)
+					/*!< compression algorithm */
+#define FIL_PAGE_COMPRESS_ZLIB	1	/*!< zlib compression */
 /* @} */
 
 /** Space types @{ */
@@ -320,6 +337,24 @@ fil_space_get_flags(
 /*================*/
 	ulint	id);	/*!< in: space id */
 /*******************************************************************//**
+Checks if a tablespace holds a table created with CREATE TEMPORARY TABLE.
+The tablespace must be cached in the memory cache.
+@return	true if the space is a temporary tablespace */
+UNIV_INTERN
+bool
+fil_space_is_temporary(
+/*===================*/
+	ulint	id);	/*!< in: space id */
+/*******************************************************************//**
+Makes the pages of a single-table tablespace compressed when they are
+written. Pages that were written before keep their format until they
+are written again; reads accept both formats. */
+UNIV_INTERN
+void
+fil_space_set_page_compressed(
+/*==========================*/
+	ulint	id);	/*!< in: space id */
+/*******************************************************************//**
 Returns the compressed page size of the space, or 0 if the space
 is not compressed. The tablespace must be cached in the memory cache.
 @return	compressed page size, ULINT_UNDEFINED if space not found */
@@ -726,6 +761,17 @@ fil_extend_space_to_desired_size(
 	ulint	size_after_extend);/*!< in: desired size in pages after the
 				extension; if the current space size is bigger
 				than this already, the function does nothing */
+/**********************************************************************//**
+Truncates a single-file tablespace to the given number of pages. The
+caller must ensure that no pages beyond the new size are in the buffer
+pool or will be accessed again.
+@return	TRUE if success */
+UNIV_INTERN
+ibool
+fil_truncate_space(
+/*===============*/
+	ulint	space_id,	/*!< in: space id */
+	ulint	size);		/*!< in: new size in pages */
 /*******************************************************************//**
 Tries to reserve free extents in a file space.
 @return	TRUE if succeed */
@@ -123,6 +123,13 @@ struct fts_sync_t {
 					noted as being full, we use this to
 					set the upper_limit field */
         ib_time_t	start_time;	/*!< SYNC start time */
+	ibool		in_progress;	/*!< TRUE while a SYNC is writing
+					the cache; the cache lock is
+					released between the writes of
+					the nodes, so that documents can
+					be added to the cache meanwhile */
+	os_event_t	event;		/*!< set when in_progress is
+					reset */
 };
 
 /** The cache for the FTS system. It is a memory-based inverted index
@@ -212,6 +219,11 @@ struct fts_node_t {
 	ulint		ilist_size_alloc;
 					/*!< Allocated size of ilist in
 					bytes */
+
+	ibool		synced;		/*!< TRUE if the node was written
+					to the INDEX table by the ongoing
+					SYNC; no more positions may be
+					added to it */
 };
 
 /** A tokenizer word. Contains information about one word. */
@@ -507,6 +507,32 @@ hash_unlock_x_all_but(
 /*==================*/
 	hash_table_t*	table,		/*!< in: hash table */
 	rw_lock_t*	keep_lock);	/*!< in: lock to keep */
+/************************************************************//**
+Makes sure that the s-latched lock still protects a fold value after
+the cell array of the hash table may have been replaced while the
+lock was being waited for. If it does not, the lock is released and
+the lock that now protects the fold is s-latched instead.
+@return	s-latched lock protecting the fold */
+UNIV_INTERN
+rw_lock_t*
+hash_lock_s_confirm(
+/*================*/
+	rw_lock_t*	hash_lock,	/*!< in: s-latched lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold);		/*!< in: fold */
+/************************************************************//**
+Makes sure that the x-latched lock still protects a fold value after
+the cell array of the hash table may have been replaced while the
+lock was being waited for. If it does not, the lock is released and
+the lock that now protects the fold is x-latched instead.
+@return	x-latched lock protecting the fold */
+UNIV_INTERN
+rw_lock_t*
+hash_lock_x_confirm(
+/*================*/
+	rw_lock_t*	hash_lock,	/*!< in: x-latched lock */
+	hash_table_t*	table,		/*!< in: hash table */
+	ulint		fold);		/*!< in: fold */
 
 #else /* !UNIV_HOTBACKUP */
 # define hash_get_heap(table, fold)	((table)->heap)
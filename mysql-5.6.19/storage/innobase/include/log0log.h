@@ -70,6 +70,22 @@ extern	ibool	log_debug_writes;
 /** Maximum number of log groups in log_group_t::checkpoint_buf */
 #define LOG_MAX_N_GROUPS	32
 
+#if defined HAVE_ATOMIC_BUILTINS && !defined UNIV_LOG_DEBUG
+/** Mini-transactions copy their redo log records into the log buffer
+after releasing log_sys->mutex. With UNIV_LOG_DEBUG log_close() parses
+the records just written, so they must be copied under the mutex. */
+# define LOG_CONCURRENT_COPY
+#endif /* HAVE_ATOMIC_BUILTINS && !UNIV_LOG_DEBUG */
+
+#ifdef LOG_CONCURRENT_COPY
+/** An area of the log buffer reserved by log_reserve_for_copy() */
+struct log_copy_t {
+	byte*		ptr;		/*!< next byte to fill in the log
+					buffer */
+	ulint		len;		/*!< number of bytes still to copy */
+};
+#endif /* LOG_CONCURRENT_COPY */
+
 /*******************************************************************//**
 Calculates where in log files we find a specified lsn.
 @return	log file number */
@@ -139,6 +155,39 @@ UNIV_INTERN
 lsn_t
 log_close(void);
 /*===========*/
+#ifdef LOG_CONCURRENT_COPY
+/************************************************************//**
+Reserves space in the log buffer for a string of the given length, the same
+way log_write_low would lay it out, but does not copy the string. The bytes
+must afterwards be copied with log_write_reserved and the reservation ended
+with log_write_reserved_complete; this may be done after log_release, so
+that mini-transactions can fill the log buffer in parallel. It is assumed
+that the caller holds the log mutex. */
+UNIV_INTERN
+void
+log_reserve_for_copy(
+/*=================*/
+	ulint		str_len,	/*!< in: string length */
+	log_copy_t*	copy);		/*!< out: reserved log buffer area */
+/************************************************************//**
+Copies a part of the string into a log buffer area reserved with
+log_reserve_for_copy. The caller need not hold the log mutex. */
+UNIV_INTERN
+void
+log_write_reserved(
+/*===============*/
+	log_copy_t*	copy,		/*!< in/out: reserved log buffer area */
+	const byte*	str,		/*!< in: string */
+	ulint		str_len);	/*!< in: string length */
+/************************************************************//**
+Marks a reserved log buffer area filled, so that the log writer may write
+it to the log files. The caller need not hold the log mutex. */
+UNIV_INTERN
+void
+log_write_reserved_complete(
+/*========================*/
+	log_copy_t*	copy);		/*!< in: reserved log buffer area */
+#endif /* LOG_CONCURRENT_COPY */
 /************************************************************//**
 Gets the current lsn.
 @return	current lsn */
@@ -855,6 +904,16 @@ struct log_t{
 					AND flushed to disk */
 	ulint		n_pending_writes;/*!< number of currently
 					pending flushes or writes */
+#ifdef LOG_CONCURRENT_COPY
+	volatile ulint	n_pending_copies;/*!< number of log buffer areas
+					that have been reserved by
+					log_reserve_for_copy() but not yet
+					filled; the log buffer contents may
+					not be written or moved before this
+					drops to zero. Incremented while
+					holding the log mutex, decremented
+					atomically without it. */
+#endif /* LOG_CONCURRENT_COPY */
 	/* NOTE on the 'flush' in names of the fields below: starting from
 	4.0.14, we separate the write of the log file and the actual fsync()
 	or other method to flush it to disk. The names below shhould really
@@ -444,6 +444,22 @@ struct recv_sys_t{
 	hash_table_t*	addr_hash;/*!< hash table of file addresses of pages */
 	ulint		n_addrs;/*!< number of not processed hashed file
 				addresses in the hash table */
+#ifndef UNIV_HOTBACKUP
+	ulint		apply_cell_next;
+				/*!< next addr_hash cell to be handed
+				to an apply thread in the current batch */
+	ulint		n_apply_threads;
+				/*!< number of recv_apply_thread instances
+				still running in the current batch */
+	ulint		apply_n_addrs_start;
+				/*!< n_addrs when the current batch
+				started */
+	ib_time_t	apply_start_time;
+				/*!< time when the current batch started */
+	ib_time_t	apply_progress_time;
+				/*!< time when the batch progress was last
+				reported */
+#endif /* !UNIV_HOTBACKUP */
 
 	recv_dblwr_t	dblwr;
 };
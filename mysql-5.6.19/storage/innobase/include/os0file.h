@@ -190,6 +190,11 @@ enum os_file_create_t {
 				wake the i/o-handler thread; this has
 				effect only in simulated aio */
 #define OS_FORCE_IBUF_AIO	2048	/*<! force ibuf use AIO with flash cache */
+#define OS_AIO_PAGE_COMPRESS	4096	/*!< This can be ORed to mode
+				in a write of an uncompressed page to a
+				tablespace that uses page compression:
+				the page is compressed and the unused
+				tail of it is punched out of the file */
 /* @} */
 
 #define OS_WIN31	1	/*!< Microsoft Windows 3.x */
@@ -880,6 +885,27 @@ os_file_set_eof(
 /*============*/
 	FILE*		file);	/*!< in: file to be truncated */
 /***********************************************************************//**
+Decompresses in place a page that was written with OS_AIO_PAGE_COMPRESS.
+Pages of other types are left alone.
+@return	false if the page is compressed and corrupted */
+UNIV_INTERN
+bool
+os_file_decompress_page(
+/*====================*/
+	byte*	page);	/*!< in/out: page of UNIV_PAGE_SIZE bytes */
+/***********************************************************************//**
+Truncates a file to the given size.
+@return	TRUE if success */
+UNIV_INTERN
+ibool
+os_file_truncate(
+/*=============*/
+	const char*	name,	/*!< in: name of the file, for error
+				messages */
+	os_file_t	file,	/*!< in: handle to a file */
+	os_offset_t	size)	/*!< in: new size of the file */
+	__attribute__((nonnull, warn_unused_result));
+/***********************************************************************//**
 NOTE! Use the corresponding macro os_file_flush(), not directly this function!
 Flushes the write buffers of a given file to the disk.
 @return	TRUE if success */
@@ -1081,6 +1107,28 @@ UNIV_INTERN
 void
 os_aio_free(void);
 /*=============*/
+/***********************************************************************
+Registers memory areas, normally the buffer pool chunks, that the aio
+requests read into or write from. With io_uring the areas are registered
+with the rings so that the requests using them do not need to map the
+pages of the buffer for every request. Must be called before the i/o
+handler threads are started. Does nothing if io_uring is not used or
+if the registration fails. */
+UNIV_INTERN
+void
+os_aio_register_buffers(
+/*====================*/
+	byte* const*	bufs,	/*!< in: start of each area */
+	const ulint*	lens,	/*!< in: length of each area */
+	ulint		n);	/*!< in: number of areas */
+/***********************************************************************
+Checks if memory areas have been registered with os_aio_register_buffers().
+The registered areas must not be freed while the rings use them.
+@return true if buffers are registered */
+UNIV_INTERN
+bool
+os_aio_buffers_registered(void);
+/*===========================*/
 
 /*******************************************************************//**
 NOTE! Use the corresponding macro os_aio(), not directly this function!
@@ -40,6 +40,12 @@ typedef unsigned long int	os_process_id_t;
 extern ibool os_use_large_pages;
 /* Large page size. This may be a boot-time option on some platforms */
 extern ulint os_large_page_size;
+/* Whether os_mem_alloc_large() asks for transparent huge pages with
+madvise() when it does not use SysV large pages */
+extern ibool os_use_transparent_huge_pages;
+
+/** Maximum number of NUMA nodes that os_mem_bind_node() can address */
+#define OS_NUMA_MAX_NODES	64
 
 /****************************************************************//**
 Converts the current process id to a number. It is not guaranteed that the
@@ -69,6 +75,30 @@ os_mem_free_large(
 					os_mem_alloc_large() */
 	ulint	size);			/*!< in: size returned by
 					os_mem_alloc_large() */
+/****************************************************************//**
+Returns the number of NUMA nodes of the machine.
+@return	number of nodes, or 1 if the machine has a single node or the
+number cannot be determined */
+UNIV_INTERN
+ulint
+os_numa_n_nodes(void);
+/*=================*/
+/****************************************************************//**
+Sets the memory policy of a memory block returned by
+os_mem_alloc_large() so that its pages are allocated on the given
+NUMA node. The pages that are already in use are not moved, so this
+must be called before the block is first written to.
+@return	true on success */
+UNIV_INTERN
+bool
+os_mem_bind_node(
+/*=============*/
+	void*	ptr,			/*!< in: pointer returned by
+					os_mem_alloc_large() */
+	ulint	size,			/*!< in: size returned by
+					os_mem_alloc_large() */
+	ulint	node);			/*!< in: NUMA node, less than
+					os_numa_n_nodes() */
 
 #ifndef UNIV_NONINL
 #include "os0proc.ic"
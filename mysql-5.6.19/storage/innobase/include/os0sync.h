@@ -434,6 +434,9 @@ Returns the old value of *ptr, atomically sets *ptr to new_val */
 # define os_atomic_test_and_set_ulint(ptr, new_val) \
 	__sync_lock_test_and_set(ptr, new_val)
 
+# define os_atomic_test_and_set_uint32(ptr, new_val) \
+	__sync_lock_test_and_set(ptr, (ib_uint32_t) new_val)
+
 #elif defined(HAVE_IB_SOLARIS_ATOMICS)
 
 # define HAVE_ATOMIC_BUILTINS
@@ -642,6 +645,24 @@ clobbered */
 # define IB_ATOMICS_STARTUP_MSG \
 	"Mutexes and rw_locks use InnoDB's own implementation"
 #endif
+
+/** Memory barriers: os_wmb orders the stores before it before those
+after it, and os_rmb does the same for loads. A thread that publishes
+a pointer to data initialized with plain stores uses os_wmb before the
+pointer store; the readers use os_rmb after the pointer load. */
+#if defined(__ATOMIC_ACQUIRE)
+# define os_rmb	__atomic_thread_fence(__ATOMIC_ACQUIRE)
+# define os_wmb	__atomic_thread_fence(__ATOMIC_RELEASE)
+#elif defined(__GNUC__)
+# define os_rmb	__sync_synchronize()
+# define os_wmb	__sync_synchronize()
+#elif defined(_WIN32)
+# define os_rmb	MemoryBarrier()
+# define os_wmb	MemoryBarrier()
+#else
+# error "No memory barrier is known for this compiler"
+#endif
+
 #ifdef HAVE_ATOMIC_BUILTINS
 #define os_atomic_inc_ulint(m,v,d)	os_atomic_increment_ulint(v, d)
 #define os_atomic_dec_ulint(m,v,d)	os_atomic_decrement_ulint(v, d)
@@ -685,6 +706,33 @@ for synchronization */
 		os_decrement_counter_by_amount(mutex, counter, 1);\
 	} while (0);
 
+#if defined(HAVE_IB_LINUX_FUTEX) && defined(HAVE_IB_GCC_ATOMIC_BUILTINS)
+/** InnoDB mutexes and rw-locks sleep on Linux futexes instead of
+reserving a cell in the sync array and waiting on an os_event_t */
+# define INNODB_SYNC_USE_FUTEX
+
+/**********************************************************//**
+Puts the calling thread to sleep on a futex word, unless the word no
+longer holds the expected value. Spurious wake-ups are possible: the
+caller must re-check its condition after this returns. */
+UNIV_INLINE
+void
+os_futex_wait(
+/*==========*/
+	volatile ib_uint32_t*	word,	/*!< in: futex word */
+	ib_uint32_t		val);	/*!< in: value *word must hold for
+					the thread to go to sleep */
+/**********************************************************//**
+Wakes up threads sleeping on a futex word. */
+UNIV_INLINE
+void
+os_futex_wake(
+/*==========*/
+	volatile ib_uint32_t*	word,	/*!< in: futex word */
+	ulint			n);	/*!< in: maximum number of threads
+					to wake up */
+#endif /* HAVE_IB_LINUX_FUTEX && HAVE_IB_GCC_ATOMIC_BUILTINS */
+
 #ifndef UNIV_NONINL
 #include "os0sync.ic"
 #endif
@@ -40,6 +40,14 @@ B-tree page that is the leftmost page on its level
 /* The deleted flag in info bits */
 #define REC_INFO_DELETED_FLAG	0x20UL	/* when bit is set to 1, it means the
 					record has been delete marked */
+/* Flag of ROW_FORMAT=COMPACT leaf records in a clustered index whose
+table has columns that were added by instant ADD COLUMN: the number
+of fields is stored in 1 or 2 bytes in front of the
+REC_N_NEW_EXTRA_BYTES, and any trailing fields that are not present
+take the default value of their column.  Records without this flag
+in such an index contain dict_index_get_n_core_fields() fields.
+This bit is not part of the info bits returned by rec_get_info_bits(). */
+#define REC_INFO_INSTANT_FLAG	0x80UL
 
 /* Number of extra bytes in an old-style record,
 in addition to the data and the offsets */
@@ -80,8 +88,12 @@ significant bit denotes that the tail of a field is stored off-page. */
 # define REC_OFFS_HEADER_SIZE	4
 #else /* UNIV_DEBUG */
 /* Length of the rec_get_offsets() header */
-# define REC_OFFS_HEADER_SIZE	2
+# define REC_OFFS_HEADER_SIZE	3
 #endif /* UNIV_DEBUG */
+/* Position of the index pointer in the rec_get_offsets() header;
+it is needed for looking up the default values of instantly
+added columns */
+#define REC_OFFS_INDEX		(REC_OFFS_HEADER_SIZE - 1)
 
 /* Number of elements that should be initially allocated for the
 offsets[] array, first passed to rec_get_offsets() */
@@ -231,6 +243,26 @@ rec_set_info_bits_new(
 	ulint	bits)	/*!< in: info bits */
 	__attribute__((nonnull));
 /******************************************************//**
+Determines whether a ROW_FORMAT=COMPACT record carries
+REC_INFO_INSTANT_FLAG.
+@return	nonzero if the record stores its number of fields */
+UNIV_INLINE
+ulint
+rec_get_instant_flag(
+/*=================*/
+	const rec_t*	rec)	/*!< in: new-style physical record */
+	__attribute__((nonnull, pure, warn_unused_result));
+/******************************************************//**
+Sets REC_INFO_INSTANT_FLAG of a ROW_FORMAT=COMPACT record. */
+UNIV_INLINE
+void
+rec_set_instant_flag(
+/*=================*/
+	rec_t*	rec,	/*!< in/out: new-style physical record */
+	ulint	flag)	/*!< in: nonzero if the record stores its
+			number of fields */
+	__attribute__((nonnull));
+/******************************************************//**
 The following function retrieves the status bits of a new-style record.
 @return	status bits */
 UNIV_INLINE
@@ -545,8 +577,58 @@ rec_get_nth_field_offs(
 	ulint*		len)	/*!< out: length of the field; UNIV_SQL_NULL
 				if SQL null */
 	__attribute__((nonnull));
-#define rec_get_nth_field(rec, offsets, n, len) \
-((rec) + rec_get_nth_field_offs(offsets, n, len))
+/************************************************************//**
+Gets the value of the nth field of a record. For a field that is
+not present in the record because its column was added by instant
+ADD COLUMN, the default value of the column is returned.
+@return	pointer to the field data */
+UNIV_INLINE
+const byte*
+rec_get_nth_field(
+/*==============*/
+	const rec_t*	rec,	/*!< in: record */
+	const ulint*	offsets,/*!< in: array returned by rec_get_offsets() */
+	ulint		n,	/*!< in: index of the field */
+	ulint*		len)	/*!< out: length of the field; UNIV_SQL_NULL
+				if SQL null */
+	__attribute__((nonnull));
+/************************************************************//**
+Gets the value of the nth field of a record. For a field that is
+not present in the record because its column was added by instant
+ADD COLUMN, the default value of the column is returned; it must
+not be modified.
+@return	pointer to the field data */
+UNIV_INLINE
+byte*
+rec_get_nth_field(
+/*==============*/
+	rec_t*		rec,	/*!< in: record */
+	const ulint*	offsets,/*!< in: array returned by rec_get_offsets() */
+	ulint		n,	/*!< in: index of the field */
+	ulint*		len)	/*!< out: length of the field; UNIV_SQL_NULL
+				if SQL null */
+	__attribute__((nonnull));
+/******************************************************//**
+Returns nonzero if the nth field is not present in the record and
+takes the default value of an instantly added column.
+@return	nonzero if the default value is used */
+UNIV_INLINE
+ulint
+rec_offs_nth_default(
+/*=================*/
+	const ulint*	offsets,/*!< in: array returned by rec_get_offsets() */
+	ulint		n)	/*!< in: nth field */
+	__attribute__((nonnull, pure, warn_unused_result));
+/******************************************************//**
+Determine if the offsets are for a record that lacks some instantly
+added trailing fields.
+@return	nonzero if some fields take their default values */
+UNIV_INLINE
+ulint
+rec_offs_any_default(
+/*=================*/
+	const ulint*	offsets)/*!< in: array returned by rec_get_offsets() */
+	__attribute__((nonnull, pure, warn_unused_result));
 /******************************************************//**
 Determine if the offsets are for a record in the new
 compact format.
@@ -427,4 +427,14 @@ row_merge_read_rec(
 					(non-NULL on I/O error) */
 	ulint*			offsets)/*!< out: offsets of mrec */
 	__attribute__((nonnull, warn_unused_result));
+
+#ifdef HAVE_PSI_STAGE_INTERFACE
+/** Performance schema stages of row_merge_build_indexes() */
+/* @{ */
+extern PSI_stage_info	row_merge_stage_read;
+extern PSI_stage_info	row_merge_stage_merge_sort;
+extern PSI_stage_info	row_merge_stage_insert;
+extern PSI_stage_info	row_merge_stage_log_apply;
+/* @} */
+#endif /* HAVE_PSI_STAGE_INTERFACE */
 #endif /* row0merge.h */
@@ -179,6 +179,14 @@ row_create_prebuilt(
 	ulint		mysql_row_len);	/*!< in: length in bytes of a row in
 					the MySQL format */
 /********************************************************************//**
+Frees the fetch cache of a prebuilt struct, after checking the magic
+numbers around each row. */
+UNIV_INTERN
+void
+row_prebuilt_free_fetch_cache(
+/*==========================*/
+	row_prebuilt_t*	prebuilt);	/*!< in/out: prebuilt struct */
+/********************************************************************//**
 Free a prebuilt struct for a MySQL table handle. */
 UNIV_INTERN
 void
@@ -645,7 +653,11 @@ struct mysql_row_templ_t {
 					it is an unsigned integer type */
 };
 
+/* Number of rows cached in the first batch of a scan; while the scan
+continues, the batch size is doubled up to MYSQL_FETCH_CACHE_MAX_BYTES */
 #define MYSQL_FETCH_CACHE_SIZE		8
+/* Memory budget of the fetch cache of one prebuilt struct */
+#define MYSQL_FETCH_CACHE_MAX_BYTES	(128 * 1024)
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
 
@@ -819,16 +831,21 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
-					/*!< a cache for fetched rows if we
+	byte*		fetch_cache;	/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
-					batch; we reserve mysql_row_len
-					bytes for each such row; these
-					pointers point 4 bytes past the
-					allocated mem buf start, because
-					there is a 4 byte magic number at the
-					start and at the end */
+					batch; this is a contiguous buffer of
+					fetch_cache_n_alloc slots, each
+					reserving mysql_row_len bytes between
+					a 4 byte magic number at the start
+					and at the end */
+	ulint		fetch_cache_n_alloc;/*!< number of row slots
+					allocated in fetch_cache */
+	ulint		fetch_cache_size;/*!< number of rows to cache in
+					the current batch; this starts from
+					MYSQL_FETCH_CACHE_SIZE when a cursor
+					is positioned and grows while the
+					scan continues */
 	ibool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
@@ -0,0 +1,54 @@
+/*****************************************************************************
+
+Copyright (c) 2026, the authors of this file.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/row0pread.h
+Parallel scan of a clustered index
+
+The index is split into key ranges at the node pointer records of an
+upper level of the tree, and the ranges are scanned by several threads
+under the read view of one transaction.
+*******************************************************/
+
+#ifndef row0pread_h
+#define row0pread_h
+
+#include "univ.i"
+#include "dict0types.h"
+#include "trx0types.h"
+
+/*********************************************************************//**
+Counts the records of a clustered index that are visible in the read
+view of a transaction, scanning the index with up to
+srv_parallel_read_threads threads. If check is set, the records are
+also checked to be in ascending order without duplicates; violations
+are reported to the error log and the scan continues.
+@return DB_SUCCESS, DB_CORRUPTION if the check failed, or another error
+code if the scan was stopped */
+UNIV_INTERN
+dberr_t
+row_pread_count(
+/*============*/
+	trx_t*		trx,	/*!< in: transaction that has a read view */
+	dict_index_t*	index,	/*!< in: clustered index */
+	bool		check,	/*!< in: whether to check the order
+				of the records */
+	ulint*		n_rows)	/*!< out: number of visible records */
+	__attribute__((nonnull, warn_unused_result));
+
+#endif /* row0pread_h */
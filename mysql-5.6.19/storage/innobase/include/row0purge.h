@@ -118,6 +118,10 @@ struct purge_node_t{
 	btr_pcur_t	pcur;	/*!< persistent cursor used in searching the
 				clustered index record */
 	ibool		done;	/* Debug flag */
+	ulint		n_recs_total;/*!< number of undo log records handed
+				to this node by all purge batches; the
+				records of a table in a batch are all
+				handed to the same node */
 
 };
 
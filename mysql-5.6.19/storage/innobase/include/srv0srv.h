@@ -141,6 +141,9 @@ extern os_event_t	srv_error_event;
 /** The buffer pool dump/load thread waits on this event. */
 extern os_event_t	srv_buf_dump_event;
 
+/** The buffer pool resize thread waits on this event. */
+extern os_event_t	srv_buf_resize_event;
+
 /** The buffer pool dump/load file name */
 #define SRV_BUF_DUMP_FILENAME_DEFAULT	"ib_buffer_pool"
 extern char*		srv_buf_dump_filename;
@@ -150,6 +153,10 @@ and/or load it during startup. */
 extern char		srv_buffer_pool_dump_at_shutdown;
 extern char		srv_buffer_pool_load_at_startup;
 
+/** Interval in seconds between periodic buffer pool dumps, 0 if
+the buffer pool is only dumped on request and at shutdown */
+extern ulong		srv_buf_dump_interval;
+
 /* Whether to disable file system cache if it is defined */
 extern char		srv_disable_sort_file_cache;
 
@@ -209,14 +216,30 @@ extern ibool	srv_locks_unsafe_for_binlog;
 
 /** Sort buffer size in index creation */
 extern ulong	srv_sort_buf_size;
+/** Number of threads that merge sort and insert the entries of the
+indexes being created */
+extern ulong	srv_sort_threads;
+/** Percentage of each index page that is filled when an index tree
+is built bottom-up */
+extern ulong	srv_fill_factor;
+/** Number of threads that scan a clustered index in parallel for
+COUNT(*) and CHECK TABLE */
+extern ulong	srv_parallel_read_threads;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long	srv_online_max_size;
+/** Number of threads that apply the modification log of a table
+that is being rebuilt online */
+extern ulong	srv_online_alter_apply_threads;
 
 /* If this flag is TRUE, then we will use the native aio of the
 OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
+/* If this flag is TRUE and native aio is used on Linux, the requests
+are submitted through io_uring instead of libaio when the kernel
+supports it */
+extern my_bool	srv_use_io_uring;
 #ifdef __WIN__
 extern ibool	srv_use_native_conditions;
 #endif /* __WIN__ */
@@ -272,6 +295,10 @@ extern ibool	srv_use_sys_malloc;
 #endif /* UNIV_HOTBACKUP */
 extern ulint	srv_buf_pool_size;	/*!< requested size in bytes */
 extern ulint    srv_buf_pool_instances; /*!< requested number of buffer pool instances */
+extern ulong	srv_buf_pool_chunk_unit;/*!< size of a buffer pool chunk,
+					the unit of online resizing */
+extern my_bool	srv_buf_pool_numa;	/*!< whether to bind the buffer
+					pool instances to NUMA nodes */
 extern ulong	srv_n_page_hash_locks;	/*!< number of locks to
 					protect buf_pool->page_hash */
 extern ulong	srv_LRU_scan_depth;	/*!< Scan depth for LRU
@@ -302,6 +329,13 @@ capacity. PCT_IO(5) -> returns the number of IO operations that
 is 5% of the max where max is srv_io_capacity.  */
 #define PCT_IO(p) ((ulong) (srv_io_capacity * ((double) (p) / 100.0)))
 
+/* Percentage of srv_io_capacity that the background change buffer
+merge reads per second when the change buffer is not over half full */
+extern ulong	srv_ibuf_merge_io_pct;
+/* Maximum number of pages read by one background change buffer merge
+batch */
+extern ulong	srv_ibuf_merge_batch;
+
 /* The "innodb_stats_method" setting, decides how InnoDB is going
 to treat NULL value when collecting statistics. It is not defined
 as enum type because the configure option takes unsigned integer type. */
@@ -343,8 +377,12 @@ extern unsigned long long	srv_stats_transient_sample_pages;
 extern my_bool			srv_stats_persistent;
 extern unsigned long long	srv_stats_persistent_sample_pages;
 extern my_bool			srv_stats_auto_recalc;
+/** Number of threads that recalculate persistent statistics in the
+background, and that analyze the indexes of one table in parallel */
+extern ulong			srv_stats_threads;
 
 extern ibool	srv_use_doublewrite_buf;
+extern my_bool	srv_dblwr_files;
 extern ulong	srv_doublewrite_batch_size;
 extern ulong	srv_checksum_algorithm;
 
@@ -371,6 +409,9 @@ extern ibool	srv_error_monitor_active;
 /* TRUE during the lifetime of the buffer pool dump/load thread */
 extern ibool	srv_buf_dump_thread_active;
 
+/* TRUE during the lifetime of the buffer pool resize thread */
+extern ibool	srv_buf_resize_thread_active;
+
 /* TRUE during the lifetime of the stats thread */
 extern ibool	srv_dict_stats_thread_active;
 
@@ -427,9 +468,26 @@ extern const char* srv_io_thread_function[];
 /* the number of purge threads to use from the worker pool (currently 0 or 1) */
 extern ulong srv_n_purge_threads;
 
+/** Maximum value of srv_n_purge_threads */
+#define SRV_MAX_N_PURGE_THREADS	32
+
 /* the number of pages to purge in one batch */
 extern ulong srv_purge_batch_size;
 
+/** Maximum value of srv_purge_batch_size, and of the batch size that
+srv_do_purge() grows it to while the history list keeps growing */
+#define SRV_PURGE_MAX_BATCH_SIZE	5000
+
+/* whether purge truncates undo tablespaces that have grown beyond
+srv_max_undo_log_size */
+extern my_bool srv_undo_log_truncate;
+
+/* size in bytes beyond which an undo tablespace is truncated */
+extern unsigned long long srv_max_undo_log_size;
+
+/* the number of threads applying redo log records during crash recovery */
+extern ulong srv_n_recv_apply_threads;
+
 /* the number of sync wait arrays */
 extern ulong srv_sync_array_size;
 
@@ -455,6 +513,12 @@ extern mysql_pfs_key_t	srv_monitor_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
 extern mysql_pfs_key_t	srv_purge_thread_key;
 extern mysql_pfs_key_t	recv_writer_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
+extern mysql_pfs_key_t	row_merge_thread_key;
+extern mysql_pfs_key_t	row_pread_thread_key;
+extern mysql_pfs_key_t	row_log_apply_thread_key;
+extern mysql_pfs_key_t	fil_load_thread_key;
+extern mysql_pfs_key_t	dict_stats_worker_thread_key;
 
 /* This macro register the current thread and its key with performance
 schema */
@@ -803,6 +867,8 @@ struct export_var_t{
 	ulint innodb_data_reads;		/*!< I/O read requests */
 	char  innodb_buffer_pool_dump_status[512];/*!< Buf pool dump status */
 	char  innodb_buffer_pool_load_status[512];/*!< Buf pool load status */
+	char  innodb_buffer_pool_resize_status[512];/*!< Buf pool resize
+						status */
 	ulint innodb_buffer_pool_pages_total;	/*!< Buffer pool size */
 	ulint innodb_buffer_pool_pages_data;	/*!< Data pages */
 	ulint innodb_buffer_pool_bytes_data;	/*!< File bytes used */
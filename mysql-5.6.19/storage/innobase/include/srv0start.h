@@ -164,4 +164,8 @@ extern	enum srv_shutdown_state	srv_shutdown_state;
 /** Log 'spaces' have id's >= this */
 #define SRV_LOG_SPACE_FIRST_ID		0xFFFFFFF0UL
 
+/** Initial size of an undo tablespace in pages (10MB) */
+#define SRV_UNDO_TABLESPACE_SIZE_IN_PAGES			\
+	((ulint) (((1024 * 1024) * 10) / UNIV_PAGE_SIZE_DEF))
+
 #endif
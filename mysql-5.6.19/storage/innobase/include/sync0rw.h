@@ -598,6 +598,15 @@ struct rw_lock_t {
 	os_event_t	wait_ex_event;
 				/*!< Event for next-writer to wait on. A thread
 				must decrement lock_word before waiting. */
+#ifdef INNODB_SYNC_USE_FUTEX
+	volatile ib_uint32_t	futex_seq;
+				/*!< Futex word that s-lock and x-lock
+				waiters sleep on instead of event; it is
+				incremented on every wake-up */
+	volatile ib_uint32_t	wait_ex_futex_seq;
+				/*!< Futex word that the next-writer sleeps
+				on instead of wait_ex_event */
+#endif /* INNODB_SYNC_USE_FUTEX */
 #ifndef INNODB_RW_LOCKS_USE_ATOMICS
 	ib_mutex_t	mutex;		/*!< The mutex protecting rw_lock_t */
 #endif /* INNODB_RW_LOCKS_USE_ATOMICS */
@@ -49,10 +49,22 @@ extern "C" my_bool	timed_mutexes;
 #ifdef HAVE_WINDOWS_ATOMICS
 typedef LONG lock_word_t;	/*!< On Windows, InterlockedExchange operates
 				on LONG variable */
+#elif defined(INNODB_SYNC_USE_FUTEX)
+typedef ib_uint32_t lock_word_t;/*!< futex(2) operates on a 32-bit word */
 #else
 typedef byte lock_word_t;
 #endif
 
+#ifdef INNODB_SYNC_USE_FUTEX
+/** Values of ib_mutex_t::lock_word when the mutex sleeps on a futex */
+enum mutex_futex_state {
+	MUTEX_FUTEX_FREE = 0,		/*!< not reserved */
+	MUTEX_FUTEX_LOCKED = 1,		/*!< reserved, no sleeping waiters */
+	MUTEX_FUTEX_CONTENDED = 2	/*!< reserved, and threads may be
+					sleeping on lock_word */
+};
+#endif /* INNODB_SYNC_USE_FUTEX */
+
 #if defined UNIV_PFS_MUTEX || defined UNIV_PFS_RWLOCK
 
 /* By default, buffer mutexes and rwlocks will be excluded from
@@ -113,6 +125,7 @@ extern mysql_pfs_key_t	srv_monitor_file_mutex_key;
 extern mysql_pfs_key_t	sync_thread_mutex_key;
 # endif /* UNIV_SYNC_DEBUG */
 extern mysql_pfs_key_t	buf_dblwr_mutex_key;
+extern mysql_pfs_key_t	buf_dblwr_file_mutex_key;
 extern mysql_pfs_key_t	trx_undo_mutex_key;
 extern mysql_pfs_key_t	trx_mutex_key;
 extern mysql_pfs_key_t	lock_sys_mutex_key;
@@ -732,6 +745,7 @@ or row lock! */
 #define SYNC_FC_HASH_RW		137
 #define SYNC_FC_BLOCK_MUTEX	136
 #define	SYNC_ANY_LATCH		135
+#define	SYNC_FIL_SPACE_HASH	134	/* fil_system->spaces rw_lock */
 #define	SYNC_MEM_HASH		131
 #define	SYNC_MEM_POOL		130
 
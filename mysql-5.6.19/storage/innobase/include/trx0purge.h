@@ -120,6 +120,34 @@ purge_state_t
 trx_purge_state(void);
 /*=================*/
 
+/*******************************************************************//**
+Estimates how long ago the oldest transaction whose undo log records
+have not been purged yet was committed.
+@return age in seconds */
+UNIV_INTERN
+ulint
+trx_purge_get_history_age(
+/*======================*/
+	bool*	at_least);	/*!< out: true if the transaction is older
+				than the oldest sample kept, and the age
+				is only a lower limit */
+
+/*******************************************************************//**
+Prints the number of undo log records handed to each purge worker and
+the age of the oldest unpurged history. */
+UNIV_INTERN
+void
+trx_purge_print(
+/*============*/
+	FILE*	file);	/*!< in: file where to print */
+
+/** Number of (time, transaction number) samples kept for estimating
+the age of the oldest unpurged history, see trx_purge_get_history_age() */
+#define TRX_PURGE_N_LAG_SAMPLES		128
+
+/** Minimum interval between two such samples, in seconds */
+#define TRX_PURGE_LAG_SAMPLE_INTERVAL	5
+
 /** This is the purge pointer/iterator. We need both the undo no and the
 transaction no up to which purge has parsed and applied the records. */
 struct purge_iter_t {
@@ -203,6 +231,24 @@ struct trx_purge_t{
 					rseg_queue_t::trx_no. It is protected
 					by the bh_mutex */
 	ib_mutex_t		bh_mutex;	/*!< Mutex protecting ib_bh */
+	/*-----------------------------*/
+	ib_time_t	lag_time[TRX_PURGE_N_LAG_SAMPLES];
+					/*!< Ring buffer of sample times;
+					written only by the purge
+					coordinator, read without latching
+					for monitoring output */
+	trx_id_t	lag_trx_no[TRX_PURGE_N_LAG_SAMPLES];
+					/*!< trx_sys->max_trx_id at the
+					corresponding lag_time */
+	ulint		lag_next;	/*!< Next slot to write in the ring */
+	/*-----------------------------*/
+	ulint		undo_trunc_space;/*!< Undo tablespace whose rollback
+					segments are being drained for
+					truncation, or ULINT_UNDEFINED;
+					written only by the purge
+					coordinator */
+	ulint		undo_trunc_last;/*!< Undo tablespace that was last
+					checked for truncation */
 };
 
 /** Info required to purge a record */
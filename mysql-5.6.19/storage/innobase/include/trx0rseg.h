@@ -189,6 +189,16 @@ struct trx_rseg_t{
 					yet purged log */
 	ibool		last_del_marks;	/*!< TRUE if the last not yet purged log
 					needs purging */
+	/*--------------------------------------------------------*/
+	bool		skip_allocation;/*!< true if the undo tablespace of
+					this rollback segment is being
+					drained for truncation; new
+					transactions are then not assigned
+					to it */
+	ulint		trx_ref_count;	/*!< number of transactions that have
+					been assigned this rollback segment
+					by trx_assign_rseg_low() and are not
+					yet committed; protected by mutex */
 };
 
 /** For prioritising the rollback segments for purge. */
@@ -183,6 +183,22 @@ UNIV_INLINE
 trx_id_t
 trx_sys_get_max_trx_id(void);
 /*========================*/
+/*****************************************************************//**
+Adds a transaction id to trx_sys->rw_trx_ids. The caller must hold
+trx_sys->mutex, unless the database is being started. */
+UNIV_INTERN
+void
+trx_sys_rw_trx_ids_add(
+/*===================*/
+	trx_id_t	id);	/*!< in: id of a read-write transaction */
+/*****************************************************************//**
+Removes a transaction id from trx_sys->rw_trx_ids, if it is there.
+The caller must hold trx_sys->mutex. */
+UNIV_INTERN
+void
+trx_sys_rw_trx_ids_remove(
+/*======================*/
+	trx_id_t	id);	/*!< in: id of a read-write transaction */
 
 #ifdef UNIV_DEBUG
 /* Flag to control TRX_RSEG_N_SLOTS behavior debugging. */
@@ -626,6 +642,26 @@ struct trx_sys_t{
 					memory read-write transactions, sorted
 					on trx id, biggest first. Recovered
 					transactions are always on this list. */
+	trx_id_t*	rw_trx_ids;	/*!< Ids of the transactions on
+					rw_trx_list, sorted in ascending
+					order, except those that were
+					recovered in the committed state
+					and those that are committing: the
+					id is removed before the locks of
+					the transaction are released.
+					A read view copies this array
+					instead of traversing rw_trx_list.
+					Allocated with ut_malloc(). */
+	ulint		n_rw_trx_ids;	/*!< Number of elements in
+					rw_trx_ids */
+	ulint		rw_trx_ids_size;/*!< Number of elements allocated
+					for rw_trx_ids */
+	trx_list_t	serialisation_list;
+					/*!< Transactions that have been
+					assigned trx_t::no and not yet been
+					removed from rw_trx_list or
+					ro_trx_list, sorted on trx_t::no,
+					smallest first */
 	trx_list_t	ro_trx_list;	/*!< List of active and committed in
 					memory read-only transactions, sorted
 					on trx id, biggest first. NOTE:
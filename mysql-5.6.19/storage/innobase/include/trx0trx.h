@@ -873,6 +873,16 @@ struct trx_t{
 					The same node is used for both
 					trx_sys_t::ro_trx_list and
 					trx_sys_t::rw_trx_list */
+	UT_LIST_NODE_T(trx_t)
+			no_list;	/*!< trx_sys_t::serialisation_list;
+					protected by trx_sys->mutex */
+	bool		in_serialisation_list;
+					/*!< true if the transaction is in
+					trx_sys->serialisation_list. A
+					recovered transaction can have
+					trx->no != TRX_ID_MAX without being
+					in the list. Protected by
+					trx_sys->mutex */
 #ifdef UNIV_DEBUG
 	/** The following two fields are mutually exclusive. */
 	/* @{ */
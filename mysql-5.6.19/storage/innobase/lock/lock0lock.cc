@@ -5211,6 +5211,8 @@ lock_print_info_summary(
 
 	fprintf(file, "\n");
 
+	trx_purge_print(file);
+
 	fprintf(file,
 		"History list length %lu\n",
 		(ulong) trx_sys->rseg_history_len);
@@ -184,6 +184,33 @@ log_buf_pool_get_oldest_modification(void)
 	return(lsn);
 }
 
+#ifdef LOG_CONCURRENT_COPY
+/************************************************************//**
+Waits until all the log buffer areas reserved by log_reserve_for_copy()
+have been filled. The caller must hold the log mutex, which prevents new
+reservations; the pending copies do not need the mutex to finish. */
+static
+void
+log_wait_for_pending_copies(void)
+/*=============================*/
+{
+	ulint	i = 0;
+
+	ut_ad(mutex_own(&(log_sys->mutex)));
+
+	while (log_sys->n_pending_copies > 0) {
+		if (i < SYNC_SPIN_ROUNDS) {
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+			i++;
+		} else {
+			os_thread_yield();
+		}
+	}
+}
+#else /* LOG_CONCURRENT_COPY */
+# define log_wait_for_pending_copies()	((void) 0)
+#endif /* LOG_CONCURRENT_COPY */
+
 /** Extends the log buffer.
 @param[in] len	requested minimum size in bytes */
 static
@@ -215,6 +242,8 @@ log_buffer_extend(
 
 	log_sys->is_extending = true;
 
+	log_wait_for_pending_copies();
+
 	while (log_sys->n_pending_writes != 0
 	       || ut_calc_align_down(log_sys->buf_free,
 				     OS_FILE_LOG_BLOCK_SIZE)
@@ -226,6 +255,8 @@ log_buffer_extend(
 		log_buffer_flush_to_disk();
 
 		mutex_enter(&(log_sys->mutex));
+
+		log_wait_for_pending_copies();
 	}
 
 	move_start = ut_calc_align_down(
@@ -437,6 +468,143 @@ part_loop:
 	srv_stats.log_write_requests.inc();
 }
 
+#ifdef LOG_CONCURRENT_COPY
+/************************************************************//**
+Reserves space in the log buffer for a string of the given length, the same
+way log_write_low would lay it out, but does not copy the string. The bytes
+must afterwards be copied with log_write_reserved and the reservation ended
+with log_write_reserved_complete; this may be done after log_release, so
+that mini-transactions can fill the log buffer in parallel. It is assumed
+that the caller holds the log mutex. */
+UNIV_INTERN
+void
+log_reserve_for_copy(
+/*=================*/
+	ulint		str_len,	/*!< in: string length */
+	log_copy_t*	copy)		/*!< out: reserved log buffer area */
+{
+	log_t*	log	= log_sys;
+	ulint	len;
+	ulint	data_len;
+	byte*	log_block;
+
+	ut_ad(mutex_own(&(log->mutex)));
+	ut_ad(!recv_no_log_write);
+
+	copy->ptr = log->buf + log->buf_free;
+	copy->len = str_len;
+
+	os_atomic_increment_ulint(&log->n_pending_copies, 1);
+
+	/* Advance buf_free and lsn block by block exactly like
+	log_write_low() does, initializing the block headers but
+	leaving the record bytes to the caller. */
+	while (str_len > 0) {
+		data_len = (log->buf_free % OS_FILE_LOG_BLOCK_SIZE) + str_len;
+
+		if (data_len <= OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+
+			len = str_len;
+		} else {
+			data_len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE;
+
+			len = OS_FILE_LOG_BLOCK_SIZE
+				- (log->buf_free % OS_FILE_LOG_BLOCK_SIZE)
+				- LOG_BLOCK_TRL_SIZE;
+		}
+
+		str_len -= len;
+
+		log_block = static_cast<byte*>(
+			ut_align_down(
+				log->buf + log->buf_free,
+				OS_FILE_LOG_BLOCK_SIZE));
+
+		log_block_set_data_len(log_block, data_len);
+
+		if (data_len == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* This block became full */
+			log_block_set_data_len(log_block,
+					       OS_FILE_LOG_BLOCK_SIZE);
+			log_block_set_checkpoint_no(
+				log_block, log_sys->next_checkpoint_no);
+			len += LOG_BLOCK_HDR_SIZE + LOG_BLOCK_TRL_SIZE;
+
+			log->lsn += len;
+
+			/* Initialize the next block header */
+			log_block_init(log_block + OS_FILE_LOG_BLOCK_SIZE,
+				       log->lsn);
+		} else {
+			log->lsn += len;
+		}
+
+		log->buf_free += len;
+
+		ut_ad(log->buf_free <= log->buf_size);
+	}
+
+	srv_stats.log_write_requests.inc();
+}
+
+/************************************************************//**
+Copies a part of the string into a log buffer area reserved with
+log_reserve_for_copy. The caller need not hold the log mutex. */
+UNIV_INTERN
+void
+log_write_reserved(
+/*===============*/
+	log_copy_t*	copy,		/*!< in/out: reserved log buffer area */
+	const byte*	str,		/*!< in: string */
+	ulint		str_len)	/*!< in: string length */
+{
+	ut_ad(str_len <= copy->len);
+
+	while (str_len > 0) {
+		ulint	offset;
+		ulint	len;
+
+		offset = ut_align_offset(copy->ptr, OS_FILE_LOG_BLOCK_SIZE);
+
+		ut_ad(offset >= LOG_BLOCK_HDR_SIZE);
+		ut_ad(offset < OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE);
+
+		len = ut_min(str_len,
+			     OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE
+			     - offset);
+
+		ut_memcpy(copy->ptr, str, len);
+
+		str += len;
+		str_len -= len;
+		copy->len -= len;
+		copy->ptr += len;
+
+		if (offset + len
+		    == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* Skip the trailer of this block and the header
+			of the next one, initialized by the reservation */
+			copy->ptr += LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+		}
+	}
+}
+
+/************************************************************//**
+Marks a reserved log buffer area filled, so that the log writer may write
+it to the log files. The caller need not hold the log mutex. */
+UNIV_INTERN
+void
+log_write_reserved_complete(
+/*========================*/
+	log_copy_t*	copy)		/*!< in: reserved log buffer area */
+{
+	ut_ad(copy->len == 0);
+	ut_ad(log_sys->n_pending_copies > 0);
+
+	os_atomic_decrement_ulint(&log_sys->n_pending_copies, 1);
+}
+#endif /* LOG_CONCURRENT_COPY */
+
 /************************************************************//**
 Closes the log.
 @return	lsn */
@@ -887,6 +1055,9 @@ log_init(void)
 	log_sys->written_to_all_lsn = log_sys->lsn;
 
 	log_sys->n_pending_writes = 0;
+#ifdef LOG_CONCURRENT_COPY
+	log_sys->n_pending_copies = 0;
+#endif /* LOG_CONCURRENT_COPY */
 
 	log_sys->no_flush_event = os_event_create();
 
@@ -1136,6 +1307,8 @@ log_sys_check_flush_completion(void)
 			/* Move the log buffer content to the start of the
 			buffer */
 
+			log_wait_for_pending_copies();
+
 			move_start = ut_calc_align_down(
 				log_sys->write_end_offset,
 				OS_FILE_LOG_BLOCK_SIZE);
@@ -1536,6 +1709,10 @@ loop:
 			log_sys->lsn);
 	}
 #endif /* UNIV_DEBUG */
+	/* Mini-transactions that reserved log buffer space before we
+	acquired the mutex may still be copying their records into it */
+	log_wait_for_pending_copies();
+
 	log_sys->n_pending_writes++;
 	MONITOR_INC(MONITOR_PENDING_LOG_WRITE);
 
@@ -72,6 +72,13 @@ this must be less than UNIV_PAGE_SIZE as it is stored in the buffer pool */
 /** Read-ahead area in applying log records to file pages */
 #define RECV_READ_AHEAD_AREA	32
 
+/** Number of addr_hash cells handed to an apply thread at a time */
+#define RECV_APPLY_BATCH_CELLS	64
+
+/** Minimum interval in seconds between two progress reports of an
+apply batch */
+#define RECV_APPLY_PROGRESS_INTERVAL	10
+
 /** The recovery system */
 UNIV_INTERN recv_sys_t*	recv_sys = NULL;
 /** TRUE when applying redo log records during crash recovery; FALSE
@@ -167,6 +174,7 @@ UNIV_INTERN mysql_pfs_key_t	recv_sys_mutex_key;
 #ifndef UNIV_HOTBACKUP
 # ifdef UNIV_PFS_THREAD
 UNIV_INTERN mysql_pfs_key_t	recv_writer_thread_key;
+UNIV_INTERN mysql_pfs_key_t	recv_apply_thread_key;
 # endif /* UNIV_PFS_THREAD */
 
 # ifdef UNIV_PFS_MUTEX
@@ -1831,48 +1839,77 @@ recv_read_in_area(
 }
 
 /*******************************************************************//**
-Empties the hash table of stored log records, applying them to appropriate
-pages. */
-UNIV_INTERN
+Reports the progress of the running apply batch, at most once in
+RECV_APPLY_PROGRESS_INTERVAL seconds unless this is the final report. */
+static
 void
-recv_apply_hashed_log_recs(
+recv_apply_report_progress(
 /*=======================*/
-	ibool	allow_ibuf)	/*!< in: if TRUE, also ibuf operations are
-				allowed during the application; if FALSE,
-				no ibuf operations are allowed, and after
-				the application all file pages are flushed to
-				disk and invalidated in buffer pool: this
-				alternative means that no new log records
-				can be generated during the application;
-				the caller must in this case own the log
-				mutex */
+	bool	final)	/*!< in: true if the batch has completed */
 {
-	recv_addr_t* recv_addr;
-	ulint	i;
-	ibool	has_printed	= FALSE;
-	mtr_t	mtr;
-loop:
-	mutex_enter(&(recv_sys->mutex));
+	ib_time_t	now;
+	ulint		elapsed;
+	ulint		n_done;
+	ulint		rate;
 
-	if (recv_sys->apply_batch_on) {
+	ut_ad(mutex_own(&recv_sys->mutex));
 
-		mutex_exit(&(recv_sys->mutex));
+	now = ut_time();
 
-		os_thread_sleep(500000);
+	if (!final
+	    && ut_difftime(now, recv_sys->apply_progress_time)
+	    < RECV_APPLY_PROGRESS_INTERVAL) {
 
-		goto loop;
+		return;
 	}
 
-	ut_ad(!allow_ibuf == mutex_own(&log_sys->mutex));
+	recv_sys->apply_progress_time = now;
 
-	if (!allow_ibuf) {
-		recv_no_ibuf_operations = TRUE;
+	elapsed = (ulint) ut_difftime(now, recv_sys->apply_start_time);
+
+	ut_ad(recv_sys->apply_n_addrs_start >= recv_sys->n_addrs);
+	n_done = recv_sys->apply_n_addrs_start - recv_sys->n_addrs;
+
+	rate = elapsed > 0 ? n_done / elapsed : n_done;
+
+	if (final) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Applied log records to %lu pages in %lu seconds"
+			" (%lu pages/s)",
+			(ulong) n_done, (ulong) elapsed, (ulong) rate);
+	} else {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Applied log records to %lu of %lu pages (%lu%%),"
+			" %lu pages/s, estimated %lu seconds remaining",
+			(ulong) n_done, (ulong) recv_sys->apply_n_addrs_start,
+			(ulong) (n_done * 100
+				 / recv_sys->apply_n_addrs_start),
+			(ulong) rate,
+			(ulong) (rate > 0 ? recv_sys->n_addrs / rate : 0));
 	}
+}
 
-	recv_sys->apply_log_recs = TRUE;
-	recv_sys->apply_batch_on = TRUE;
+/*******************************************************************//**
+Applies the log records of the pages hashed in a range of addr_hash cells.
+The pages which are not in the buffer pool are first read in with
+asynchronous read requests, so that the i/o handler threads apply their
+log records on read completion while this thread applies the records of
+the pages already in the buffer pool. */
+static
+void
+recv_apply_hashed_cells(
+/*====================*/
+	ulint	start,	/*!< in: first addr_hash cell */
+	ulint	end)	/*!< in: last addr_hash cell + 1 */
+{
+	recv_addr_t*	recv_addr;
+	ulint		i;
+	mtr_t		mtr;
 
-	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
+	ut_ad(mutex_own(&recv_sys->mutex));
+
+	/* Post the reads of the pages that are not in the buffer pool */
+	for (i = start; i < end; i++) {
 
 		for (recv_addr = static_cast<recv_addr_t*>(
 				HASH_GET_FIRST(recv_sys->addr_hash, i));
@@ -1881,20 +1918,40 @@ loop:
 				HASH_GET_NEXT(addr_hash, recv_addr))) {
 
 			ulint	space = recv_addr->space;
-			ulint	zip_size = fil_space_get_zip_size(space);
 			ulint	page_no = recv_addr->page_no;
 
 			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				if (!has_printed) {
-					ib_logf(IB_LOG_LEVEL_INFO,
-						"Starting an apply batch"
-						" of log records"
-						" to the database...");
-					fputs("InnoDB: Progress in percent: ",
-					      stderr);
-					has_printed = TRUE;
+
+				mutex_exit(&(recv_sys->mutex));
+
+				if (!buf_page_peek(space, page_no)) {
+					recv_read_in_area(
+						space,
+						fil_space_get_zip_size(space),
+						page_no);
 				}
 
+				mutex_enter(&(recv_sys->mutex));
+			}
+		}
+	}
+
+	/* Apply the log records of the pages that were already in the
+	buffer pool, and read in the ones evicted meanwhile */
+	for (i = start; i < end; i++) {
+
+		for (recv_addr = static_cast<recv_addr_t*>(
+				HASH_GET_FIRST(recv_sys->addr_hash, i));
+		     recv_addr != 0;
+		     recv_addr = static_cast<recv_addr_t*>(
+				HASH_GET_NEXT(addr_hash, recv_addr))) {
+
+			ulint	space = recv_addr->space;
+			ulint	zip_size = fil_space_get_zip_size(space);
+			ulint	page_no = recv_addr->page_no;
+
+			if (recv_addr->state == RECV_NOT_PROCESSED) {
+
 				mutex_exit(&(recv_sys->mutex));
 
 				if (buf_page_peek(space, page_no)) {
@@ -1918,32 +1975,147 @@ loop:
 				mutex_enter(&(recv_sys->mutex));
 			}
 		}
+	}
+}
 
-		if (has_printed
-		    && (i * 100) / hash_get_n_cells(recv_sys->addr_hash)
-		    != ((i + 1) * 100)
-		    / hash_get_n_cells(recv_sys->addr_hash)) {
+/*******************************************************************//**
+Takes ranges of addr_hash cells of the current apply batch until all
+of them have been handed out, and applies their log records. */
+static
+void
+recv_apply_hashed_batch(void)
+/*=========================*/
+{
+	ulint	n_cells = hash_get_n_cells(recv_sys->addr_hash);
 
-			fprintf(stderr, "%lu ", (ulong)
-				((i * 100)
-				 / hash_get_n_cells(recv_sys->addr_hash)));
-		}
+	ut_ad(mutex_own(&recv_sys->mutex));
+
+	while (recv_sys->apply_cell_next < n_cells) {
+		ulint	start = recv_sys->apply_cell_next;
+		ulint	end = ut_min(start + RECV_APPLY_BATCH_CELLS, n_cells);
+
+		recv_sys->apply_cell_next = end;
+
+		recv_apply_hashed_cells(start, end);
+
+		recv_apply_report_progress(false);
 	}
+}
+
+/******************************************************************//**
+Thread helping the recovery thread to apply the hashed log records of
+an apply batch to the pages.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(recv_apply_thread)(
+/*==============================*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(recv_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	mutex_enter(&recv_sys->mutex);
+
+	recv_apply_hashed_batch();
+
+	ut_ad(recv_sys->n_apply_threads > 0);
+	recv_sys->n_apply_threads--;
+
+	mutex_exit(&recv_sys->mutex);
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*******************************************************************//**
+Empties the hash table of stored log records, applying them to appropriate
+pages. The addr_hash cells are partitioned among the recovery thread and
+srv_n_recv_apply_threads - 1 helper threads. */
+UNIV_INTERN
+void
+recv_apply_hashed_log_recs(
+/*=======================*/
+	ibool	allow_ibuf)	/*!< in: if TRUE, also ibuf operations are
+				allowed during the application; if FALSE,
+				no ibuf operations are allowed, and after
+				the application all file pages are flushed to
+				disk and invalidated in buffer pool: this
+				alternative means that no new log records
+				can be generated during the application;
+				the caller must in this case own the log
+				mutex */
+{
+	ibool	has_printed	= FALSE;
+	ulint	i;
+loop:
+	mutex_enter(&(recv_sys->mutex));
+
+	if (recv_sys->apply_batch_on) {
+
+		mutex_exit(&(recv_sys->mutex));
+
+		os_thread_sleep(500000);
+
+		goto loop;
+	}
+
+	ut_ad(!allow_ibuf == mutex_own(&log_sys->mutex));
+
+	if (!allow_ibuf) {
+		recv_no_ibuf_operations = TRUE;
+	}
+
+	recv_sys->apply_log_recs = TRUE;
+	recv_sys->apply_batch_on = TRUE;
+
+	if (recv_sys->n_addrs != 0) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Starting an apply batch of log records"
+			" to %lu pages of the database...",
+			(ulong) recv_sys->n_addrs);
+		has_printed = TRUE;
+	}
+
+	recv_sys->apply_cell_next = 0;
+	recv_sys->apply_n_addrs_start = recv_sys->n_addrs;
+	recv_sys->apply_start_time = ut_time();
+	recv_sys->apply_progress_time = recv_sys->apply_start_time;
+
+	/* Start the helper threads, which exit as soon as all the
+	addr_hash cells have been handed out */
+	recv_sys->n_apply_threads = 0;
+
+	for (i = 1; has_printed && i < srv_n_recv_apply_threads; i++) {
+		recv_sys->n_apply_threads++;
+		os_thread_create(recv_apply_thread, NULL, NULL);
+	}
+
+	recv_apply_hashed_batch();
 
 	/* Wait until all the pages have been processed */
 
-	while (recv_sys->n_addrs != 0) {
+	while (recv_sys->n_apply_threads != 0 || recv_sys->n_addrs != 0) {
 
 		mutex_exit(&(recv_sys->mutex));
 
 		os_thread_sleep(500000);
 
 		mutex_enter(&(recv_sys->mutex));
+
+		recv_apply_report_progress(false);
 	}
 
 	if (has_printed) {
 
-		fprintf(stderr, "\n");
+		recv_apply_report_progress(true);
 	}
 
 	if (!allow_ibuf) {
@@ -460,8 +460,10 @@ mlog_open_and_write_index(
 	} else {
 		ulint	i;
 		ulint	n	= dict_index_get_n_fields(index);
+		ulint	instant	= dict_index_is_instant(index);
 		/* total size needed */
-		ulint	total	= 11 + size + (n + 2) * 2;
+		ulint	total	= 11 + size + (n + 2) * 2
+			+ (instant ? 2 : 0);
 		ulint	alloc	= total;
 		/* allocate at most DYN_ARRAY_DATA_SIZE at a time */
 		if (alloc > DYN_ARRAY_DATA_SIZE) {
@@ -474,11 +476,17 @@ mlog_open_and_write_index(
 		log_end = log_ptr + alloc;
 		log_ptr = mlog_write_initial_log_record_fast(rec, type,
 							     log_ptr, mtr);
-		mach_write_to_2(log_ptr, n);
+		/* The high-order bit of n tells that the number
+		of fields added by instant ADD COLUMN follows. */
+		mach_write_to_2(log_ptr, instant ? n | 0x8000 : n);
 		log_ptr += 2;
 		mach_write_to_2(log_ptr,
 				dict_index_get_n_unique_in_tree(index));
 		log_ptr += 2;
+		if (instant) {
+			mach_write_to_2(log_ptr, index->n_instant_fields);
+			log_ptr += 2;
+		}
 		for (i = 0; i < n; i++) {
 			dict_field_t*		field;
 			const dict_col_t*	col;
@@ -539,6 +547,7 @@ mlog_parse_index(
 	dict_index_t**	index)	/*!< out, own: dummy index */
 {
 	ulint		i, n, n_uniq;
+	ulint		n_instant	= 0;
 	dict_table_t*	table;
 	dict_index_t*	ind;
 
@@ -552,6 +561,15 @@ mlog_parse_index(
 		ptr += 2;
 		n_uniq = mach_read_from_2(ptr);
 		ptr += 2;
+		if (n & 0x8000) {
+			if (end_ptr < ptr + 2) {
+				return(NULL);
+			}
+			n &= 0x7fff;
+			n_instant = mach_read_from_2(ptr);
+			ptr += 2;
+			ut_a(n_instant && n_instant < n);
+		}
 		ut_ad(n_uniq <= n);
 		if (end_ptr < ptr + n * 2) {
 			return(NULL);
@@ -601,6 +619,16 @@ mlog_parse_index(
 			ind->fields[DATA_ROLL_PTR - 1 + n_uniq].col
 				= &table->cols[n + DATA_ROLL_PTR];
 		}
+		/* The default values of the instantly added columns
+		are not known here. They are not needed either, because
+		the records are only copied and modified physically. */
+		ind->n_instant_fields = (unsigned int) n_instant;
+		for (i = n - n_instant; i < n; i++) {
+			if (!(dict_index_get_nth_col(ind, i)->prtype
+			      & DATA_NOT_NULL)) {
+				ind->n_instant_nullable++;
+			}
+		}
 	}
 	/* avoid ut_ad(index->cached) in dict_index_get_n_unique_in_tree */
 	ind->cached = TRUE;
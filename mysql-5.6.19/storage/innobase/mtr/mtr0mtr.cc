@@ -279,16 +279,43 @@ mtr_log_reserve_and_write(
 	mtr->start_lsn = log_reserve_and_open(data_size);
 
 	if (mtr->log_mode == MTR_LOG_ALL) {
+#ifdef LOG_CONCURRENT_COPY
+		log_copy_t	copy;
+
+		/* Only reserve the log buffer space while holding the
+		log mutex, and copy the records after releasing it. The
+		log writer waits for the copy to complete before it
+		writes or moves this part of the log buffer. */
+
+		log_reserve_for_copy(data_size, &copy);
+
+		mtr->end_lsn = log_close();
+
+		mtr_add_dirtied_pages_to_flush_list(mtr);
 
 		for (dyn_block_t* block = mlog;
 		     block != 0;
 		     block = dyn_array_get_next_block(mlog, block)) {
 
-			log_write_low(
+			log_write_reserved(
+				&copy,
 				dyn_block_get_data(block),
 				dyn_block_get_used(block));
 		}
 
+		log_write_reserved_complete(&copy);
+
+		return;
+#else /* LOG_CONCURRENT_COPY */
+		for (dyn_block_t* block = mlog;
+		     block != 0;
+		     block = dyn_array_get_next_block(mlog, block)) {
+
+			log_write_low(
+				dyn_block_get_data(block),
+				dyn_block_get_used(block));
+		}
+#endif /* LOG_CONCURRENT_COPY */
 	} else {
 		ut_ad(mtr->log_mode == MTR_LOG_NONE
 		      || mtr->log_mode == MTR_LOG_NO_REDO);
@@ -45,6 +45,8 @@ Created 10/21/1995 Heikki Tuuri
 #include "fil0fil.h"
 #include "buf0buf.h"
 #include "srv0mon.h"
+#include "page0zip.h"
+#include "zlib.h"
 #ifndef UNIV_HOTBACKUP
 # include "os0sync.h"
 # include "os0thread.h"
@@ -61,6 +63,10 @@ Created 10/21/1995 Heikki Tuuri
 #include <libaio.h>
 #endif
 
+#if defined(LINUX_IO_URING)
+#include <liburing.h>
+#endif
+
 /** Insert buffer segment id */
 static const ulint IO_IBUF_SEGMENT = 0;
 
@@ -140,6 +146,22 @@ If an AIO request is made the calling thread not only queues it in the
 array but also submits the requests. The helper thread then collects
 the completed IO request and calls completion routine on it.
 
+Linux io_uring:
+===============
+
+If we have liburing installed and both innodb_use_native_aio and
+innodb_use_io_uring are set to TRUE, the native AIO code path submits
+the requests to an io_uring instead of an io_context. There is one ring
+per segment, just like the io_contexts. Requests posted with
+OS_AIO_SIMULATED_WAKE_LATER are only queued in the submission ring and
+are submitted in one system call by
+os_aio_simulated_wake_handler_threads(), which the read-ahead and flush
+code call after posting a batch. The buffer pool memory is registered
+with the rings, so that page reads and writes do not map the pages for
+every request. The helper thread polls the completion ring for a short
+while before it sleeps. If the kernel does not support io_uring, libaio
+is used.
+
 **********************************************************************/
 
 /** Flag: enable debug printout for asynchronous i/o */
@@ -166,6 +188,10 @@ struct os_aio_slot_t{
 	os_offset_t	offset;		/*!< file offset in bytes */
 	os_file_t	file;		/*!< file where to read or write */
 	const char*	name;		/*!< file name or path */
+	byte*		compress_buf;/*!< NULL, or the unaligned buffer
+					that holds the compressed copy of
+					the page that is written; freed
+					together with the slot */
 	ibool		io_already_done;/*!< used only in simulated aio:
 					TRUE if the physical i/o already
 					made and only the slot message
@@ -236,6 +262,15 @@ struct os_aio_array_t{
 				possible pending IO. The size of the
 				array is equal to n_slots. */
 #endif /* LINUX_NATIV_AIO */
+#if defined(LINUX_IO_URING)
+	struct io_uring*	uring;
+				/* rings used instead of aio_ctx
+				when io_uring is in use, one per
+				segment. The submission rings are
+				protected by the mutex, a completion
+				ring is only reaped by the i/o thread
+				of its segment. */
+#endif /* LINUX_IO_URING */
 };
 
 #if defined(LINUX_NATIVE_AIO)
@@ -249,6 +284,24 @@ struct os_aio_array_t{
 #define OS_AIO_IO_SETUP_RETRY_ATTEMPTS	5
 #endif
 
+#if defined(LINUX_IO_URING)
+/** number of times an i/o thread polls its completion ring before
+it waits in io_uring_wait_cqe_timeout(). */
+#define OS_AIO_URING_POLL_ROUNDS	64
+
+/** maximum size of a buffer registered with io_uring */
+#define OS_AIO_URING_MAX_FIXED_BUF	(1UL << 30)
+
+/** TRUE if native aio uses io_uring instead of libaio */
+static bool		os_aio_use_io_uring	= false;
+
+/** Buffers registered with every ring, NULL if none */
+static struct iovec*	os_aio_uring_bufs	= NULL;
+
+/** Number of buffers in os_aio_uring_bufs */
+static ulint		os_aio_uring_n_bufs	= 0;
+#endif /* LINUX_IO_URING */
+
 /** Array of events used in simulated aio */
 static os_event_t*	os_aio_segment_wait_events = NULL;
 
@@ -2187,6 +2240,187 @@ os_file_set_eof(
 #endif /* __WIN__ */
 }
 
+/***********************************************************************//**
+Truncates a file to the given size.
+@return	TRUE if success */
+UNIV_INTERN
+ibool
+os_file_truncate(
+/*=============*/
+	const char*	name,	/*!< in: name of the file, for error
+				messages */
+	os_file_t	file,	/*!< in: handle to a file */
+	os_offset_t	size)	/*!< in: new size of the file */
+{
+#ifdef __WIN__
+	LARGE_INTEGER	length;
+
+	length.QuadPart = size;
+
+	if (SetFilePointerEx(file, length, NULL, FILE_BEGIN)
+	    && SetEndOfFile(file)) {
+
+		return(TRUE);
+	}
+#else /* __WIN__ */
+	if (!ftruncate(file, size)) {
+
+		return(TRUE);
+	}
+#endif /* __WIN__ */
+
+	os_file_handle_error_no_exit(name, "truncate", FALSE);
+
+	return(FALSE);
+}
+
+/** Granularity of the writes of compressed pages: the size of the file
+system blocks that punching a hole releases */
+#define OS_FILE_PUNCH_HOLE_BLOCK	4096
+
+/** Set to false when the file system turns out not to support punching
+holes; page compression is then skipped, because it would not save any
+space */
+static bool	os_file_punch_hole_supported	= true;
+
+/***********************************************************************//**
+Releases the storage of a range of a file. Reads of the range return
+zeroes afterwards; the size of the file is not changed.
+@return	true if success */
+static
+bool
+os_file_punch_hole(
+/*===============*/
+	const char*	name,	/*!< in: name of the file, for error
+				messages */
+	os_file_t	file,	/*!< in: handle to a file */
+	os_offset_t	offset,	/*!< in: start of the range */
+	ulint		len)	/*!< in: length of the range in bytes */
+{
+#ifdef FALLOC_FL_PUNCH_HOLE
+	if (!fallocate(file, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+		       offset, len)) {
+
+		return(true);
+	}
+
+	if (errno != EOPNOTSUPP) {
+		os_file_handle_error_no_exit(name, "fallocate", FALSE);
+
+		return(false);
+	}
+#endif /* FALLOC_FL_PUNCH_HOLE */
+
+	if (os_file_punch_hole_supported) {
+		os_file_punch_hole_supported = false;
+
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Punching holes is not supported on the file "
+			"system of '%s'. Pages will be written "
+			"uncompressed.", name);
+	}
+
+	return(false);
+}
+
+/***********************************************************************//**
+Compresses a page for a write with OS_AIO_PAGE_COMPRESS. The FIL header
+is copied, except that FIL_PAGE_TYPE becomes FIL_PAGE_COMPRESSED and the
+original page type, the length of the compressed data and the algorithm
+are stored in the FIL_PAGE_FILE_FLUSH_LSN field, which is only used on
+page 0. The rest of the page is compressed with zlib at
+innodb_compression_level.
+@return number of bytes to write, a multiple of OS_FILE_PUNCH_HOLE_BLOCK,
+or 0 if compression would not release any file system block */
+static
+ulint
+os_file_compress_page(
+/*==================*/
+	const byte*	page,	/*!< in: uncompressed page */
+	byte*		out)	/*!< out: compressed page, UNIV_PAGE_SIZE
+				bytes */
+{
+	uLongf	out_len;
+	ulint	len;
+
+	if (UNIV_PAGE_SIZE <= OS_FILE_PUNCH_HOLE_BLOCK) {
+		return(0);
+	}
+
+	out_len = UNIV_PAGE_SIZE - OS_FILE_PUNCH_HOLE_BLOCK - FIL_PAGE_DATA;
+
+	if (compress2(out + FIL_PAGE_DATA, &out_len, page + FIL_PAGE_DATA,
+		      UNIV_PAGE_SIZE - FIL_PAGE_DATA,
+		      static_cast<int>(page_zip_level)) != Z_OK) {
+		/* The page did not fit in one block less. */
+		return(0);
+	}
+
+	memcpy(out, page, FIL_PAGE_DATA);
+	mach_write_to_2(out + FIL_PAGE_TYPE, FIL_PAGE_COMPRESSED);
+	memset(out + FIL_PAGE_FILE_FLUSH_LSN, 0, 8);
+	mach_write_to_2(out + FIL_PAGE_COMPRESS_ORIG_TYPE,
+			mach_read_from_2(page + FIL_PAGE_TYPE));
+	mach_write_to_2(out + FIL_PAGE_COMPRESS_SIZE, out_len);
+	mach_write_to_1(out + FIL_PAGE_COMPRESS_ALGORITHM,
+			FIL_PAGE_COMPRESS_ZLIB);
+
+	len = ut_calc_align(FIL_PAGE_DATA + out_len,
+			    OS_FILE_PUNCH_HOLE_BLOCK);
+
+	memset(out + FIL_PAGE_DATA + out_len, 0,
+	       len - FIL_PAGE_DATA - out_len);
+
+	return(len);
+}
+
+/***********************************************************************//**
+Decompresses in place a page that was written with OS_AIO_PAGE_COMPRESS.
+Pages of other types are left alone.
+@return	false if the page is compressed and corrupted */
+UNIV_INTERN
+bool
+os_file_decompress_page(
+/*====================*/
+	byte*	page)	/*!< in/out: page of UNIV_PAGE_SIZE bytes */
+{
+	byte*	buf;
+	uLongf	len;
+	ulint	size;
+	bool	success;
+
+	if (mach_read_from_2(page + FIL_PAGE_TYPE) != FIL_PAGE_COMPRESSED) {
+		return(true);
+	}
+
+	size = mach_read_from_2(page + FIL_PAGE_COMPRESS_SIZE);
+
+	if (mach_read_from_1(page + FIL_PAGE_COMPRESS_ALGORITHM)
+	    != FIL_PAGE_COMPRESS_ZLIB
+	    || FIL_PAGE_DATA + size > UNIV_PAGE_SIZE) {
+
+		return(false);
+	}
+
+	buf = static_cast<byte*>(ut_malloc(UNIV_PAGE_SIZE));
+	len = UNIV_PAGE_SIZE - FIL_PAGE_DATA;
+
+	success = uncompress(buf, &len, page + FIL_PAGE_DATA, size) == Z_OK
+		&& len == UNIV_PAGE_SIZE - FIL_PAGE_DATA;
+
+	if (success) {
+		memcpy(page + FIL_PAGE_DATA, buf, len);
+		mach_write_to_2(page + FIL_PAGE_TYPE,
+				mach_read_from_2(
+					page + FIL_PAGE_COMPRESS_ORIG_TYPE));
+		memset(page + FIL_PAGE_FILE_FLUSH_LSN, 0, 8);
+	}
+
+	ut_free(buf);
+
+	return(success);
+}
+
 #ifndef __WIN__
 /***********************************************************************//**
 Wrapper to fsync(2) that retries the call on some errors.
@@ -3682,6 +3916,368 @@ os_aio_native_aio_supported(void)
 }
 #endif /* LINUX_NATIVE_AIO */
 
+#if defined(LINUX_IO_URING)
+/******************************************************************//**
+Checks if the kernel supports io_uring with the read and write
+operations that we use. The kernel must also take the timeout of
+io_uring_wait_cqe_timeout() as an argument (IORING_FEAT_EXT_ARG);
+otherwise liburing submits a timeout SQE, which the i/o threads would
+do without holding array->mutex, racing os_aio_uring_dispatch().
+@return true if supported */
+static
+bool
+os_aio_uring_supported(void)
+/*========================*/
+{
+	struct io_uring		ring;
+	struct io_uring_probe*	probe;
+	bool			supported;
+	int			ret;
+
+	ret = io_uring_queue_init(1, &ring, 0);
+
+	if (ret < 0) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"io_uring_queue_init() failed with error %d", -ret);
+
+		return(false);
+	}
+
+#ifdef IORING_FEAT_EXT_ARG
+	if (!(ring.features & IORING_FEAT_EXT_ARG)) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"io_uring does not support IORING_FEAT_EXT_ARG");
+
+		io_uring_queue_exit(&ring);
+
+		return(false);
+	}
+#else
+	io_uring_queue_exit(&ring);
+
+	return(false);
+#endif /* IORING_FEAT_EXT_ARG */
+
+	probe = io_uring_get_probe_ring(&ring);
+
+	supported = probe != NULL
+		&& io_uring_opcode_supported(probe, IORING_OP_READ)
+		&& io_uring_opcode_supported(probe, IORING_OP_WRITE)
+		&& io_uring_opcode_supported(probe, IORING_OP_READ_FIXED)
+		&& io_uring_opcode_supported(probe, IORING_OP_WRITE_FIXED);
+
+	if (probe != NULL) {
+		io_uring_free_probe(probe);
+	}
+
+	io_uring_queue_exit(&ring);
+
+	return(supported);
+}
+
+/******************************************************************//**
+Looks up the registered buffer that contains an i/o buffer.
+@return index of the registered buffer, or -1 if none */
+static
+int
+os_aio_uring_get_fixed_buf(
+/*=======================*/
+	const byte*	buf,	/*!< in: i/o buffer */
+	ulint		len)	/*!< in: length of the i/o */
+{
+	for (ulint i = 0; i < os_aio_uring_n_bufs; ++i) {
+		const byte*	start = static_cast<const byte*>(
+			os_aio_uring_bufs[i].iov_base);
+
+		if (buf >= start
+		    && buf + len <= start + os_aio_uring_bufs[i].iov_len) {
+
+			return(static_cast<int>(i));
+		}
+	}
+
+	return(-1);
+}
+
+/******************************************************************//**
+Submits the requests queued in the submission ring of a segment. The
+caller must hold the array mutex. */
+static
+void
+os_aio_uring_submit_low(
+/*====================*/
+	os_aio_array_t*	array,	/*!< in: aio array */
+	ulint		segment)/*!< in: local segment number */
+{
+	struct io_uring*	ring = &array->uring[segment];
+	int			ret;
+
+	while (io_uring_sq_ready(ring) > 0) {
+
+		ret = io_uring_submit(ring);
+
+		if (ret >= 0) {
+			continue;
+		}
+
+		switch (ret) {
+		case -EAGAIN:
+		case -EINTR:
+			/* Not enough resources or interrupted:
+			try again. */
+			os_thread_yield();
+			continue;
+		}
+
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			" InnoDB: unexpected ret_code[%d]"
+			" from io_uring_submit()!\n", ret);
+		ut_error;
+	}
+}
+
+/******************************************************************//**
+Submits the requests that were queued in the submission rings of all
+segments of an aio array. */
+static
+void
+os_aio_uring_submit_array(
+/*======================*/
+	os_aio_array_t*	array)	/*!< in: aio array, or NULL */
+{
+	if (array == NULL || array->uring == NULL) {
+		return;
+	}
+
+	os_mutex_enter(array->mutex);
+
+	for (ulint i = 0; i < array->n_segments; ++i) {
+		os_aio_uring_submit_low(array, i);
+	}
+
+	os_mutex_exit(array->mutex);
+}
+
+/******************************************************************//**
+Submits the requests that were posted with OS_AIO_SIMULATED_WAKE_LATER
+and have only been queued in the submission rings. */
+static
+void
+os_aio_uring_submit_all(void)
+/*=========================*/
+{
+	os_aio_uring_submit_array(os_aio_read_array);
+	os_aio_uring_submit_array(os_aio_write_array);
+	os_aio_uring_submit_array(os_aio_ibuf_array);
+	os_aio_uring_submit_array(os_aio_log_array);
+	os_aio_uring_submit_array(os_aio_fc_read_array);
+	os_aio_uring_submit_array(os_aio_fc_write_array);
+}
+
+/*******************************************************************//**
+Queues an AIO request in the io_uring of the segment of the slot and
+submits it unless the caller asked to submit it later.
+@return	TRUE on success. */
+static
+ibool
+os_aio_uring_dispatch(
+/*==================*/
+	os_aio_array_t*	array,	/*!< in: io request array. */
+	os_aio_slot_t*	slot,	/*!< in: an already reserved slot. */
+	bool		submit)	/*!< in: false if the request is to be
+				submitted by a later call to
+				os_aio_simulated_wake_handler_threads() */
+{
+	struct io_uring_sqe*	sqe;
+	ulint			segment;
+	int			buf_index;
+
+	segment = (slot->pos * array->n_segments) / array->n_slots;
+	buf_index = os_aio_uring_get_fixed_buf(slot->buf, slot->len);
+
+	os_mutex_enter(array->mutex);
+
+	/* The submission ring has room for every slot of the segment,
+	so there is always a free entry. */
+	sqe = io_uring_get_sqe(&array->uring[segment]);
+	ut_a(sqe != NULL);
+
+	if (slot->type == OS_FILE_READ) {
+		if (buf_index >= 0) {
+			io_uring_prep_read_fixed(
+				sqe, slot->file, slot->buf,
+				static_cast<unsigned>(slot->len),
+				slot->offset, buf_index);
+		} else {
+			io_uring_prep_read(
+				sqe, slot->file, slot->buf,
+				static_cast<unsigned>(slot->len),
+				slot->offset);
+		}
+	} else {
+		ut_a(slot->type == OS_FILE_WRITE);
+
+		if (buf_index >= 0) {
+			io_uring_prep_write_fixed(
+				sqe, slot->file, slot->buf,
+				static_cast<unsigned>(slot->len),
+				slot->offset, buf_index);
+		} else {
+			io_uring_prep_write(
+				sqe, slot->file, slot->buf,
+				static_cast<unsigned>(slot->len),
+				slot->offset);
+		}
+	}
+
+	io_uring_sqe_set_data(sqe, slot);
+
+	slot->n_bytes = 0;
+	slot->ret = 0;
+
+	if (submit) {
+		os_aio_uring_submit_low(array, segment);
+	}
+
+	os_mutex_exit(array->mutex);
+
+	return(TRUE);
+}
+
+/******************************************************************//**
+This function is only used with io_uring. It is called from within the
+io-thread when there are no completed IO requests in the segment. It
+first submits the requests still queued in the submission ring of the
+segment, then polls the completion ring for a while and finally waits
+for a completion with a timeout, so that the io-thread can check the
+server status. */
+static
+void
+os_aio_uring_collect(
+/*=================*/
+	os_aio_array_t* array,		/*!< in/out: slot array. */
+	ulint		segment,	/*!< in: local segment no. */
+	ulint		seg_size)	/*!< in: segment size. */
+{
+	struct io_uring*	ring = &array->uring[segment];
+	struct io_uring_cqe*	cqe = NULL;
+	struct __kernel_timespec timeout;
+	unsigned		head;
+	unsigned		n_reaped = 0;
+	ulint			start_pos = segment * seg_size;
+	int			ret;
+
+	os_mutex_enter(array->mutex);
+	os_aio_uring_submit_low(array, segment);
+	os_mutex_exit(array->mutex);
+
+	for (ulint i = 0; i < OS_AIO_URING_POLL_ROUNDS; ++i) {
+		if (io_uring_peek_cqe(ring, &cqe) == 0 && cqe != NULL) {
+			goto reap;
+		}
+
+		ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+	}
+
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = OS_AIO_REAP_TIMEOUT;
+
+	ret = io_uring_wait_cqe_timeout(ring, &cqe, &timeout);
+
+	switch (ret) {
+	case 0:
+		break;
+	case -ETIME:
+		/* No completed request: the caller checks the server
+		status and calls us again. */
+	case -EAGAIN:
+	case -EINTR:
+		return;
+	default:
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			" InnoDB: unexpected ret_code[%d]"
+			" from io_uring_wait_cqe_timeout()!\n", ret);
+		ut_error;
+	}
+
+reap:
+	io_uring_for_each_cqe(ring, head, cqe) {
+		os_aio_slot_t*	slot;
+
+		slot = static_cast<os_aio_slot_t*>(io_uring_cqe_get_data(cqe));
+
+		/* Some sanity checks. */
+		ut_a(slot != NULL);
+		ut_a(slot->reserved);
+		ut_a(slot->pos >= start_pos);
+		ut_a(slot->pos < start_pos + seg_size);
+
+		/* Mark this request as completed. The error handling
+		will be done in the calling function. */
+		os_mutex_enter(array->mutex);
+		if (cqe->res >= 0) {
+			slot->n_bytes = cqe->res;
+			slot->ret = 0;
+		} else {
+			slot->n_bytes = 0;
+			slot->ret = cqe->res;
+		}
+		slot->io_already_done = TRUE;
+		os_mutex_exit(array->mutex);
+
+		++n_reaped;
+	}
+
+	io_uring_cq_advance(ring, n_reaped);
+}
+
+/******************************************************************//**
+Registers a set of buffers with the rings of an aio array.
+@return 0 or -errno */
+static
+int
+os_aio_uring_register_array(
+/*========================*/
+	os_aio_array_t*	array)	/*!< in: aio array, or NULL */
+{
+	if (array == NULL || array->uring == NULL) {
+		return(0);
+	}
+
+	for (ulint i = 0; i < array->n_segments; ++i) {
+		int	ret = io_uring_register_buffers(
+			&array->uring[i], os_aio_uring_bufs,
+			static_cast<unsigned>(os_aio_uring_n_bufs));
+
+		if (ret < 0) {
+			return(ret);
+		}
+	}
+
+	return(0);
+}
+
+/******************************************************************//**
+Unregisters the buffers from the rings of an aio array. */
+static
+void
+os_aio_uring_unregister_array(
+/*==========================*/
+	os_aio_array_t*	array)	/*!< in: aio array, or NULL */
+{
+	if (array == NULL || array->uring == NULL) {
+		return;
+	}
+
+	for (ulint i = 0; i < array->n_segments; ++i) {
+		/* Fails harmlessly if nothing was registered */
+		io_uring_unregister_buffers(&array->uring[i]);
+	}
+}
+#endif /* LINUX_IO_URING */
+
 /******************************************************************//**
 Creates an aio wait array. Note that we return NULL in case of failure.
 We don't care about freeing memory here because we assume that a
@@ -3735,6 +4331,33 @@ os_aio_array_create(
 		goto skip_native_aio;
 	}
 
+#if defined(LINUX_IO_URING)
+	array->uring = NULL;
+
+	if (os_aio_use_io_uring) {
+		/* One ring per segment, with room for every slot of
+		the segment in the submission ring. */
+		array->uring = static_cast<struct io_uring*>(
+			ut_malloc(n_segments * sizeof(*array->uring)));
+
+		for (ulint i = 0; i < n_segments; ++i) {
+			int	ret = io_uring_queue_init(
+				static_cast<unsigned>(n / n_segments),
+				&array->uring[i], 0);
+
+			if (ret < 0) {
+				ib_logf(IB_LOG_LEVEL_ERROR,
+					"io_uring_queue_init() failed "
+					"with error %d", -ret);
+
+				return(NULL);
+			}
+		}
+
+		goto skip_native_aio;
+	}
+#endif /* LINUX_IO_URING */
+
 	/* Initialize the io_context array. One io_context
 	per segment in the array. */
 
@@ -3770,6 +4393,7 @@ skip_native_aio:
 
 		slot->pos = i;
 		slot->reserved = FALSE;
+		slot->compress_buf = NULL;
 #ifdef WIN_ASYNC_IO
 		slot->handle = CreateEvent(NULL,TRUE, FALSE, NULL);
 
@@ -3820,6 +4444,16 @@ os_aio_array_free(
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+#if defined(LINUX_IO_URING)
+	if (array->uring != NULL) {
+		for (ulint i = 0; i < array->n_segments; ++i) {
+			io_uring_queue_exit(&array->uring[i]);
+		}
+
+		ut_free(array->uring);
+	}
+#endif /* LINUX_IO_URING */
+
 	ut_free(array->slots);
 	ut_free(array);
 
@@ -3856,6 +4490,32 @@ os_aio_init(
 	}
 #endif /* LINUX_NATIVE_AIO */
 
+#if defined(LINUX_IO_URING)
+	if (srv_use_native_aio && srv_use_io_uring) {
+
+		if (os_aio_uring_supported()) {
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Using io_uring for native AIO");
+
+			os_aio_use_io_uring = true;
+		} else {
+			ib_logf(IB_LOG_LEVEL_WARN,
+				"io_uring is not supported by the kernel, "
+				"using libaio for native AIO.");
+
+			srv_use_io_uring = FALSE;
+		}
+	}
+#else
+	if (srv_use_io_uring) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"innodb_use_io_uring is ignored because io_uring "
+			"support was not compiled in.");
+
+		srv_use_io_uring = FALSE;
+	}
+#endif /* LINUX_IO_URING */
+
 	srv_reset_io_thread_op_info();
 
 	os_aio_read_array = os_aio_array_create(
@@ -4001,6 +4661,127 @@ os_aio_free(void)
 	ut_free(os_aio_segment_wait_events);
 	os_aio_segment_wait_events = 0;
 	os_aio_n_segments = 0;
+
+#if defined(LINUX_IO_URING)
+	/* The registrations went away with the rings */
+	ut_free(os_aio_uring_bufs);
+	os_aio_uring_bufs = NULL;
+	os_aio_uring_n_bufs = 0;
+	os_aio_use_io_uring = false;
+#endif /* LINUX_IO_URING */
+}
+
+/***********************************************************************
+Registers memory areas, normally the buffer pool chunks, that the aio
+requests read into or write from. With io_uring the areas are registered
+with the rings so that the requests using them do not need to map the
+pages of the buffer for every request. Must be called before the i/o
+handler threads are started. Does nothing if io_uring is not used or
+if the registration fails. */
+UNIV_INTERN
+void
+os_aio_register_buffers(
+/*====================*/
+	byte* const*	bufs,	/*!< in: start of each area */
+	const ulint*	lens,	/*!< in: length of each area */
+	ulint		n)	/*!< in: number of areas */
+{
+#if defined(LINUX_IO_URING)
+	ulint	n_bufs = 0;
+	int	ret;
+
+	if (!os_aio_use_io_uring || n == 0) {
+		return;
+	}
+
+	ut_a(os_aio_uring_bufs == NULL);
+
+	/* A registered buffer can be at most 1GB */
+	for (ulint i = 0; i < n; ++i) {
+		n_bufs += (lens[i] + OS_AIO_URING_MAX_FIXED_BUF - 1)
+			/ OS_AIO_URING_MAX_FIXED_BUF;
+	}
+
+	os_aio_uring_bufs = static_cast<struct iovec*>(
+		ut_malloc(n_bufs * sizeof(*os_aio_uring_bufs)));
+
+	n_bufs = 0;
+
+	for (ulint i = 0; i < n; ++i) {
+		for (ulint off = 0; off < lens[i];
+		     off += OS_AIO_URING_MAX_FIXED_BUF) {
+
+			os_aio_uring_bufs[n_bufs].iov_base = bufs[i] + off;
+			os_aio_uring_bufs[n_bufs].iov_len = ut_min(
+				lens[i] - off, OS_AIO_URING_MAX_FIXED_BUF);
+			++n_bufs;
+		}
+	}
+
+	os_aio_uring_n_bufs = n_bufs;
+
+	ret = os_aio_uring_register_array(os_aio_read_array);
+
+	if (ret == 0) {
+		ret = os_aio_uring_register_array(os_aio_write_array);
+	}
+
+	if (ret == 0) {
+		ret = os_aio_uring_register_array(os_aio_ibuf_array);
+	}
+
+	if (ret == 0) {
+		ret = os_aio_uring_register_array(os_aio_log_array);
+	}
+
+	if (ret == 0) {
+		ret = os_aio_uring_register_array(os_aio_fc_read_array);
+	}
+
+	if (ret == 0) {
+		ret = os_aio_uring_register_array(os_aio_fc_write_array);
+	}
+
+	if (ret == 0) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Registered %lu buffers with io_uring",
+			(ulong) n_bufs);
+
+		return;
+	}
+
+	/* Most likely RLIMIT_MEMLOCK is too small for the buffer pool */
+	ib_logf(IB_LOG_LEVEL_WARN,
+		"Cannot register the buffer pool with io_uring, error %d. "
+		"Continuing without registered buffers.", -ret);
+
+	os_aio_uring_unregister_array(os_aio_read_array);
+	os_aio_uring_unregister_array(os_aio_write_array);
+	os_aio_uring_unregister_array(os_aio_ibuf_array);
+	os_aio_uring_unregister_array(os_aio_log_array);
+	os_aio_uring_unregister_array(os_aio_fc_read_array);
+	os_aio_uring_unregister_array(os_aio_fc_write_array);
+
+	ut_free(os_aio_uring_bufs);
+	os_aio_uring_bufs = NULL;
+	os_aio_uring_n_bufs = 0;
+#endif /* LINUX_IO_URING */
+}
+
+/***********************************************************************
+Checks if memory areas have been registered with os_aio_register_buffers().
+The registered areas must not be freed while the rings use them.
+@return true if buffers are registered */
+UNIV_INTERN
+bool
+os_aio_buffers_registered(void)
+/*===========================*/
+{
+#if defined(LINUX_IO_URING)
+	return(os_aio_uring_n_bufs > 0);
+#else
+	return(false);
+#endif /* LINUX_IO_URING */
 }
 
 #ifdef WIN_ASYNC_IO
@@ -4220,7 +5001,11 @@ os_aio_array_reserve_slot(
 	void*		buf,	/*!< in: buffer where to read or from which
 				to write */
 	os_offset_t	offset,	/*!< in: file offset */
-	ulint		len)	/*!< in: length of the block to read or write */
+	ulint		len,	/*!< in: length of the block to read or write */
+	byte*		compress_buf)
+				/*!< in, own: NULL, or the unaligned
+				buffer that contains buf, to be freed
+				when the slot is freed */
 {
 	os_aio_slot_t*	slot = NULL;
 #ifdef WIN_ASYNC_IO
@@ -4308,6 +5093,7 @@ found:
 	slot->len      = len;
 	slot->type     = type;
 	slot->buf      = static_cast<byte*>(buf);
+	slot->compress_buf = compress_buf;
 	slot->offset   = offset;
 	slot->io_already_done = FALSE;
 
@@ -4360,6 +5146,13 @@ os_aio_array_free_slot(
 	os_aio_array_t*	array,	/*!< in: aio array */
 	os_aio_slot_t*	slot)	/*!< in: pointer to slot */
 {
+	ut_ad(slot->reserved);
+
+	if (slot->compress_buf != NULL) {
+		ut_free(slot->compress_buf);
+		slot->compress_buf = NULL;
+	}
+
 	os_mutex_enter(array->mutex);
 
 	ut_ad(slot->reserved);
@@ -4454,6 +5247,14 @@ os_aio_simulated_wake_handler_threads(void)
 /*=======================================*/
 {
 	if (srv_use_native_aio) {
+#if defined(LINUX_IO_URING)
+		if (os_aio_use_io_uring) {
+			/* Submit the requests that were posted with
+			OS_AIO_SIMULATED_WAKE_LATER. */
+			os_aio_uring_submit_all();
+		}
+#endif /* LINUX_IO_URING */
+
 		/* We do not use simulated aio: do nothing */
 
 		return;
@@ -4512,7 +5313,10 @@ ibool
 os_aio_linux_dispatch(
 /*==================*/
 	os_aio_array_t*	array,	/*!< in: io request array. */
-	os_aio_slot_t*	slot)	/*!< in: an already reserved slot. */
+	os_aio_slot_t*	slot,	/*!< in: an already reserved slot. */
+	bool		submit)	/*!< in: false if the request may be
+				submitted later together with other
+				requests; only used with io_uring */
 {
 	int		ret;
 	ulint		io_ctx_index;
@@ -4523,6 +5327,12 @@ os_aio_linux_dispatch(
 
 	ut_a(slot->reserved);
 
+#if defined(LINUX_IO_URING)
+	if (os_aio_use_io_uring) {
+		return(os_aio_uring_dispatch(array, slot, submit));
+	}
+#endif /* LINUX_IO_URING */
+
 	/* Find out what we are going to work with.
 	The iocb struct is directly in the slot.
 	The io_context is one per segment. */
@@ -4572,7 +5382,8 @@ os_aio_func(
 				may introduce hidden chances of deadlocks,
 				because i/os are not actually handled until
 				all have been posted: use with great
-				caution! */
+				caution! A write of a page may also
+				be ORed to OS_AIO_PAGE_COMPRESS. */
 	const char*	name,	/*!< in: name of the file or path as a
 				null-terminated string */
 	os_file_t	file,	/*!< in: handle to a file */
@@ -4591,6 +5402,7 @@ os_aio_func(
 {
 	os_aio_array_t*	array;
 	os_aio_slot_t*	slot;
+	byte*		compress_buf	= NULL;
 #ifdef WIN_ASYNC_IO
 	ibool		retval;
 	BOOL		ret		= TRUE;
@@ -4614,6 +5426,36 @@ os_aio_func(
 	wake_later = mode & OS_AIO_SIMULATED_WAKE_LATER;
 	mode = mode & (~OS_AIO_SIMULATED_WAKE_LATER);
 
+	if ((mode & OS_AIO_PAGE_COMPRESS) && os_file_punch_hole_supported) {
+		byte*	page;
+		ulint	len;
+
+		ut_ad(type == OS_FILE_WRITE);
+		ut_ad(n == UNIV_PAGE_SIZE);
+
+		compress_buf = static_cast<byte*>(
+			ut_malloc(2 * UNIV_PAGE_SIZE));
+		page = static_cast<byte*>(
+			ut_align(compress_buf, UNIV_PAGE_SIZE));
+
+		len = os_file_compress_page(static_cast<byte*>(buf), page);
+
+		/* The tail of the page is released before the write.
+		If we crash in between, the page is torn and will be
+		restored from the doublewrite buffer. */
+		if (len > 0
+		    && os_file_punch_hole(name, file, offset + len, n - len)) {
+
+			buf = page;
+			n = len;
+		} else {
+			ut_free(compress_buf);
+			compress_buf = NULL;
+		}
+	}
+
+	mode = mode & (~OS_AIO_PAGE_COMPRESS);
+
 	if (mode == OS_AIO_SYNC
 #ifdef WIN_ASYNC_IO
 	    && !srv_use_native_aio
@@ -4639,6 +5481,16 @@ os_aio_func(
 		ut_ad(!srv_read_only_mode);
 		ut_a(type == OS_FILE_WRITE);
 
+		if (compress_buf != NULL) {
+			ibool	success;
+
+			success = os_file_write_func(name, file, buf, offset, n);
+
+			ut_free(compress_buf);
+
+			return(success);
+		}
+
 		return(os_file_write_func(name, file, buf, offset, n));
 	}
 
@@ -4688,7 +5540,7 @@ try_again:
 	}
 
 	slot = os_aio_array_reserve_slot(type, array, message1, message2, file,
-					 name, buf, offset, n);
+					 name, buf, offset, n, compress_buf);
 	if (type == OS_FILE_READ) {
 		if (srv_use_native_aio) {
 			os_n_file_reads++;
@@ -4698,7 +5550,8 @@ try_again:
 				       &(slot->control));
 
 #elif defined(LINUX_NATIVE_AIO)
-			if (!os_aio_linux_dispatch(array, slot)) {
+			if (!os_aio_linux_dispatch(array, slot,
+						   !wake_later)) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -4718,7 +5571,8 @@ try_again:
 					&(slot->control));
 
 #elif defined(LINUX_NATIVE_AIO)
-			if (!os_aio_linux_dispatch(array, slot)) {
+			if (!os_aio_linux_dispatch(array, slot,
+						   !wake_later)) {
 				goto err_exit;
 			}
 #endif /* WIN_ASYNC_IO */
@@ -4764,6 +5618,8 @@ try_again:
 
 #if defined LINUX_NATIVE_AIO || defined WIN_ASYNC_IO
 err_exit:
+	/* Keep the compressed page for a retry */
+	slot->compress_buf = NULL;
 #endif /* LINUX_NATIVE_AIO || WIN_ASYNC_IO */
 	os_aio_array_free_slot(array, slot);
 
@@ -4773,6 +5629,8 @@ err_exit:
 		goto try_again;
 	}
 
+	ut_free(compress_buf);
+
 	return(FALSE);
 }
 
@@ -5148,6 +6006,12 @@ os_aio_linux_handle(
 
 		srv_set_io_thread_op_info(global_seg,
 			"waiting for completed aio requests");
+#if defined(LINUX_IO_URING)
+		if (os_aio_use_io_uring) {
+			os_aio_uring_collect(array, segment, n);
+			continue;
+		}
+#endif /* LINUX_IO_URING */
 		os_aio_linux_collect(array, segment, n);
 	}
 
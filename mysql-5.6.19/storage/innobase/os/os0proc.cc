@@ -32,6 +32,10 @@ Created 9/30/1995 Heikki Tuuri
 #include "ut0mem.h"
 #include "ut0byte.h"
 
+#ifdef UNIV_LINUX
+#include <sys/syscall.h>
+#endif /* UNIV_LINUX */
+
 /* FreeBSD for example has only MAP_ANON, Linux has MAP_ANONYMOUS and
 MAP_ANON but MAP_ANON is marked as deprecated */
 #if defined(MAP_ANONYMOUS)
@@ -43,6 +47,13 @@ MAP_ANON but MAP_ANON is marked as deprecated */
 UNIV_INTERN ibool os_use_large_pages;
 /* Large page size. This may be a boot-time option on some platforms */
 UNIV_INTERN ulint os_large_page_size;
+/* Whether to madvise() transparent huge pages for large allocations */
+UNIV_INTERN ibool os_use_transparent_huge_pages;
+
+/* Memory policy of mbind(2) that allocates from the given node first
+and falls back to the other nodes when it is full; defined here so
+that we do not depend on the numaif.h header of libnuma */
+#define OS_MPOL_PREFERRED	1
 
 /****************************************************************//**
 Converts the current process id to a number. It is not guaranteed that the
@@ -162,6 +173,18 @@ skip:
 			(ulong) size, (ulong) errno);
 		ptr = NULL;
 	} else {
+# if defined HAVE_MADVISE && defined MADV_HUGEPAGE
+		/* The kernel backs the aligned 2M parts of the block
+		with huge pages as they are first touched. Unlike the
+		SysV segments above, this needs no reserved pool. */
+		if (os_use_transparent_huge_pages
+		    && madvise(ptr, size, MADV_HUGEPAGE)) {
+			fprintf(stderr, "InnoDB: Warning: madvise("
+				"MADV_HUGEPAGE) of %lu bytes failed;"
+				" errno %lu\n",
+				(ulong) size, (ulong) errno);
+		}
+# endif /* HAVE_MADVISE && MADV_HUGEPAGE */
 		os_fast_mutex_lock(&ut_list_mutex);
 		ut_total_allocated_memory += size;
 		os_fast_mutex_unlock(&ut_list_mutex);
@@ -230,3 +253,69 @@ os_mem_free_large(
 	}
 #endif
 }
+
+/****************************************************************//**
+Returns the number of NUMA nodes of the machine.
+@return	number of nodes, or 1 if the machine has a single node or the
+number cannot be determined */
+UNIV_INTERN
+ulint
+os_numa_n_nodes(void)
+/*=================*/
+{
+	ulint	n = 0;
+#if defined UNIV_LINUX && defined SYS_mbind
+	char	path[64];
+
+	/* The nodes are numbered from 0. A node that is not present
+	ends the count; sparse node numbering is not supported. */
+	while (n < OS_NUMA_MAX_NODES) {
+		ut_snprintf(path, sizeof path,
+			    "/sys/devices/system/node/node%lu", (ulong) n);
+
+		if (access(path, F_OK)) {
+			break;
+		}
+
+		n++;
+	}
+#endif /* UNIV_LINUX && SYS_mbind */
+
+	return(n > 0 ? n : 1);
+}
+
+/****************************************************************//**
+Sets the memory policy of a memory block returned by
+os_mem_alloc_large() so that its pages are allocated on the given
+NUMA node. The pages that are already in use are not moved, so this
+must be called before the block is first written to.
+@return	true on success */
+UNIV_INTERN
+bool
+os_mem_bind_node(
+/*=============*/
+	void*	ptr,			/*!< in: pointer returned by
+					os_mem_alloc_large() */
+	ulint	size,			/*!< in: size returned by
+					os_mem_alloc_large() */
+	ulint	node)			/*!< in: NUMA node, less than
+					os_numa_n_nodes() */
+{
+	ut_a(node < OS_NUMA_MAX_NODES);
+#if defined UNIV_LINUX && defined SYS_mbind
+	unsigned long	nodemask = 1UL << node;
+
+	/* The kernel ignores the last bit of maxnode. */
+	if (!syscall(SYS_mbind, ptr, (unsigned long) size,
+		     OS_MPOL_PREFERRED, &nodemask,
+		     (unsigned long) (8 * sizeof nodemask + 1), 0)) {
+		return(true);
+	}
+
+	fprintf(stderr, "InnoDB: Warning: mbind(%p, %lu) to NUMA node %lu"
+		" failed; errno %lu\n",
+		ptr, (ulong) size, (ulong) node, (ulong) errno);
+#endif /* UNIV_LINUX && SYS_mbind */
+
+	return(false);
+}
@@ -1176,18 +1176,13 @@ page_zip_compress_clust(
 			ut_ad(trx_id_col + 1 < rec_offs_n_fields(offsets));
 		}
 
-		/* Compress the last bytes of the record. */
-		c_stream->avail_in = static_cast<uInt>(
-			rec + rec_offs_data_size(offsets) - c_stream->next_in);
-
-		if (c_stream->avail_in) {
-			err = deflate(c_stream, Z_NO_FLUSH);
-			if (UNIV_UNLIKELY(err != Z_OK)) {
-
-				goto func_exit;
-			}
-		}
-		ut_ad(!c_stream->avail_in);
+		/* The last bytes of the record will be compressed
+		in a single deflate() call together with any garbage
+		and the extra bytes of the next record, or by the
+		caller after the last record, like the records in
+		page_zip_compress_sec(). */
+		ut_ad(c_stream->next_in
+		      <= rec + rec_offs_data_size(offsets));
 	} while (--n_dense);
 
 func_exit:
@@ -1424,7 +1419,8 @@ page_zip_compress(
 	ut_ad(!c_stream.avail_in);
 	/* Compress any trailing garbage, in case the last record was
 	allocated from an originally longer space on the free list,
-	or the data of the last record from page_zip_compress_sec(). */
+	or the data of the last record from page_zip_compress_sec()
+	or page_zip_compress_clust(). */
 	c_stream.avail_in = static_cast<uInt>(
 		page_header_get_field(page, PAGE_HEAP_TOP)
 		- (c_stream.next_in - page));
@@ -2665,6 +2661,7 @@ page_zip_decompress_clust(
 		| PAGE_HEAP_NO_USER_LOW << REC_HEAP_NO_SHIFT;
 	const byte*	storage;
 	const byte*	externs;
+	const byte*	prev_end	= d_stream->next_out;
 
 	ut_a(dict_index_is_clust(index));
 
@@ -2686,6 +2683,16 @@ page_zip_decompress_clust(
 		err = inflate(d_stream, Z_SYNC_FLUSH);
 		switch (err) {
 		case Z_STREAM_END:
+			/* The last bytes of the preceding record
+			were decompressed by this call.  They must
+			not have been truncated. */
+			if (UNIV_UNLIKELY(d_stream->next_out < prev_end)) {
+				page_zip_fail(("page_zip_decompress_clust:"
+					       " %p < %p\n",
+					       (const void*) d_stream->next_out,
+					       (const void*) prev_end));
+				goto zlib_error;
+			}
 			page_zip_decompress_heap_no(
 				d_stream, rec, heap_status);
 			goto zlib_done;
@@ -2766,28 +2773,16 @@ page_zip_decompress_clust(
 				+ DATA_ROLL_PTR_LEN;
 		}
 
-		/* Decompress the last bytes of the record. */
-		d_stream->avail_out = static_cast<uInt>(
-			rec_get_end(rec, offsets) - d_stream->next_out);
-
-		switch (inflate(d_stream, Z_SYNC_FLUSH)) {
-		case Z_STREAM_END:
-		case Z_OK:
-		case Z_BUF_ERROR:
-			if (!d_stream->avail_out) {
-				break;
-			}
-			/* fall through */
-		default:
-			page_zip_fail(("page_zip_decompress_clust:"
-				       " 3 inflate(Z_SYNC_FLUSH)=%s\n",
-				       d_stream->msg));
-			goto zlib_error;
-		}
+		/* The last bytes of the record will be decompressed
+		together with the header of the next record, or with
+		the trailing garbage after the last record, in order
+		to save one inflate() call per record. */
+		prev_end = rec_get_end(rec, offsets);
 	}
 
-	/* Decompress any trailing garbage, in case the last record was
-	allocated from an originally longer space on the free list. */
+	/* Decompress the last bytes of the last record and any
+	trailing garbage, in case the last record was allocated
+	from an originally longer space on the free list. */
 	d_stream->avail_out = static_cast<uInt>(
 		page_header_get_field(page_zip->data, PAGE_HEAP_TOP)
 		- page_offset(d_stream->next_out));
@@ -2809,6 +2804,14 @@ zlib_error:
 		return(FALSE);
 	}
 
+	if (UNIV_UNLIKELY(d_stream->next_out < prev_end)) {
+		page_zip_fail(("page_zip_decompress_clust:"
+			       " %p < %p at end\n",
+			       (const void*) d_stream->next_out,
+			       (const void*) prev_end));
+		goto zlib_error;
+	}
+
 	/* Note that d_stream->avail_out > 0 may hold here
 	if the modification log is nonempty. */
 
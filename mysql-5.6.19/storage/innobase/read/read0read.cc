@@ -273,52 +273,44 @@ read_view_add(
 	ut_ad(read_view_list_validate());
 }
 
-/** Functor to create thew view trx_ids array. */
-struct	CreateView {
-
-	CreateView(read_view_t*	view)
-		: m_view(view)
-	{
-		  m_n_trx = m_view->n_trx_ids;
-		  m_view->n_trx_ids = 0;
-	}
-
-	void	operator()(const trx_t* trx)
-	{
-		ut_ad(mutex_own(&trx_sys->mutex));
-		ut_ad(trx->in_rw_trx_list);
-
-		/* trx->state cannot change from or to NOT_STARTED
-		while we are holding the trx_sys->mutex. It may change
-		from ACTIVE to PREPARED or COMMITTED. */
+/*********************************************************************//**
+Copies the ids of the active read-write transactions, except the creator
+of the view, to the trx_ids array of the view, biggest first, and lowers
+view->low_limit_no to the smallest trx_t::no of the transactions that are
+being committed. */
+static
+void
+read_view_set_trx_ids(
+/*==================*/
+	read_view_t*	view)	/*!< in/out: read view */
+{
+	const trx_id_t*	ids	= trx_sys->rw_trx_ids;
+	ulint		i	= trx_sys->n_rw_trx_ids;
+	const trx_t*	trx;
 
-		if (trx->id != m_view->creator_trx_id
-		    && !trx_state_eq(trx, TRX_STATE_COMMITTED_IN_MEMORY)) {
+	ut_ad(mutex_own(&trx_sys->mutex));
+	ut_ad(view->n_trx_ids >= trx_sys->n_rw_trx_ids);
 
-			ut_ad(m_n_trx > m_view->n_trx_ids);
+	view->n_trx_ids = 0;
 
-			m_view->trx_ids[m_view->n_trx_ids++] = trx->id;
+	while (i--) {
+		if (ids[i] != view->creator_trx_id) {
+			view->trx_ids[view->n_trx_ids++] = ids[i];
+		}
+	}
 
-			/* NOTE that a transaction whose trx number is <
-			trx_sys->max_trx_id can still be active, if it is
-			in the middle of its commit! Note that when a
-			transaction starts, we initialize trx->no to
-			TRX_ID_MAX. */
+	/* NOTE that a transaction whose trx number is <
+	trx_sys->max_trx_id can still be active, if it is
+	in the middle of its commit! Such transactions are
+	on trx_sys->serialisation_list, which is sorted on
+	trx->no. */
 
-			/* trx->no is protected by trx_sys->mutex, which
-			we are holding. It is assigned by trx_commit()
-			before lock_trx_release_locks() assigns
-			trx->state = TRX_STATE_COMMITTED_IN_MEMORY. */
+	trx = UT_LIST_GET_FIRST(trx_sys->serialisation_list);
 
-			if (m_view->low_limit_no > trx->no) {
-				m_view->low_limit_no = trx->no;
-			}
-		}
+	if (trx != NULL && view->low_limit_no > trx->no) {
+		view->low_limit_no = trx->no;
 	}
-
-	read_view_t*	m_view;
-	ulint		m_n_trx;
-};
+}
 
 /*********************************************************************//**
 Opens a read view where exactly the transactions serialized before this
@@ -334,7 +326,7 @@ read_view_open_now_low(
 					allocated */
 {
 	read_view_t*	view;
-	ulint		n_trx = UT_LIST_GET_LEN(trx_sys->rw_trx_list);
+	ulint		n_trx = trx_sys->n_rw_trx_ids;
 
 	ut_ad(mutex_own(&trx_sys->mutex));
 
@@ -351,7 +343,7 @@ read_view_open_now_low(
 
 	/* No active transaction should be visible, except cr_trx */
 
-	ut_list_map(trx_sys->rw_trx_list, &trx_t::trx_list, CreateView(view));
+	read_view_set_trx_ids(view);
 
 	if (view->n_trx_ids > 0) {
 		/* The last active transaction has the smallest id: */
@@ -567,7 +559,7 @@ read_cursor_view_create_for_mysql(
 
 	mutex_enter(&trx_sys->mutex);
 
-	n_trx = UT_LIST_GET_LEN(trx_sys->rw_trx_list);
+	n_trx = trx_sys->n_rw_trx_ids;
 
 	curview->read_view = read_view_create_low(n_trx, curview->heap);
 
@@ -583,7 +575,7 @@ read_cursor_view_create_for_mysql(
 
 	/* No active transaction should be visible */
 
-	ut_list_map(trx_sys->rw_trx_list, &trx_t::trx_list, CreateView(view));
+	read_view_set_trx_ids(view);
 
 	view->creator_trx_id = cr_trx->id;
 
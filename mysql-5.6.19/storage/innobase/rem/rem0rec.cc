@@ -174,6 +174,7 @@ rec_get_n_extern_new(
 	ulint		i;
 
 	ut_ad(dict_table_is_comp(index->table));
+	ut_ad(!dict_index_is_instant(index));
 	ut_ad(rec_get_status(rec) == REC_STATUS_ORDINARY);
 	ut_ad(n == ULINT_UNDEFINED || n <= dict_index_get_n_fields(index));
 
@@ -237,6 +238,42 @@ rec_get_n_extern_new(
 	return(n_extern);
 }
 
+/******************************************************//**
+Determine the number of fields that are stored in a leaf-page record
+in ROW_FORMAT=COMPACT. A record that carries REC_INFO_INSTANT_FLAG
+stores the number of its fields in 1 or 2 bytes in front of
+REC_N_NEW_EXTRA_BYTES; other records contain the core fields.
+@return	pointer to the first byte of the null flags */
+UNIV_INLINE __attribute__((nonnull, warn_unused_result))
+const byte*
+rec_get_nulls_comp_ordinary(
+/*========================*/
+	const rec_t*		rec,	/*!< in: physical record in
+					ROW_FORMAT=COMPACT */
+	const dict_index_t*	index,	/*!< in: record descriptor */
+	ulint*			n_fields)/*!< out: number of stored fields */
+{
+	const byte*	nulls = rec - (1 + REC_N_NEW_EXTRA_BYTES);
+
+	if (!rec_get_instant_flag(rec)) {
+		*n_fields = dict_index_get_n_core_fields(index);
+		return(nulls);
+	}
+
+	ut_ad(dict_index_is_instant(index));
+
+	*n_fields = *nulls--;
+
+	if (*n_fields & 0x80) {
+		*n_fields = (*n_fields & 0x7f) << 8 | *nulls--;
+	}
+
+	ut_ad(*n_fields >= dict_index_get_n_core_fields(index));
+	ut_ad(*n_fields <= dict_index_get_n_fields(index));
+
+	return(nulls);
+}
+
 /******************************************************//**
 Determine the offset to each field in a leaf-page record
 in ROW_FORMAT=COMPACT.  This is a special case of
@@ -257,20 +294,28 @@ rec_init_offsets_comp_ordinary(
 	ulint		i		= 0;
 	ulint		offs		= 0;
 	ulint		any_ext		= 0;
+	ulint		any_default	= 0;
+	ulint		n_stored	= ULINT_UNDEFINED;
 	ulint		n_null		= index->n_nullable;
 	const byte*	nulls		= temp
 		? rec - 1
-		: rec - (1 + REC_N_NEW_EXTRA_BYTES);
-	const byte*	lens		= nulls - UT_BITS_IN_BYTES(n_null);
+		: rec_get_nulls_comp_ordinary(rec, index, &n_stored);
+	const byte*	lens;
 	ulint		null_mask	= 1;
 
+	if (!temp) {
+		n_null = dict_index_get_n_nullable(index, n_stored);
+	}
+
+	lens = nulls - UT_BITS_IN_BYTES(n_null);
+
 #ifdef UNIV_DEBUG
 	/* We cannot invoke rec_offs_make_valid() here if temp=true.
 	Similarly, rec_offs_validate() will fail in that case, because
 	it invokes rec_get_status(). */
 	offsets[2] = (ulint) rec;
-	offsets[3] = (ulint) index;
 #endif /* UNIV_DEBUG */
+	offsets[REC_OFFS_INDEX] = (ulint) index;
 
 	ut_ad(temp || dict_table_is_comp(index->table));
 
@@ -288,6 +333,18 @@ rec_init_offsets_comp_ordinary(
 			= dict_field_get_col(field);
 		ulint			len;
 
+		if (UNIV_UNLIKELY(i >= n_stored)) {
+			/* The field was added by instant ADD COLUMN
+			after the record was written. It takes the
+			default value of the column. */
+			any_default = REC_OFFS_DEFAULT;
+			len = offs | REC_OFFS_DEFAULT;
+			if (col->def_val_len == UNIV_SQL_NULL) {
+				len |= REC_OFFS_SQL_NULL;
+			}
+			goto resolved;
+		}
+
 		if (!(col->prtype & DATA_NOT_NULL)) {
 			/* nullable field => read the null flag */
 			ut_ad(n_null--);
@@ -353,7 +410,8 @@ resolved:
 	} while (++i < rec_offs_n_fields(offsets));
 
 	*rec_offs_base(offsets)
-		= (rec - (lens + 1)) | REC_OFFS_COMPACT | any_ext;
+		= (rec - (lens + 1)) | REC_OFFS_COMPACT | any_ext
+		| any_default;
 }
 
 /******************************************************//**
@@ -411,7 +469,8 @@ rec_init_offsets(
 		}
 
 		nulls = rec - (REC_N_NEW_EXTRA_BYTES + 1);
-		lens = nulls - UT_BITS_IN_BYTES(index->n_nullable);
+		lens = nulls - UT_BITS_IN_BYTES(
+			index->n_nullable - index->n_instant_nullable);
 		offs = 0;
 		null_mask = 1;
 
@@ -637,6 +696,7 @@ rec_get_offsets_reverse(
 	ut_ad(index);
 	ut_ad(offsets);
 	ut_ad(dict_table_is_comp(index->table));
+	ut_ad(!dict_index_is_instant(index));
 
 	if (UNIV_UNLIKELY(node_ptr)) {
 		n_node_ptr_field = dict_index_get_n_unique_in_tree(index);
@@ -796,8 +856,10 @@ rec_get_converted_size_comp_prefix_low(
 	const dfield_t*		fields,	/*!< in: array of data fields */
 	ulint			n_fields,/*!< in: number of data fields */
 	ulint*			extra,	/*!< out: extra size */
-	bool			temp)	/*!< in: whether this is a
+	bool			temp,	/*!< in: whether this is a
 					temporary file record */
+	bool			instant)/*!< in: whether the record
+					will carry REC_INFO_INSTANT_FLAG */
 {
 	ulint	extra_size;
 	ulint	data_size;
@@ -806,11 +868,23 @@ rec_get_converted_size_comp_prefix_low(
 	ut_ad(n_fields > 0);
 	ut_ad(n_fields <= dict_index_get_n_fields(index));
 	ut_ad(!temp || extra);
+	ut_ad(!temp || !instant);
+
+	if (temp) {
+		extra_size = UT_BITS_IN_BYTES(n_null);
+	} else {
+		n_null = dict_index_get_n_nullable(
+			index, instant ? n_fields : 0);
+		extra_size = REC_N_NEW_EXTRA_BYTES
+			+ UT_BITS_IN_BYTES(n_null);
+
+		if (instant) {
+			/* The number of fields is stored in
+			1 or 2 bytes. */
+			extra_size += n_fields < 0x80 ? 1 : 2;
+		}
+	}
 
-	extra_size = temp
-		? UT_BITS_IN_BYTES(n_null)
-		: REC_N_NEW_EXTRA_BYTES
-		+ UT_BITS_IN_BYTES(n_null);
 	data_size = 0;
 
 	if (temp && dict_table_is_comp(index->table)) {
@@ -907,7 +981,7 @@ rec_get_converted_size_comp_prefix(
 {
 	ut_ad(dict_table_is_comp(index->table));
 	return(rec_get_converted_size_comp_prefix_low(
-		       index, fields, n_fields, extra, false));
+		       index, fields, n_fields, extra, false, false));
 }
 
 /**********************************************************//**
@@ -927,11 +1001,13 @@ rec_get_converted_size_comp(
 	ulint*			extra)	/*!< out: extra size */
 {
 	ulint	size;
+	bool	instant	= false;
 	ut_ad(n_fields > 0);
 
 	switch (UNIV_EXPECT(status, REC_STATUS_ORDINARY)) {
 	case REC_STATUS_ORDINARY:
 		ut_ad(n_fields == dict_index_get_n_fields(index));
+		instant = dict_index_is_instant(index);
 		size = 0;
 		break;
 	case REC_STATUS_NODE_PTR:
@@ -953,7 +1029,7 @@ rec_get_converted_size_comp(
 	}
 
 	return(size + rec_get_converted_size_comp_prefix_low(
-		       index, fields, n_fields, extra, false));
+		       index, fields, n_fields, extra, false, instant));
 }
 
 /***********************************************************//**
@@ -1154,6 +1230,7 @@ rec_convert_dtuple_to_rec_comp(
 	ulint		fixed_len;
 	ulint		null_mask	= 1;
 	ulint		n_null;
+	bool		instant		= false;
 
 	ut_ad(temp || dict_table_is_comp(index->table));
 	ut_ad(n_fields > 0);
@@ -1175,6 +1252,20 @@ rec_convert_dtuple_to_rec_comp(
 		case REC_STATUS_ORDINARY:
 			ut_ad(n_fields <= dict_index_get_n_fields(index));
 			n_node_ptr_field = ULINT_UNDEFINED;
+
+			if (dict_index_is_instant(index)) {
+				/* Store the number of fields; the
+				caller sets REC_INFO_INSTANT_FLAG. */
+				instant = true;
+
+				if (n_fields < 0x80) {
+					*nulls-- = (byte) n_fields;
+				} else {
+					*nulls-- = (byte) (n_fields >> 8)
+						| 0x80;
+					*nulls-- = (byte) n_fields;
+				}
+			}
 			break;
 		case REC_STATUS_NODE_PTR:
 			ut_ad(n_fields
@@ -1193,7 +1284,9 @@ rec_convert_dtuple_to_rec_comp(
 	}
 
 	end = rec;
-	n_null = index->n_nullable;
+	n_null = temp
+		? index->n_nullable
+		: dict_index_get_n_nullable(index, instant ? n_fields : 0);
 	lens = nulls - UT_BITS_IN_BYTES(n_null);
 	/* clear the SQL-null flags */
 	memset(lens + 1, 0, nulls - lens);
@@ -1318,6 +1411,10 @@ rec_convert_dtuple_to_rec_new(
 	/* Set the info bits of the record */
 	rec_set_info_and_status_bits(rec, dtuple_get_info_bits(dtuple));
 
+	if (status == REC_STATUS_ORDINARY && dict_index_is_instant(index)) {
+		rec_set_instant_flag(rec, TRUE);
+	}
+
 	return(rec);
 }
 
@@ -1389,7 +1486,7 @@ rec_get_converted_size_temp(
 	ulint*			extra)	/*!< out: extra size */
 {
 	return(rec_get_converted_size_comp_prefix_low(
-		       index, fields, n_fields, extra, true));
+		       index, fields, n_fields, extra, true, false));
 }
 
 /******************************************************//**
@@ -1564,8 +1661,21 @@ rec_copy_prefix_to_buf(
 		return(NULL);
 	}
 
-	nulls = rec - (REC_N_NEW_EXTRA_BYTES + 1);
-	lens = nulls - UT_BITS_IN_BYTES(index->n_nullable);
+	if (status == REC_STATUS_ORDINARY) {
+		ulint	n_stored;
+
+		nulls = rec_get_nulls_comp_ordinary(rec, index, &n_stored);
+		lens = nulls - UT_BITS_IN_BYTES(
+			dict_index_get_n_nullable(index, n_stored));
+
+		/* The fields that are not stored take their
+		default values. */
+		n_fields = ut_min(n_fields, n_stored);
+	} else {
+		nulls = rec - (REC_N_NEW_EXTRA_BYTES + 1);
+		lens = nulls - UT_BITS_IN_BYTES(
+			index->n_nullable - index->n_instant_nullable);
+	}
 	UNIV_PREFETCH_R(lens);
 	prefix_len = 0;
 	null_mask = 1;
@@ -3671,6 +3671,10 @@ row_import_for_mysql(
 
 	mem_free(filepath);
 
+	if (DICT_TF2_FLAG_IS_SET(table, DICT_TF2_PAGE_COMPRESSED)) {
+		fil_space_set_page_compressed(table->space);
+	}
+
 	err = ibuf_check_bitmap_on_import(trx, table->space);
 
 	DBUG_EXECUTE_IF("ib_import_check_bitmap_failure", err = DB_CORRUPTION;);
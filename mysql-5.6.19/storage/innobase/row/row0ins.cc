@@ -2332,6 +2332,7 @@ row_ins_clust_index_entry_low(
 	ut_ad(!n_uniq || n_uniq == dict_index_get_n_unique(index));
 
 	mtr_start(&mtr);
+	dict_disable_redo_if_temporary(index->table, &mtr);
 
 	if (mode == BTR_MODIFY_LEAF && dict_index_is_online_ddl(index)) {
 		mode = BTR_MODIFY_LEAF | BTR_ALREADY_S_LATCHED;
@@ -2555,6 +2556,7 @@ row_ins_sec_mtr_start_and_check_if_aborted(
 	ut_ad(!dict_index_is_clust(index));
 
 	mtr_start(mtr);
+	dict_disable_redo_if_temporary(index->table, mtr);
 
 	if (!check) {
 		return(false);
@@ -2619,6 +2621,7 @@ row_ins_sec_index_entry_low(
 	cursor.thr = thr;
 	ut_ad(thr_get_trx(thr)->id);
 	mtr_start(&mtr);
+	dict_disable_redo_if_temporary(index->table, &mtr);
 
 	/* Ensure that we acquire index->lock when inserting into an
 	index with index->online_status == ONLINE_INDEX_COMPLETE, but
@@ -2817,6 +2820,7 @@ row_ins_index_entry_big_rec_func(
 	DEBUG_SYNC_C_IF_THD(thd, "before_row_ins_extern_latch");
 
 	mtr_start(&mtr);
+	dict_disable_redo_if_temporary(index->table, &mtr);
 	btr_cur_search_to_nth_level(index, 0, entry, PAGE_CUR_LE,
 				    BTR_MODIFY_TREE, &cursor, 0,
 				    file, line, &mtr);
@@ -37,8 +37,15 @@ Created 2011-05-26 Marko Makela
 #include "data0data.h"
 #include "que0que.h"
 #include "handler0alter.h"
+#include "srv0srv.h"
+#include "log0log.h"
 
 #include<map>
+#include<vector>
+
+#ifdef UNIV_PFS_THREAD
+UNIV_INTERN mysql_pfs_key_t	row_log_apply_thread_key;
+#endif /* UNIV_PFS_THREAD */
 
 /** Table row modification operations during online table rebuild.
 Delete-marked records are not copied to the rebuilt table. */
@@ -658,16 +665,19 @@ func_exit:
 }
 
 /******************************************************//**
-Logs an insert or update to a table that is being rebuilt. */
+Logs an insert or update to a table that is being rebuilt, converting
+the record through a data tuple. This is used for ROW_FORMAT=REDUNDANT
+records and for records that lack fields that were added by instant
+ADD COLUMN. */
 static
 void
-row_log_table_low_redundant(
-/*========================*/
+row_log_table_low_tuple(
+/*====================*/
 	const rec_t*		rec,	/*!< in: clustered index leaf
-					page record in ROW_FORMAT=REDUNDANT,
-					page X-latched */
+					page record, page X-latched */
 	dict_index_t*		index,	/*!< in/out: clustered index, S-latched
 					or X-latched */
+	const ulint*		offsets,/*!< in: rec_get_offsets(rec,index) */
 	bool			insert,	/*!< in: true if insert,
 					false if update */
 	const dtuple_t*		old_pk,	/*!< in: old PRIMARY KEY value
@@ -686,10 +696,11 @@ row_log_table_low_redundant(
 	mem_heap_t*	heap		= NULL;
 	dtuple_t*	tuple;
 
-	ut_ad(!page_is_comp(page_align(rec)));
-	ut_ad(dict_index_get_n_fields(index) == rec_get_n_fields_old(rec));
+	ut_ad(!page_is_comp(page_align(rec)) == !rec_offs_comp(offsets));
+	ut_ad(rec_offs_n_fields(offsets) == dict_index_get_n_fields(index));
 	ut_ad(dict_tf_is_valid(index->table->flags));
-	ut_ad(!dict_table_is_comp(index->table));  /* redundant row format */
+	ut_ad(!dict_table_is_comp(index->table)
+	      || rec_offs_any_default(offsets));
 	ut_ad(dict_index_is_clust(new_index));
 
 	heap = mem_heap_create(DTUPLE_EST_ALLOC(index->n_fields));
@@ -697,7 +708,22 @@ row_log_table_low_redundant(
 	dict_index_copy_types(tuple, index, index->n_fields);
 	dtuple_set_n_fields_cmp(tuple, dict_index_get_n_unique(index));
 
-	if (rec_get_1byte_offs_flag(rec)) {
+	if (rec_offs_comp(offsets)) {
+		for (ulint i = 0; i < index->n_fields; i++) {
+			dfield_t*	dfield;
+			ulint		len;
+			const void*	field;
+
+			dfield = dtuple_get_nth_field(tuple, i);
+			field = rec_get_nth_field(rec, offsets, i, &len);
+
+			dfield_set_data(dfield, field, len);
+
+			if (rec_offs_nth_extern(offsets, i)) {
+				dfield_set_ext(dfield);
+			}
+		}
+	} else if (rec_get_1byte_offs_flag(rec)) {
 		for (ulint i = 0; i < index->n_fields; i++) {
 			dfield_t*	dfield;
 			ulint		len;
@@ -823,9 +849,9 @@ row_log_table_low(
 		return;
 	}
 
-	if (!rec_offs_comp(offsets)) {
-		row_log_table_low_redundant(
-			rec, index, insert, old_pk, new_index);
+	if (!rec_offs_comp(offsets) || rec_offs_any_default(offsets)) {
+		row_log_table_low_tuple(
+			rec, index, offsets, insert, old_pk, new_index);
 		return;
 	}
 
@@ -834,6 +860,13 @@ row_log_table_low(
 
 	omit_size = REC_N_NEW_EXTRA_BYTES;
 
+	if (rec_get_instant_flag(rec)) {
+		/* Omit the number of fields as well. The record
+		contains all fields, and the null flags and lengths
+		are in the format of rec_convert_dtuple_to_temp(). */
+		omit_size += dict_index_get_n_fields(index) < 0x80 ? 1 : 2;
+	}
+
 	extra_size = rec_offs_extra_size(offsets) - omit_size;
 
 	mrec_size = ROW_LOG_HEADER_SIZE
@@ -1290,6 +1323,8 @@ row_log_table_apply_convert_mrec(
 	dict_index_t*		index,		/*!< in: index of mrec */
 	const ulint*		offsets,	/*!< in: offsets of mrec */
 	const row_log_t*	log,		/*!< in: rebuild context */
+	ulonglong		total,		/*!< in: log position after
+						mrec */
 	mem_heap_t*		heap,		/*!< in/out: memory heap */
 	trx_id_t		trx_id,		/*!< in: DB_TRX_ID of mrec */
 	dberr_t*		error)		/*!< out: DB_SUCCESS or
@@ -1358,7 +1393,7 @@ row_log_table_apply_convert_mrec(
 				page_no_map::const_iterator p = blobs->find(
 					page_no);
 				if (p != blobs->end()
-				    && p->second.is_freed(log->head.total)) {
+				    && p->second.is_freed(total)) {
 					/* This BLOB has been freed.
 					We must not access the row. */
 					*error = DB_MISSING_HISTORY;
@@ -1500,12 +1535,14 @@ row_log_table_apply_insert(
 	mem_heap_t*		heap,		/*!< in/out: memory heap */
 	row_merge_dup_t*	dup,		/*!< in/out: for reporting
 						duplicate key errors */
-	trx_id_t		trx_id)		/*!< in: DB_TRX_ID of mrec */
+	trx_id_t		trx_id,		/*!< in: DB_TRX_ID of mrec */
+	ulonglong		total)		/*!< in: log position after
+						mrec */
 {
 	const row_log_t*log	= dup->index->online_log;
 	dberr_t		error;
 	const dtuple_t*	row	= row_log_table_apply_convert_mrec(
-		mrec, dup->index, offsets, log, heap, trx_id, &error);
+		mrec, dup->index, offsets, log, total, heap, trx_id, &error);
 
 	switch (error) {
 	case DB_MISSING_HISTORY:
@@ -1529,7 +1566,7 @@ row_log_table_apply_insert(
 
 	error = row_log_table_apply_insert_low(
 		thr, row, trx_id, offsets_heap, heap, dup);
-	if (error != DB_SUCCESS) {
+	if (error != DB_SUCCESS && dup->table != NULL) {
 		/* Report the erroneous row using the new
 		version of the table. */
 		innobase_row_to_mysql(dup->table, log->table, row);
@@ -1776,6 +1813,8 @@ row_log_table_apply_update(
 	row_merge_dup_t*	dup,		/*!< in/out: for reporting
 						duplicate key errors */
 	trx_id_t		trx_id,		/*!< in: DB_TRX_ID of mrec */
+	ulonglong		total,		/*!< in: log position after
+						mrec */
 	const dtuple_t*		old_pk)		/*!< in: PRIMARY KEY and
 						DB_TRX_ID,DB_ROLL_PTR
 						of the old value,
@@ -1795,7 +1834,7 @@ row_log_table_apply_update(
 	      + (log->same_pk ? 0 : 2));
 
 	row = row_log_table_apply_convert_mrec(
-		mrec, dup->index, offsets, log, heap, trx_id, &error);
+		mrec, dup->index, offsets, log, total, heap, trx_id, &error);
 
 	switch (error) {
 	case DB_MISSING_HISTORY:
@@ -1894,7 +1933,7 @@ func_exit:
 func_exit_committed:
 		ut_ad(mtr.state == MTR_COMMITTED);
 
-		if (error != DB_SUCCESS) {
+		if (error != DB_SUCCESS && dup->table != NULL) {
 			/* Report the erroneous row using the new
 			version of the table. */
 			innobase_row_to_mysql(dup->table, log->table, row);
@@ -2133,8 +2172,11 @@ row_log_table_apply_op(
 	mem_heap_t*		heap,		/*!< in/out: memory heap */
 	const mrec_t*		mrec,		/*!< in: merge record */
 	const mrec_t*		mrec_end,	/*!< in: end of buffer */
-	ulint*			offsets)	/*!< in/out: work area
+	ulint*			offsets,	/*!< in/out: work area
 						for parsing mrec */
+	ulonglong*		total)		/*!< in/out: log position
+						of mrec; advanced past it
+						on success */
 {
 	row_log_t*	log	= dup->index->online_log;
 	dict_index_t*	new_index = dict_table_get_first_index(log->table);
@@ -2146,7 +2188,7 @@ row_log_table_apply_op(
 
 	ut_ad(dict_index_is_clust(dup->index));
 	ut_ad(dup->index->table != log->table);
-	ut_ad(log->head.total <= log->tail.total);
+	ut_ad(*total <= log->tail.total);
 
 	*error = DB_SUCCESS;
 
@@ -2186,7 +2228,7 @@ row_log_table_apply_op(
 		if (next_mrec > mrec_end) {
 			return(NULL);
 		} else {
-			log->head.total += next_mrec - mrec_start;
+			*total += next_mrec - mrec_start;
 
 			ulint		len;
 			const byte*	db_trx_id
@@ -2195,7 +2237,8 @@ row_log_table_apply_op(
 			ut_ad(len == DATA_TRX_ID_LEN);
 			*error = row_log_table_apply_insert(
 				thr, mrec, offsets, offsets_heap,
-				heap, dup, trx_read_trx_id(db_trx_id));
+				heap, dup, trx_read_trx_id(db_trx_id),
+				*total);
 		}
 		break;
 
@@ -2221,7 +2264,7 @@ row_log_table_apply_op(
 			return(NULL);
 		}
 
-		log->head.total += next_mrec - mrec_start;
+		*total += next_mrec - mrec_start;
 
 		/* If there are external fields, retrieve those logged
 		prefix info and reconstruct the row_ext_t */
@@ -2379,7 +2422,7 @@ row_log_table_apply_op(
 		}
 
 		ut_ad(next_mrec <= mrec_end);
-		log->head.total += next_mrec - mrec_start;
+		*total += next_mrec - mrec_start;
 		dtuple_set_n_fields_cmp(old_pk, new_index->n_uniq);
 
 		{
@@ -2391,18 +2434,543 @@ row_log_table_apply_op(
 			*error = row_log_table_apply_update(
 				thr, new_trx_id_col,
 				mrec, offsets, offsets_heap,
-				heap, dup, trx_read_trx_id(db_trx_id), old_pk);
+				heap, dup, trx_read_trx_id(db_trx_id),
+				*total, old_pk);
 		}
 
 		break;
 	}
 
-	ut_ad(log->head.total <= log->tail.total);
+	ut_ad(*total <= log->tail.total);
 	mem_heap_empty(offsets_heap);
 	mem_heap_empty(heap);
 	return(next_mrec);
 }
 
+/** Minimum number of log records in a batch for the batch to be
+applied by several threads */
+#define ROW_LOG_APPLY_MIN_PARALLEL	64
+
+/** Maximum number of log records in a batch */
+#define ROW_LOG_APPLY_MAX_BATCH		16384
+
+/** A table rebuild log record that is waiting to be applied */
+struct row_log_apply_rec_t {
+	const mrec_t*	mrec;	/*!< start of the record */
+	ulonglong	total;	/*!< log position of mrec */
+	ulint		part;	/*!< partition of the record,
+				determined by its PRIMARY KEY */
+};
+
+/** Log records waiting to be applied, in log order */
+typedef std::vector<row_log_apply_rec_t> row_log_apply_batch_t;
+
+/** Shared state of the parallel apply of a table rebuild log.
+The records of a batch are partitioned by PRIMARY KEY, so that the
+records of each row are applied in log order by a single thread. */
+struct row_log_apply_t {
+	os_ib_mutex_t		mutex;		/*!< protects next_part,
+						n_helpers and error */
+	os_event_t		done;		/*!< set when the last helper
+						thread exits */
+	ulint			n_helpers;	/*!< number of helper threads
+						still running */
+	ulint			n_parts;	/*!< number of partitions */
+	ulint			next_part;	/*!< first unclaimed
+						partition */
+	que_thr_t*		thr;		/*!< query graph */
+	ulint			trx_id_col;	/*!< position of DB_TRX_ID
+						in the old index */
+	ulint			new_trx_id_col;	/*!< position of DB_TRX_ID
+						in the new index */
+	const row_merge_dup_t*	dup;		/*!< for reporting duplicate
+						key errors */
+	const row_log_apply_rec_t* failed;	/*!< the record that caused
+						error, or NULL */
+	const mrec_t*		mrec_end;	/*!< end of the block that
+						the records are in */
+	bool			log_free_check;	/*!< whether log_free_check()
+						may be called between the
+						records */
+	row_log_apply_batch_t	batch;		/*!< records to apply */
+	dberr_t			error;		/*!< first error, or
+						DB_SUCCESS */
+};
+
+/******************************************************//**
+Determines if the log of a table rebuild can be applied by several
+threads. Log records of different rows can be applied in any order
+only if the PRIMARY KEY is not changed and no unique secondary index
+can report a spurious duplicate. The rows are partitioned by the bytes
+of their PRIMARY KEY, which must compare equal exactly when the keys
+are equal.
+@return true if the log can be applied in parallel */
+static __attribute__((nonnull, warn_unused_result))
+bool
+row_log_table_apply_is_parallel(
+/*============================*/
+	const dict_index_t*	index)	/*!< in: clustered index of the
+					table being rebuilt */
+{
+	const row_log_t*	log = index->online_log;
+	dict_index_t*		new_index;
+
+	if (srv_online_alter_apply_threads <= 1 || !log->same_pk) {
+		return(false);
+	}
+
+	new_index = dict_table_get_first_index(log->table);
+
+	for (const dict_index_t* sec = dict_table_get_next_index(new_index);
+	     sec != NULL;
+	     sec = dict_table_get_next_index(sec)) {
+
+		if (dict_index_is_unique(sec)) {
+			return(false);
+		}
+	}
+
+	for (ulint i = 0; i < dict_index_get_n_unique(new_index); i++) {
+		const dict_col_t*	col = dict_index_get_nth_col(
+			new_index, i);
+
+		switch (col->mtype) {
+		case DATA_INT:
+		case DATA_SYS:
+			continue;
+		case DATA_BINARY:
+		case DATA_FIXBINARY:
+			if (dtype_get_pad_char(col->mtype, col->prtype)
+			    == ULINT_UNDEFINED) {
+				continue;
+			}
+		}
+
+		return(false);
+	}
+
+	return(true);
+}
+
+/******************************************************//**
+Parses a log record of a table rebuild without applying it, and folds
+its PRIMARY KEY. The PRIMARY KEY must not have been changed.
+@return NULL on failure (mrec corruption) or when out of data;
+pointer to next record on success */
+static __attribute__((nonnull, warn_unused_result))
+const mrec_t*
+row_log_table_parse_op(
+/*===================*/
+	const dict_index_t*	index,		/*!< in: clustered index of
+						the old table */
+	const mrec_t*		mrec,		/*!< in: merge record */
+	const mrec_t*		mrec_end,	/*!< in: end of buffer */
+	ulint*			offsets,	/*!< in/out: work area
+						for parsing mrec */
+	ulint*			fold,		/*!< out: fold value of
+						the PRIMARY KEY */
+	dberr_t*		error)		/*!< out: DB_SUCCESS
+						or DB_CORRUPTION */
+{
+	const dict_index_t*	new_index = dict_table_get_first_index(
+		index->online_log->table);
+	const dict_index_t*	rec_index;
+	const mrec_t*		next_mrec;
+	ulint			extra_size;
+	ulint			ext_size = 0;
+
+	ut_ad(index->online_log->same_pk);
+
+	*error = DB_SUCCESS;
+
+	/* 3 = 1 (op type) + 1 (ext_size) + at least 1 byte payload */
+	if (mrec + 3 >= mrec_end) {
+		return(NULL);
+	}
+
+	switch (*mrec++) {
+	default:
+		ut_ad(0);
+		*error = DB_CORRUPTION;
+		return(NULL);
+	case ROW_T_INSERT:
+	case ROW_T_UPDATE:
+		/* With an unchanged PRIMARY KEY, an update is logged
+		like an insert, as DB_TRX_ID,new_row. */
+		extra_size = *mrec++;
+
+		if (extra_size >= 0x80) {
+			/* Read another byte of extra_size. */
+
+			extra_size = (extra_size & 0x7f) << 8;
+			extra_size |= *mrec++;
+		}
+
+		rec_index = index;
+		rec_offs_set_n_fields(offsets, index->n_fields);
+		break;
+	case ROW_T_DELETE:
+		/* 1 (extra_size) + 2 (ext_size) + at least 1 (payload) */
+		if (mrec + 4 >= mrec_end) {
+			return(NULL);
+		}
+
+		extra_size = *mrec++;
+		ext_size = mach_read_from_2(mrec);
+		mrec += 2;
+
+		rec_index = new_index;
+		rec_offs_set_n_fields(offsets, new_index->n_uniq + 2);
+		break;
+	}
+
+	mrec += extra_size;
+
+	if (mrec > mrec_end) {
+		return(NULL);
+	}
+
+	rec_init_offsets_temp(mrec, rec_index, offsets);
+
+	next_mrec = mrec + rec_offs_data_size(offsets) + ext_size;
+
+	if (next_mrec > mrec_end) {
+		return(NULL);
+	}
+
+	*fold = 0;
+
+	for (ulint i = 0; i < dict_index_get_n_unique(new_index); i++) {
+		const byte*	field;
+		ulint		len;
+
+		field = rec_get_nth_field(mrec, offsets, i, &len);
+		ut_ad(len != UNIV_SQL_NULL);
+
+		*fold = ut_fold_ulint_pair(*fold, ut_fold_binary(field, len));
+	}
+
+	return(next_mrec);
+}
+
+/******************************************************//**
+Reports the row of a log record that could not be applied by a helper
+thread. The MySQL TABLE and its record buffer belong to the thread that
+is executing the ALTER TABLE, so only that thread may write them. */
+static __attribute__((nonnull))
+void
+row_log_table_apply_report(
+/*=======================*/
+	const row_log_apply_t*		apply,	/*!< in: parallel apply */
+	const row_log_apply_rec_t*	rec)	/*!< in: the record that
+						could not be applied */
+{
+	dict_index_t*		index = apply->dup->index;
+	const row_log_t*	log = index->online_log;
+	const mrec_t*		mrec = rec->mrec;
+	const ulint		i = 1 + REC_OFFS_HEADER_SIZE
+		+ dict_index_get_n_fields(index);
+	ulint			extra_size;
+	ulint*			offsets;
+	mem_heap_t*		heap;
+	const dtuple_t*		row;
+	dberr_t			error;
+
+	switch (*mrec++) {
+	case ROW_T_INSERT:
+	case ROW_T_UPDATE:
+		/* With an unchanged PRIMARY KEY, an update is logged
+		like an insert, as DB_TRX_ID,new_row. */
+		break;
+	default:
+		/* No row is reported for a ROW_T_DELETE. */
+		return;
+	}
+
+	extra_size = *mrec++;
+
+	if (extra_size >= 0x80) {
+		/* Read another byte of extra_size. */
+
+		extra_size = (extra_size & 0x7f) << 8;
+		extra_size |= *mrec++;
+	}
+
+	mrec += extra_size;
+
+	heap = mem_heap_create(UNIV_PAGE_SIZE);
+
+	offsets = static_cast<ulint*>(
+		mem_heap_alloc(heap, i * sizeof *offsets));
+	offsets[0] = i;
+	offsets[1] = dict_index_get_n_fields(index);
+
+	rec_offs_set_n_fields(offsets, index->n_fields);
+	rec_init_offsets_temp(mrec, index, offsets);
+
+	ulint		len;
+	const byte*	db_trx_id = rec_get_nth_field(
+		mrec, offsets, apply->trx_id_col, &len);
+	ut_ad(len == DATA_TRX_ID_LEN);
+
+	row = row_log_table_apply_convert_mrec(
+		mrec, index, offsets, log,
+		rec->total + (mrec + rec_offs_data_size(offsets) - rec->mrec),
+		heap, trx_read_trx_id(db_trx_id), &error);
+
+	if (error == DB_SUCCESS) {
+		/* Report the erroneous row using the new
+		version of the table. */
+		innobase_row_to_mysql(apply->dup->table, log->table, row);
+	}
+
+	mem_heap_free(heap);
+}
+
+/******************************************************//**
+Applies the records of one partition of a batch, in log order. */
+static __attribute__((nonnull))
+void
+row_log_table_apply_part(
+/*=====================*/
+	row_log_apply_t*	apply,	/*!< in/out: parallel apply */
+	ulint			part)	/*!< in: partition, or
+					ULINT_UNDEFINED for all records */
+{
+	const dict_index_t*	index = apply->dup->index;
+	const dict_index_t*	new_index = dict_table_get_first_index(
+		index->online_log->table);
+	const ulint		i = 1 + REC_OFFS_HEADER_SIZE
+		+ ut_max(dict_index_get_n_fields(index),
+			 dict_index_get_n_unique(new_index) + 2);
+	row_merge_dup_t		dup = *apply->dup;
+	dberr_t			error = DB_SUCCESS;
+	ulint*			offsets;
+	mem_heap_t*		heap;
+	mem_heap_t*		offsets_heap;
+
+	if (part != ULINT_UNDEFINED) {
+		/* Only the calling thread may write the MySQL record
+		buffer. A failed row is reported after the batch by
+		row_log_table_apply_report(). */
+		dup.table = NULL;
+	}
+
+	offsets = static_cast<ulint*>(ut_malloc(i * sizeof *offsets));
+	offsets[0] = i;
+	offsets[1] = dict_index_get_n_fields(index);
+
+	heap = mem_heap_create(UNIV_PAGE_SIZE);
+	offsets_heap = mem_heap_create(UNIV_PAGE_SIZE);
+
+	for (row_log_apply_batch_t::const_iterator it = apply->batch.begin();
+	     it != apply->batch.end();
+	     ++it) {
+
+		if (part != ULINT_UNDEFINED && it->part != part) {
+			continue;
+		}
+
+		/* This read is not protected by apply->mutex. We stop
+		soon enough after another thread failed. */
+		if (apply->error != DB_SUCCESS) {
+			break;
+		}
+
+		if (apply->log_free_check) {
+			log_free_check();
+		}
+
+		ulonglong	total = it->total;
+
+		if (!row_log_table_apply_op(
+			    apply->thr, apply->trx_id_col,
+			    apply->new_trx_id_col,
+			    &dup, &error, offsets_heap, heap,
+			    it->mrec, apply->mrec_end, offsets, &total)
+		    && error == DB_SUCCESS) {
+			/* The record was parsed before. */
+			ut_ad(0);
+			error = DB_CORRUPTION;
+		}
+
+		if (error != DB_SUCCESS) {
+			os_mutex_enter(apply->mutex);
+
+			if (apply->error == DB_SUCCESS) {
+				apply->error = error;
+				apply->failed = &*it;
+			}
+
+			os_mutex_exit(apply->mutex);
+			break;
+		}
+	}
+
+	mem_heap_free(offsets_heap);
+	mem_heap_free(heap);
+	ut_free(offsets);
+}
+
+/******************************************************//**
+Claims and applies partitions of a batch until none are left. */
+static __attribute__((nonnull))
+void
+row_log_table_apply_parts(
+/*======================*/
+	row_log_apply_t*	apply)	/*!< in/out: parallel apply */
+{
+	for (;;) {
+		ulint	part;
+
+		os_mutex_enter(apply->mutex);
+		part = apply->next_part++;
+		os_mutex_exit(apply->mutex);
+
+		if (part >= apply->n_parts) {
+			break;
+		}
+
+		row_log_table_apply_part(apply, part);
+	}
+}
+
+/******************************************************//**
+Thread helping to apply a batch of a table rebuild log.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(row_log_apply_thread)(
+/*=================================*/
+	void*	arg)	/*!< in: row_log_apply_t* */
+{
+	row_log_apply_t*	apply = static_cast<row_log_apply_t*>(arg);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(row_log_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	row_log_table_apply_parts(apply);
+
+	os_mutex_enter(apply->mutex);
+
+	ut_ad(apply->n_helpers > 0);
+
+	if (--apply->n_helpers == 0) {
+		os_event_set(apply->done);
+	}
+
+	os_mutex_exit(apply->mutex);
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/******************************************************//**
+Applies the batched log records and empties the batch. Small batches
+are applied by the calling thread alone.
+@return DB_SUCCESS, or error code on failure */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_log_table_apply_batch(
+/*======================*/
+	row_log_apply_t*	apply,		/*!< in/out: parallel apply */
+	bool			log_free_check)	/*!< in: whether the index
+						lock is not being held,
+						so that log_free_check()
+						may be called */
+{
+	if (apply->batch.empty()) {
+		return(DB_SUCCESS);
+	}
+
+	apply->log_free_check = log_free_check;
+	apply->error = DB_SUCCESS;
+	apply->failed = NULL;
+
+	if (apply->batch.size() < ROW_LOG_APPLY_MIN_PARALLEL) {
+		row_log_table_apply_part(apply, ULINT_UNDEFINED);
+	} else {
+		ulint	n_helpers = apply->n_parts - 1;
+
+		apply->next_part = 0;
+
+		os_event_reset(apply->done);
+		apply->n_helpers = n_helpers;
+
+		for (ulint i = 0; i < n_helpers; i++) {
+			os_thread_create(row_log_apply_thread, apply, NULL);
+		}
+
+		/* The calling thread applies partitions too. */
+		row_log_table_apply_parts(apply);
+
+		os_event_wait(apply->done);
+
+		if (apply->failed != NULL) {
+			row_log_table_apply_report(apply, apply->failed);
+		}
+	}
+
+	apply->batch.clear();
+
+	return(apply->error);
+}
+
+/******************************************************//**
+Adds a log record to the batch of a parallel apply, and applies the
+batch if it is full.
+@return NULL on failure (mrec corruption) or when out of data;
+pointer to next record on success */
+static __attribute__((nonnull, warn_unused_result))
+const mrec_t*
+row_log_table_apply_dispatch(
+/*=========================*/
+	row_log_apply_t*	apply,		/*!< in/out: parallel apply */
+	const mrec_t*		mrec,		/*!< in: merge record */
+	const mrec_t*		mrec_end,	/*!< in: end of buffer */
+	ulint*			offsets,	/*!< in/out: work area
+						for parsing mrec */
+	bool			log_free_check,	/*!< in: whether the index
+						lock is not being held */
+	dberr_t*		error)		/*!< out: DB_SUCCESS
+						or error code */
+{
+	row_log_t*		log = apply->dup->index->online_log;
+	row_log_apply_rec_t	rec;
+	const mrec_t*		next_mrec;
+	ulint			fold;
+
+	next_mrec = row_log_table_parse_op(
+		apply->dup->index, mrec, mrec_end, offsets, &fold, error);
+
+	if (next_mrec == NULL) {
+		return(NULL);
+	}
+
+	ut_ad(apply->batch.empty() || apply->mrec_end == mrec_end);
+
+	apply->mrec_end = mrec_end;
+
+	rec.mrec = mrec;
+	rec.total = log->head.total;
+	rec.part = fold % apply->n_parts;
+	apply->batch.push_back(rec);
+
+	log->head.total += next_mrec - mrec;
+	ut_ad(log->head.total <= log->tail.total);
+
+	if (apply->batch.size() >= ROW_LOG_APPLY_MAX_BATCH) {
+		*error = row_log_table_apply_batch(apply, log_free_check);
+	}
+
+	return(next_mrec);
+}
+
 /******************************************************//**
 Applies operations to a table was rebuilt.
 @return DB_SUCCESS, or error code on failure */
@@ -2436,6 +3004,8 @@ row_log_table_apply_ops(
 	const ulint	new_trx_id_col	= dict_col_get_clust_pos(
 		dict_table_get_sys_col(new_table, DATA_TRX_ID), new_index);
 	trx_t*		trx		= thr_get_trx(thr);
+	row_log_apply_t	par_apply;
+	row_log_apply_t*apply		= NULL;
 
 	ut_ad(dict_index_is_clust(index));
 	ut_ad(dict_index_is_online_ddl(index));
@@ -2459,6 +3029,18 @@ row_log_table_apply_ops(
 	offsets_heap = mem_heap_create(UNIV_PAGE_SIZE);
 	has_index_lock = true;
 
+	if (row_log_table_apply_is_parallel(index)) {
+		apply = &par_apply;
+		apply->mutex = os_mutex_create();
+		apply->done = os_event_create();
+		apply->n_parts = srv_online_alter_apply_threads;
+		apply->thr = thr;
+		apply->trx_id_col = trx_id_col;
+		apply->new_trx_id_col = new_trx_id_col;
+		apply->dup = dup;
+		apply->batch.reserve(ROW_LOG_APPLY_MAX_BATCH);
+	}
+
 next_block:
 	ut_ad(has_index_lock);
 #ifdef UNIV_SYNC_DEBUG
@@ -2595,7 +3177,8 @@ all_done:
 			thr, trx_id_col, new_trx_id_col,
 			dup, &error, offsets_heap, heap,
 			index->online_log->head.buf,
-			(&index->online_log->head.buf)[1], offsets);
+			(&index->online_log->head.buf)[1], offsets,
+			&index->online_log->head.total);
 		if (error != DB_SUCCESS) {
 			goto func_exit;
 		} else if (UNIV_UNLIKELY(mrec == NULL)) {
@@ -2689,16 +3272,34 @@ all_done:
 			goto func_exit;
 		}
 
-		next_mrec = row_log_table_apply_op(
-			thr, trx_id_col, new_trx_id_col,
-			dup, &error, offsets_heap, heap,
-			mrec, mrec_end, offsets);
+		if (apply != NULL) {
+			next_mrec = row_log_table_apply_dispatch(
+				apply, mrec, mrec_end, offsets,
+				!has_index_lock, &error);
+		} else {
+			next_mrec = row_log_table_apply_op(
+				thr, trx_id_col, new_trx_id_col,
+				dup, &error, offsets_heap, heap,
+				mrec, mrec_end, offsets,
+				&index->online_log->head.total);
+		}
 
 		if (error != DB_SUCCESS) {
 			goto func_exit;
 		} else if (next_mrec == next_mrec_end) {
 			/* The record happened to end on a block boundary.
-			Do we have more blocks left? */
+			Apply the batched records before the block
+			buffer is reused. */
+			if (apply != NULL) {
+				error = row_log_table_apply_batch(
+					apply, !has_index_lock);
+
+				if (error != DB_SUCCESS) {
+					goto func_exit;
+				}
+			}
+
+			/* Do we have more blocks left? */
 			if (has_index_lock) {
 				/* The index will be locked while
 				applying the last block. */
@@ -2726,6 +3327,15 @@ process_next_block:
 			ut_ad(0);
 			goto unexpected_eof;
 		} else {
+			if (apply != NULL) {
+				error = row_log_table_apply_batch(
+					apply, true);
+
+				if (error != DB_SUCCESS) {
+					goto func_exit;
+				}
+			}
+
 			memcpy(index->online_log->head.buf, mrec,
 			       mrec_end - mrec);
 			mrec_end += index->online_log->head.buf - mrec;
@@ -2741,6 +3351,11 @@ func_exit:
 		rw_lock_x_lock(dict_index_get_lock(index));
 	}
 
+	if (apply != NULL) {
+		os_event_free(apply->done);
+		os_mutex_free(apply->mutex);
+	}
+
 	mem_heap_free(offsets_heap);
 	mem_heap_free(heap);
 	row_log_block_free(index->online_log->head);
@@ -36,8 +36,10 @@ Completed by Sunny Bains and Marko Makela
 #include "ut0sort.h"
 #include "row0ftsort.h"
 #include "row0import.h"
+#include "btr0bulk.h"
 #include "handler0alter.h"
 #include "ha_prototypes.h"
+#include "mysql/psi/mysql_stage.h"
 
 /* Ignore posix_fadvise() on those platforms where it does not exist */
 #if defined __WIN__
@@ -64,6 +66,28 @@ static ibool	row_merge_print_block_write;
 /* Whether to disable file system cache */
 UNIV_INTERN char	srv_disable_sort_file_cache;
 
+#ifdef UNIV_PFS_THREAD
+UNIV_INTERN mysql_pfs_key_t	row_merge_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
+#ifdef HAVE_PSI_STAGE_INTERFACE
+UNIV_INTERN PSI_stage_info	row_merge_stage_read
+	= {0, "alter table (read PK and internal sort)", 0};
+UNIV_INTERN PSI_stage_info	row_merge_stage_merge_sort
+	= {0, "alter table (merge sort)", 0};
+UNIV_INTERN PSI_stage_info	row_merge_stage_insert
+	= {0, "alter table (insert)", 0};
+UNIV_INTERN PSI_stage_info	row_merge_stage_log_apply
+	= {0, "alter table (log apply index)", 0};
+
+/** Reports the stage of the index build, if the current thread is
+instrumented. Helper threads are not, and the call is a no-op there. */
+# define row_merge_set_stage(stage)				\
+	MYSQL_SET_STAGE((stage).m_key, __FILE__, __LINE__)
+#else
+# define row_merge_set_stage(stage)	((void) 0)
+#endif /* HAVE_PSI_STAGE_INTERFACE */
+
 /* Maximum pending doc memory limit in bytes for a fts tokenization thread */
 #define FTS_PENDING_DOC_MEMORY_LIMIT	1000000
 
@@ -2279,12 +2303,20 @@ row_merge_insert_index_tuples(
 	ulint			foffs = 0;
 	ulint*			offsets;
 	mrec_buf_t*		buf;
+	btr_bulk_t*		bulk = NULL;
 	DBUG_ENTER("row_merge_insert_index_tuples");
 
 	ut_ad(!srv_read_only_mode);
 	ut_ad(!(index->type & DICT_FTS));
 	ut_ad(trx_id);
 
+	if (!dict_table_zip_size(index->table)) {
+		/* Build the tree bottom-up. Compressed pages would
+		have to be recompressed for every appended record, so
+		they are filled by regular inserts instead. */
+		bulk = btr_bulk_create(index, trx_id);
+	}
+
 	tuple_heap = mem_heap_create(1000);
 
 	{
@@ -2369,6 +2401,18 @@ row_merge_insert_index_tuples(
 			}
 
 			ut_ad(dtuple_validate(dtuple));
+
+			if (bulk) {
+				error = btr_bulk_insert(bulk, dtuple);
+
+				if (error != DB_SUCCESS) {
+					goto err_exit;
+				}
+
+				mem_heap_empty(tuple_heap);
+				continue;
+			}
+
 			log_free_check();
 
 			mtr_start(&mtr);
@@ -2459,6 +2503,10 @@ row_merge_insert_index_tuples(
 	}
 
 err_exit:
+	if (bulk) {
+		error = btr_bulk_finish(bulk, error);
+	}
+
 	mem_heap_free(tuple_heap);
 	mem_heap_free(ins_heap);
 	mem_heap_free(heap);
@@ -3404,6 +3452,290 @@ row_merge_drop_table(
 	return(row_drop_table_for_mysql(table->name, trx, false, false));
 }
 
+/** Work shared by the threads that merge sort the files produced by
+row_merge_read_clustered_index() and insert the sorted entries into the
+indexes being created. Each index is handled by one thread from start to
+end, so that the insert phase of one index overlaps with the merge sort
+of the others. */
+struct row_merge_pll_t {
+	os_ib_mutex_t		mutex;		/*!< protects claimed[],
+						n_helpers and abort */
+	os_event_t		done;		/*!< set when the last helper
+						thread exits */
+	ulint			n_helpers;	/*!< number of helper threads
+						still running */
+	bool			abort;		/*!< true if an index could
+						not be built; no further
+						index will be started */
+	trx_t*			trx;		/*!< the ALTER TABLE
+						transaction */
+	const dict_table_t*	old_table;	/*!< table where rows are
+						read from */
+	dict_index_t**		indexes;	/*!< indexes to be created */
+	ulint			n_indexes;	/*!< size of indexes[] */
+	struct TABLE*		table;		/*!< MySQL table, for
+						reporting duplicate keys */
+	const ulint*		col_map;	/*!< mapping of old column
+						numbers to new ones, or NULL */
+	merge_file_t*		merge_files;	/*!< files of index entries */
+	bool*			claimed;	/*!< claimed[i] is true once
+						a thread has taken
+						indexes[i] */
+	dberr_t*		errors;		/*!< errors[i] is the outcome
+						of building indexes[i] */
+};
+
+/** Work area of a thread helping row_merge_build_indexes() */
+struct row_merge_pll_thr_t {
+	row_merge_pll_t*	pll;		/*!< the shared work */
+	row_merge_block_t*	block;		/*!< 3 merge buffers */
+	ulint			block_size;	/*!< size of block */
+	int			tmpfd;		/*!< temporary file for
+						merge sort */
+};
+
+/*********************************************************************//**
+Takes the next index whose entries still have to be sorted and inserted.
+Indexes that could report a duplicate key are left to the thread of the
+ALTER TABLE, because the report is written to the MySQL table buffer.
+@return	position of the index in pll->indexes, or ULINT_UNDEFINED */
+static
+ulint
+row_merge_pll_next(
+/*===============*/
+	row_merge_pll_t*	pll,	/*!< in/out: shared work */
+	bool			helper)	/*!< in: true if called by a helper
+					thread */
+{
+	ulint	i;
+
+	os_mutex_enter(pll->mutex);
+
+	for (i = 0; !pll->abort && i < pll->n_indexes; i++) {
+		const dict_index_t*	index = pll->indexes[i];
+
+		if (pll->claimed[i]
+		    || (helper && dict_index_is_unique(index))) {
+			continue;
+		}
+
+		pll->claimed[i] = true;
+		os_mutex_exit(pll->mutex);
+		return(i);
+	}
+
+	os_mutex_exit(pll->mutex);
+
+	return(ULINT_UNDEFINED);
+}
+
+/*********************************************************************//**
+Merge sorts the entries of indexes and inserts them into the indexes,
+until no index is left to build. */
+static
+void
+row_merge_pll_sort_insert(
+/*======================*/
+	row_merge_pll_t*	pll,	/*!< in/out: shared work */
+	row_merge_block_t*	block,	/*!< in/out: 3 merge buffers */
+	int*			tmpfd,	/*!< in/out: temporary file handle */
+	bool			helper)	/*!< in: true if called by a helper
+					thread */
+{
+	ulint	i;
+
+	while ((i = row_merge_pll_next(pll, helper)) != ULINT_UNDEFINED) {
+		dict_index_t*	index = pll->indexes[i];
+		dberr_t		error;
+
+		row_merge_dup_t	dup = {
+			index, helper ? NULL : pll->table, pll->col_map, 0};
+
+		row_merge_set_stage(row_merge_stage_merge_sort);
+
+		error = row_merge_sort(
+			pll->trx, &dup, &pll->merge_files[i], block, tmpfd);
+
+		if (error == DB_SUCCESS) {
+			row_merge_set_stage(row_merge_stage_insert);
+
+			error = row_merge_insert_index_tuples(
+				pll->trx->id, index, pll->old_table,
+				pll->merge_files[i].fd, block);
+		}
+
+		/* Close the temporary file to free up space. */
+		row_merge_file_destroy(&pll->merge_files[i]);
+
+		pll->errors[i] = error;
+
+		if (error != DB_SUCCESS) {
+			os_mutex_enter(pll->mutex);
+			pll->abort = true;
+			os_mutex_exit(pll->mutex);
+		}
+	}
+}
+
+/*********************************************************************//**
+Thread helping row_merge_build_indexes() to merge sort and insert index
+entries.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(row_merge_pll_thread)(
+/*=================================*/
+	void*	arg)	/*!< in: row_merge_pll_thr_t* */
+{
+	row_merge_pll_thr_t*	thr = static_cast<row_merge_pll_thr_t*>(arg);
+	row_merge_pll_t*	pll = thr->pll;
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(row_merge_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	row_merge_pll_sort_insert(pll, thr->block, &thr->tmpfd, true);
+
+	os_mutex_enter(pll->mutex);
+
+	ut_ad(pll->n_helpers > 0);
+
+	if (--pll->n_helpers == 0) {
+		os_event_set(pll->done);
+	}
+
+	os_mutex_exit(pll->mutex);
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Merge sorts the files of index entries and inserts the entries into the
+indexes, using up to srv_sort_threads threads. Full-text indexes are
+skipped; they are built by the caller.
+@return	DB_SUCCESS, or the error of the first index that failed; its
+position is stored in *err_index */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_merge_sort_insert_indexes(
+/*==========================*/
+	trx_t*			trx,		/*!< in: transaction */
+	const dict_table_t*	old_table,	/*!< in: table where rows
+						are read from */
+	dict_index_t**		indexes,	/*!< in: indexes to be
+						created */
+	ulint			n_indexes,	/*!< in: size of indexes[] */
+	struct TABLE*		table,		/*!< in/out: MySQL table,
+						for reporting duplicates */
+	const ulint*		col_map,	/*!< in: mapping of old column
+						numbers to new ones, or NULL */
+	merge_file_t*		merge_files,	/*!< in/out: files of index
+						entries, destroyed when
+						done */
+	row_merge_block_t*	block,		/*!< in/out: 3 merge buffers
+						of the calling thread */
+	int*			tmpfd,		/*!< in/out: temporary file
+						of the calling thread */
+	ulint*			err_index)	/*!< out: position of the
+						failed index */
+{
+	row_merge_pll_t		pll;
+	row_merge_pll_thr_t*	thrs;
+	ulint			n_helpers = 0;
+	ulint			n_sort = 0;
+	ulint			i;
+	dberr_t			error = DB_SUCCESS;
+
+	pll.claimed = static_cast<bool*>(
+		mem_alloc(n_indexes * sizeof *pll.claimed));
+	pll.errors = static_cast<dberr_t*>(
+		mem_alloc(n_indexes * sizeof *pll.errors));
+
+	for (i = 0; i < n_indexes; i++) {
+		/* Full-text indexes are not built here. */
+		pll.claimed[i] = (indexes[i]->type & DICT_FTS) != 0;
+		pll.errors[i] = DB_SUCCESS;
+		n_sort += !pll.claimed[i];
+	}
+
+	pll.mutex = os_mutex_create();
+	pll.done = os_event_create();
+	pll.n_helpers = 0;
+	pll.abort = false;
+	pll.trx = trx;
+	pll.old_table = old_table;
+	pll.indexes = indexes;
+	pll.n_indexes = n_indexes;
+	pll.table = table;
+	pll.col_map = col_map;
+	pll.merge_files = merge_files;
+
+	/* The calling thread is one of the srv_sort_threads. */
+	thrs = static_cast<row_merge_pll_thr_t*>(
+		mem_alloc(n_indexes * sizeof *thrs));
+
+	while (n_helpers + 1 < ut_min(n_sort, srv_sort_threads)) {
+		row_merge_pll_thr_t*	thr = &thrs[n_helpers];
+
+		thr->pll = &pll;
+		thr->block_size = 3 * srv_sort_buf_size;
+		thr->block = static_cast<row_merge_block_t*>(
+			os_mem_alloc_large(&thr->block_size));
+
+		if (thr->block == NULL) {
+			break;
+		}
+
+		thr->tmpfd = row_merge_file_create_low();
+
+		if (thr->tmpfd < 0) {
+			os_mem_free_large(thr->block, thr->block_size);
+			break;
+		}
+
+		n_helpers++;
+	}
+
+	os_event_reset(pll.done);
+	pll.n_helpers = n_helpers;
+
+	for (i = 0; i < n_helpers; i++) {
+		os_thread_create(row_merge_pll_thread, &thrs[i], NULL);
+	}
+
+	row_merge_pll_sort_insert(&pll, block, tmpfd, false);
+
+	if (n_helpers > 0) {
+		os_event_wait(pll.done);
+	}
+
+	for (i = 0; i < n_helpers; i++) {
+		row_merge_file_destroy_low(thrs[i].tmpfd);
+		os_mem_free_large(thrs[i].block, thrs[i].block_size);
+	}
+
+	for (i = 0; i < n_indexes; i++) {
+		if (pll.errors[i] != DB_SUCCESS) {
+			error = pll.errors[i];
+			*err_index = i;
+			break;
+		}
+	}
+
+	os_event_free(pll.done);
+	os_mutex_free(pll.mutex);
+	mem_free(thrs);
+	mem_free(pll.errors);
+	mem_free(pll.claimed);
+
+	return(error);
+}
+
 /*********************************************************************//**
 Build indexes on a table by reading a clustered index,
 creating a temporary file containing index entries, merge sorting
@@ -3527,6 +3859,8 @@ row_merge_build_indexes(
 	/* Read clustered index of the table and create files for
 	secondary index entries for merge sort */
 
+	row_merge_set_stage(row_merge_stage_read);
+
 	error = row_merge_read_clustered_index(
 		trx, table, old_table, new_table, online, indexes,
 		fts_sort_idx, psort_info, merge_files, key_numbers,
@@ -3543,6 +3877,15 @@ row_merge_build_indexes(
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
+	error = row_merge_sort_insert_indexes(
+		trx, old_table, indexes, n_indexes, table, col_map,
+		merge_files, block, &tmpfd, &i);
+
+	if (error != DB_SUCCESS) {
+		trx->error_key_num = key_numbers[i];
+		goto func_exit;
+	}
+
 	for (i = 0; i < n_indexes; i++) {
 		dict_index_t*	sort_idx = indexes[i];
 
@@ -3612,22 +3955,11 @@ wait_again:
 #ifdef FTS_INTERNAL_DIAG_PRINT
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
-		} else {
-			row_merge_dup_t	dup = {
-				sort_idx, table, col_map, 0};
-
-			error = row_merge_sort(
-				trx, &dup, &merge_files[i],
-				block, &tmpfd);
-
-			if (error == DB_SUCCESS) {
-				error = row_merge_insert_index_tuples(
-					trx->id, sort_idx, old_table,
-					merge_files[i].fd, block);
-			}
 		}
 
-		/* Close the temporary file to free up space. */
+		/* Close the temporary file to free up space. The files
+		of the other indexes were closed by
+		row_merge_sort_insert_indexes(). */
 		row_merge_file_destroy(&merge_files[i]);
 
 		if (indexes[i]->type & DICT_FTS) {
@@ -3641,6 +3973,7 @@ wait_again:
 			      == ONLINE_INDEX_COMPLETE);
 		} else {
 			DEBUG_SYNC_C("row_log_apply_before");
+			row_merge_set_stage(row_merge_stage_log_apply);
 			error = row_log_apply(trx, sort_idx, table);
 			DEBUG_SYNC_C("row_log_apply_after");
 		}
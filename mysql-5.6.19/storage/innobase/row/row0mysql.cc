@@ -795,9 +795,50 @@ row_create_prebuilt(
 
 	prebuilt->mysql_row_len = mysql_row_len;
 
+	prebuilt->fetch_cache_size = MYSQL_FETCH_CACHE_SIZE;
+
 	return(prebuilt);
 }
 
+/********************************************************************//**
+Frees the fetch cache of a prebuilt struct, after checking the magic
+numbers around each row. */
+UNIV_INTERN
+void
+row_prebuilt_free_fetch_cache(
+/*==========================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	byte*	base = prebuilt->fetch_cache;
+	byte*	ptr = base;
+
+	for (ulint i = 0; i < prebuilt->fetch_cache_n_alloc; i++) {
+		ulint	magic1;
+		ulint	magic2;
+
+		magic1 = mach_read_from_4(ptr);
+		ptr += 4 + prebuilt->mysql_row_len;
+
+		magic2 = mach_read_from_4(ptr);
+		ptr += 4;
+
+		if (ROW_PREBUILT_FETCH_MAGIC_N != magic1
+		    || ROW_PREBUILT_FETCH_MAGIC_N != magic2) {
+
+			fputs("InnoDB: Error: trying to free"
+			      " a corrupt fetch buffer.\n", stderr);
+
+			mem_analyze_corruption(base);
+			ut_error;
+		}
+	}
+
+	mem_free(base);
+
+	prebuilt->fetch_cache = NULL;
+	prebuilt->fetch_cache_n_alloc = 0;
+}
+
 /********************************************************************//**
 Free a prebuilt struct for a MySQL table handle. */
 UNIV_INTERN
@@ -807,8 +848,6 @@ row_prebuilt_free(
 	row_prebuilt_t*	prebuilt,	/*!< in, own: prebuilt struct */
 	ibool		dict_locked)	/*!< in: TRUE=data dictionary locked */
 {
-	ulint	i;
-
 	if (UNIV_UNLIKELY
 	    (prebuilt->magic_n != ROW_PREBUILT_ALLOCATED
 	     || prebuilt->magic_n2 != ROW_PREBUILT_ALLOCATED)) {
@@ -857,37 +896,8 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 
-	if (prebuilt->fetch_cache[0] != NULL) {
-		byte*	base = prebuilt->fetch_cache[0] - 4;
-		byte*	ptr = base;
-
-		for (i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-			byte*	row;
-			ulint	magic1;
-			ulint	magic2;
-
-			magic1 = mach_read_from_4(ptr);
-			ptr += 4;
-
-			row = ptr;
-			ptr += prebuilt->mysql_row_len;
-
-			magic2 = mach_read_from_4(ptr);
-			ptr += 4;
-
-			if (ROW_PREBUILT_FETCH_MAGIC_N != magic1
-			    || row != prebuilt->fetch_cache[i]
-			    || ROW_PREBUILT_FETCH_MAGIC_N != magic2) {
-
-				fputs("InnoDB: Error: trying to free"
-					" a corrupt fetch buffer.\n", stderr);
-
-				mem_analyze_corruption(base);
-				ut_error;
-			}
-		}
-
-		mem_free(base);
+	if (prebuilt->fetch_cache != NULL) {
+		row_prebuilt_free_fetch_cache(prebuilt);
 	}
 
 	dict_table_close(prebuilt->table, dict_locked, TRUE);
@@ -2742,6 +2752,32 @@ row_add_table_to_background_drop_list(
 	return(TRUE);
 }
 
+/*********************************************************************//**
+Moves the default values of the instantly added columns of a table
+to a new table identifier in SYS_COLUMN_DEFAULTS.
+@return	error code or DB_SUCCESS */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_mysql_column_defaults_renumber(
+/*===============================*/
+	trx_t*		trx,	/*!< in/out: dictionary transaction */
+	table_id_t	old_id,	/*!< in: old table id */
+	table_id_t	new_id)	/*!< in: new table id */
+{
+	pars_info_t*	info	= pars_info_create();
+
+	pars_info_add_ull_literal(info, "old_id", old_id);
+	pars_info_add_ull_literal(info, "new_id", new_id);
+
+	return(que_eval_sql(
+		       info,
+		       "PROCEDURE RENUMBER_COLUMN_DEFAULTS_PROC () IS\n"
+		       "BEGIN\n"
+		       "UPDATE SYS_COLUMN_DEFAULTS SET TABLE_ID = :new_id\n"
+		       " WHERE TABLE_ID = :old_id;\n"
+		       "END;\n", FALSE, trx));
+}
+
 /*********************************************************************//**
 Reassigns the table identifier of a table.
 @return	error code or DB_SUCCESS */
@@ -2776,6 +2812,12 @@ row_mysql_table_id_reassign(
 		" WHERE TABLE_ID = :old_id;\n"
 		"END;\n", FALSE, trx);
 
+	if (err == DB_SUCCESS
+	    && DICT_TF2_FLAG_IS_SET(table, DICT_TF2_INSTANT)) {
+		err = row_mysql_column_defaults_renumber(
+			trx, table->id, *new_id);
+	}
+
 	return(err);
 }
 
@@ -3564,6 +3606,12 @@ next_rec:
 			   "END;\n"
 			   , FALSE, trx);
 
+	if (err == DB_SUCCESS
+	    && DICT_TF2_FLAG_IS_SET(table, DICT_TF2_INSTANT)) {
+		err = row_mysql_column_defaults_renumber(
+			trx, table->id, new_id);
+	}
+
 	if (err == DB_SUCCESS && old_space != table->space) {
 		info = pars_info_create();
 
@@ -4136,6 +4184,21 @@ check_next_foreign:
 			   "END;\n"
 			   , FALSE, trx);
 
+	if (err == DB_SUCCESS
+	    && DICT_TF2_FLAG_IS_SET(table, DICT_TF2_INSTANT)) {
+		info = pars_info_create();
+
+		pars_info_add_ull_literal(info, "table_id", table->id);
+
+		err = que_eval_sql(info,
+				   "PROCEDURE DROP_COLUMN_DEFAULTS_PROC () IS\n"
+				   "BEGIN\n"
+				   "DELETE FROM SYS_COLUMN_DEFAULTS\n"
+				   "WHERE TABLE_ID = :table_id;\n"
+				   "END;\n"
+				   , FALSE, trx);
+	}
+
 	switch (err) {
 		ibool	is_temp;
 
@@ -0,0 +1,534 @@
+/*****************************************************************************
+
+Copyright (c) 2026, the authors of this file.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file row/row0pread.cc
+Parallel scan of a clustered index
+*******************************************************/
+
+#include "row0pread.h"
+#include "btr0btr.h"
+#include "btr0pcur.h"
+#include "read0read.h"
+#include "rem0cmp.h"
+#include "row0row.h"
+#include "row0vers.h"
+#include "srv0srv.h"
+#include "trx0trx.h"
+
+#include <vector>
+
+#ifdef UNIV_PFS_THREAD
+UNIV_INTERN mysql_pfs_key_t	row_pread_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
+/** Number of key ranges to create per scanning thread, so that the
+threads remain busy even if the ranges differ in size */
+#define ROW_PREAD_RANGES_PER_THREAD	8
+
+/** Number of records between checks for interruption and for
+waiters on the index tree latch */
+#define ROW_PREAD_CHECK_INTERVAL	1000
+
+/** Shared state of a parallel index scan */
+struct row_pread_t {
+	os_ib_mutex_t		mutex;		/*!< protects next_range,
+						n_helpers, n_rows and err */
+	os_event_t		done;		/*!< set when the last helper
+						thread exits */
+	ulint			n_helpers;	/*!< number of helper threads
+						still running */
+	trx_t*			trx;		/*!< transaction whose read view
+						is used */
+	dict_index_t*		index;		/*!< clustered index */
+	bool			check;		/*!< whether to check the
+						order of the records */
+	const dtuple_t**	bounds;		/*!< range i covers the keys
+						in [bounds[i - 1], bounds[i]);
+						the first and last ranges are
+						unbounded */
+	ulint			n_ranges;	/*!< number of ranges */
+	ulint			next_range;	/*!< first unclaimed range */
+	ulint			n_rows;		/*!< records counted so far */
+	dberr_t			err;		/*!< first error, or
+						DB_SUCCESS */
+};
+
+/*********************************************************************//**
+Splits a clustered index into key ranges at the node pointer records of
+the highest level that has enough records for the requested number of
+ranges. The boundary keys are copied to heap.
+@return number of boundary keys; the number of ranges is one larger */
+static
+ulint
+row_pread_split(
+/*============*/
+	dict_index_t*		index,	/*!< in: clustered index */
+	ulint			n_target,/*!< in: desired number of ranges */
+	mem_heap_t*		heap,	/*!< in/out: memory heap */
+	const dtuple_t***	bounds)	/*!< out: boundary keys */
+{
+	ulint			space = dict_index_get_space(index);
+	ulint			zip_size = dict_table_zip_size(index->table);
+	ulint			n_fields = dict_index_get_n_unique_in_tree(index);
+	std::vector<buf_block_t*>	blocks;
+	mem_heap_t*		offsets_heap = NULL;
+	ulint			offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*			offsets = offsets_;
+	ulint			n_recs;
+	ulint			level;
+	ulint			n_bounds = 0;
+	mtr_t			mtr;
+
+	rec_offs_init(offsets_);
+
+	mtr_start(&mtr);
+	mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+	blocks.push_back(btr_block_get(space, zip_size,
+				       dict_index_get_page(index),
+				       RW_S_LATCH, index, &mtr));
+
+	level = btr_page_get_level(buf_block_get_frame(blocks[0]), &mtr);
+	n_recs = page_get_n_recs(buf_block_get_frame(blocks[0]));
+
+	/* Descend until the node pointers of the level are enough for
+	the ranges. Since a level is only descended while it has fewer
+	than n_target records, at most n_target pages are latched. */
+	while (n_recs < n_target && level > 1) {
+		std::vector<buf_block_t*>	children;
+
+		n_recs = 0;
+
+		for (ulint i = 0; i < blocks.size(); i++) {
+			const rec_t*	rec = page_rec_get_next_const(
+				page_get_infimum_rec(
+					buf_block_get_frame(blocks[i])));
+
+			while (!page_rec_is_supremum(rec)) {
+				buf_block_t*	child;
+
+				offsets = rec_get_offsets(
+					rec, index, offsets,
+					ULINT_UNDEFINED, &offsets_heap);
+
+				child = btr_block_get(
+					space, zip_size,
+					btr_node_ptr_get_child_page_no(
+						rec, offsets),
+					RW_S_LATCH, index, &mtr);
+
+				n_recs += page_get_n_recs(
+					buf_block_get_frame(child));
+				children.push_back(child);
+
+				rec = page_rec_get_next_const(rec);
+			}
+		}
+
+		blocks.swap(children);
+		level--;
+	}
+
+	if (level > 0 && n_recs > 1) {
+		*bounds = static_cast<const dtuple_t**>(
+			mem_heap_alloc(heap, (n_recs - 1) * sizeof **bounds));
+
+		/* The leftmost node pointer is smaller than any key;
+		the first range starts from the beginning of the index. */
+		bool	leftmost = true;
+
+		for (ulint i = 0; i < blocks.size(); i++) {
+			rec_t*	rec = page_rec_get_next(
+				page_get_infimum_rec(
+					buf_block_get_frame(blocks[i])));
+
+			for (; !page_rec_is_supremum(rec);
+			     rec = page_rec_get_next(rec)) {
+
+				if (leftmost) {
+					leftmost = false;
+					continue;
+				}
+
+				ut_a(n_bounds < n_recs - 1);
+
+				(*bounds)[n_bounds++] =
+					dict_index_build_data_tuple(
+						index, rec, n_fields, heap);
+			}
+		}
+	}
+
+	mtr_commit(&mtr);
+
+	if (offsets_heap) {
+		mem_heap_free(offsets_heap);
+	}
+
+	return(n_bounds);
+}
+
+/*********************************************************************//**
+Reports a record that is out of order or duplicated. */
+static
+void
+row_pread_report(
+/*=============*/
+	const row_pread_t*	pread,	/*!< in: parallel scan */
+	const char*		msg,	/*!< in: description of the error */
+	const dtuple_t*		prev,	/*!< in: previous record */
+	const rec_t*		rec,	/*!< in: record */
+	const ulint*		offsets)/*!< in: rec_get_offsets(rec) */
+{
+	os_mutex_enter(pread->mutex);
+
+	fprintf(stderr, "InnoDB: %s in ", msg);
+	dict_index_name_print(stderr, pread->trx, pread->index);
+	fputs("\n"
+	      "InnoDB: prev record ", stderr);
+	dtuple_print(stderr, prev);
+	fputs("\n"
+	      "InnoDB: record ", stderr);
+	rec_print_new(stderr, rec, offsets);
+	putc('\n', stderr);
+
+	os_mutex_exit(pread->mutex);
+}
+
+/*********************************************************************//**
+Counts the visible records in one key range of the index.
+@return DB_SUCCESS, DB_CORRUPTION if the check failed, or another error
+code if the scan was stopped */
+static
+dberr_t
+row_pread_scan_range(
+/*=================*/
+	row_pread_t*	pread,	/*!< in/out: parallel scan */
+	ulint		i,	/*!< in: range number */
+	ulint*		n_rows)	/*!< out: number of visible records */
+{
+	dict_index_t*	index = pread->index;
+	read_view_t*	view = pread->trx->read_view;
+	const dtuple_t*	start = i > 0 ? pread->bounds[i - 1] : NULL;
+	const dtuple_t*	end = i + 1 < pread->n_ranges
+		? pread->bounds[i] : NULL;
+	ulint		comp = dict_table_is_comp(index->table);
+	ulint		n_unique = dict_index_get_n_unique(index);
+	mem_heap_t*	heap = mem_heap_create(UNIV_PAGE_SIZE / 4);
+	mem_heap_t*	prev_heap = NULL;
+	dtuple_t*	prev = NULL;
+	ulint*		offsets = NULL;
+	ulint		n_scanned = 0;
+	bool		move = (start == NULL);
+	bool		corrupted = false;
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+	dberr_t		err = DB_SUCCESS;
+
+	*n_rows = 0;
+
+	if (pread->check) {
+		prev_heap = mem_heap_create(UNIV_PAGE_SIZE / 4);
+	}
+
+	mtr_start(&mtr);
+
+	if (start) {
+		/* Position on the first record not less than start. */
+		btr_pcur_open(index, start, PAGE_CUR_GE, BTR_SEARCH_LEAF,
+			      &pcur, &mtr);
+	} else {
+		btr_pcur_open_at_index_side(
+			true, index, BTR_SEARCH_LEAF, &pcur, true, 0, &mtr);
+	}
+
+	for (;;) {
+		const rec_t*	rec;
+		rec_t*		old_vers;
+
+		if (move) {
+			if (++n_scanned % ROW_PREAD_CHECK_INTERVAL == 0) {
+				if (trx_is_interrupted(pread->trx)) {
+					err = DB_INTERRUPTED;
+					break;
+				}
+
+				if (pread->err != DB_SUCCESS
+				    && pread->err != DB_CORRUPTION) {
+					/* Another range failed; the
+					count will not be used. */
+					break;
+				}
+
+				if (rw_lock_get_waiters(
+					    dict_index_get_lock(index))) {
+					/* Let the waiters proceed. */
+					btr_pcur_store_position(&pcur, &mtr);
+					mtr_commit(&mtr);
+					os_thread_yield();
+					mtr_start(&mtr);
+					btr_pcur_restore_position(
+						BTR_SEARCH_LEAF, &pcur, &mtr);
+				}
+			}
+
+			if (!btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+				break;
+			}
+		}
+
+		move = true;
+
+		if (!btr_pcur_is_on_user_rec(&pcur)) {
+			continue;
+		}
+
+		mem_heap_empty(heap);
+
+		rec = btr_pcur_get_rec(&pcur);
+		offsets = rec_get_offsets(rec, index, NULL,
+					  ULINT_UNDEFINED, &heap);
+
+		if (end && cmp_dtuple_rec(end, rec, offsets) <= 0) {
+			break;
+		}
+
+		if (!read_view_sees_trx_id(
+			    view, row_get_rec_trx_id(rec, index, offsets))) {
+
+			err = row_vers_build_for_consistent_read(
+				rec, &mtr, index, &offsets, view,
+				&heap, heap, &old_vers);
+
+			if (err != DB_SUCCESS) {
+				break;
+			}
+
+			rec = old_vers;
+
+			if (rec == NULL) {
+				/* Inserted after the read view
+				was created. */
+				continue;
+			}
+		}
+
+		if (rec_get_deleted_flag(rec, comp)) {
+			continue;
+		}
+
+		++*n_rows;
+
+		if (!pread->check) {
+			continue;
+		}
+
+		if (prev != NULL) {
+			ulint	matched_fields = 0;
+			ulint	matched_bytes = 0;
+			int	cmp = cmp_dtuple_rec_with_match(
+				prev, rec, offsets,
+				&matched_fields, &matched_bytes);
+
+			if (cmp > 0) {
+				row_pread_report(
+					pread, "index records in a wrong order",
+					prev, rec, offsets);
+				corrupted = true;
+			} else if (matched_fields >= n_unique) {
+				row_pread_report(
+					pread, "duplicate key",
+					prev, rec, offsets);
+				corrupted = true;
+			}
+		}
+
+		mem_heap_empty(prev_heap);
+
+		ulint	n_ext;
+
+		prev = row_rec_to_index_entry(
+			rec, index, offsets, &n_ext, prev_heap);
+	}
+
+	mtr_commit(&mtr);
+	btr_pcur_close(&pcur);
+
+	if (prev_heap) {
+		mem_heap_free(prev_heap);
+	}
+
+	mem_heap_free(heap);
+
+	if (err == DB_SUCCESS && corrupted) {
+		err = DB_CORRUPTION;
+	}
+
+	return(err);
+}
+
+/*********************************************************************//**
+Claims and scans key ranges until all of them have been taken. */
+static
+void
+row_pread_scan(
+/*===========*/
+	row_pread_t*	pread)	/*!< in/out: parallel scan */
+{
+	for (;;) {
+		ulint	i;
+		ulint	n_rows;
+		dberr_t	err;
+
+		os_mutex_enter(pread->mutex);
+
+		i = pread->next_range;
+
+		if (i < pread->n_ranges
+		    && (pread->err == DB_SUCCESS
+			|| pread->err == DB_CORRUPTION)) {
+			pread->next_range++;
+		} else {
+			i = ULINT_UNDEFINED;
+		}
+
+		os_mutex_exit(pread->mutex);
+
+		if (i == ULINT_UNDEFINED) {
+			return;
+		}
+
+		err = row_pread_scan_range(pread, i, &n_rows);
+
+		os_mutex_enter(pread->mutex);
+
+		pread->n_rows += n_rows;
+
+		/* Corruption is reported but does not stop the scan. */
+		if (pread->err == DB_SUCCESS
+		    || (pread->err == DB_CORRUPTION && err != DB_SUCCESS)) {
+			pread->err = err;
+		}
+
+		os_mutex_exit(pread->mutex);
+	}
+}
+
+/*********************************************************************//**
+Thread helping row_pread_count() to scan the key ranges of an index.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(row_pread_thread)(
+/*=============================*/
+	void*	arg)	/*!< in: row_pread_t* */
+{
+	row_pread_t*	pread = static_cast<row_pread_t*>(arg);
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(row_pread_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	row_pread_scan(pread);
+
+	os_mutex_enter(pread->mutex);
+
+	ut_ad(pread->n_helpers > 0);
+
+	if (--pread->n_helpers == 0) {
+		os_event_set(pread->done);
+	}
+
+	os_mutex_exit(pread->mutex);
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Counts the records of a clustered index that are visible in the read
+view of a transaction, scanning the index with up to
+srv_parallel_read_threads threads. If check is set, the records are
+also checked to be in ascending order without duplicates; violations
+are reported to the error log and the scan continues.
+@return DB_SUCCESS, DB_CORRUPTION if the check failed, or another error
+code if the scan was stopped */
+UNIV_INTERN
+dberr_t
+row_pread_count(
+/*============*/
+	trx_t*		trx,	/*!< in: transaction that has a read view */
+	dict_index_t*	index,	/*!< in: clustered index */
+	bool		check,	/*!< in: whether to check the order
+				of the records */
+	ulint*		n_rows)	/*!< out: number of visible records */
+{
+	row_pread_t	pread;
+	ulint		n_threads = srv_parallel_read_threads;
+	mem_heap_t*	heap = mem_heap_create(1024);
+	ulint		n_helpers;
+
+	ut_ad(dict_index_is_clust(index));
+	ut_ad(trx->read_view != NULL);
+
+	pread.mutex = os_mutex_create();
+	pread.done = os_event_create();
+	pread.trx = trx;
+	pread.index = index;
+	pread.check = check;
+	pread.bounds = NULL;
+	pread.next_range = 0;
+	pread.n_rows = 0;
+	pread.err = DB_SUCCESS;
+
+	pread.n_ranges = 1 + (n_threads > 1
+			      ? row_pread_split(
+				      index,
+				      n_threads * ROW_PREAD_RANGES_PER_THREAD,
+				      heap, &pread.bounds)
+			      : 0);
+
+	/* The calling thread scans ranges too. */
+	n_helpers = ut_min(n_threads, pread.n_ranges) - 1;
+
+	os_event_reset(pread.done);
+	pread.n_helpers = n_helpers;
+
+	for (ulint i = 0; i < n_helpers; i++) {
+		os_thread_create(row_pread_thread, &pread, NULL);
+	}
+
+	row_pread_scan(&pread);
+
+	if (n_helpers > 0) {
+		os_event_wait(pread.done);
+	}
+
+	*n_rows = pread.n_rows;
+
+	os_event_free(pread.done);
+	os_mutex_free(pread.mutex);
+	mem_heap_free(heap);
+
+	return(pread.err);
+}
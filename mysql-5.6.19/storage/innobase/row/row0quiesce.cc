@@ -654,6 +654,15 @@ row_quiesce_set_state(
 		ib_senderrf(trx->mysql_thd, IB_LOG_LEVEL_WARN,
 			    ER_TABLE_IN_SYSTEM_TABLESPACE, table_name);
 
+		return(DB_UNSUPPORTED);
+	} else if (DICT_TF2_FLAG_IS_SET(table, DICT_TF2_INSTANT)) {
+
+		ib_senderrf(trx->mysql_thd, IB_LOG_LEVEL_WARN,
+			    ER_NOT_SUPPORTED_YET,
+			    "FLUSH TABLES ... FOR EXPORT on a table to which "
+			    "columns were added instantly. Rebuild the table "
+			    "first.");
+
 		return(DB_UNSUPPORTED);
 	} else if (row_quiesce_table_has_fts_index(table)) {
 
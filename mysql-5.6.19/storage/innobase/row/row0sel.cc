@@ -3327,6 +3327,24 @@ row_sel_copy_cached_field_for_mysql(
 	ut_memcpy(buf, cache, len);
 }
 
+/********************************************************************//**
+Gets a row slot of the fetch cache.
+@return pointer to the row */
+UNIV_INLINE
+byte*
+row_sel_fetch_cache_row(
+/*====================*/
+	const row_prebuilt_t*	prebuilt,	/*!< in: prebuilt struct */
+	ulint			i)		/*!< in: slot number */
+{
+	ut_ad(i < prebuilt->fetch_cache_n_alloc);
+
+	/* Skip the magic numbers of the preceding slots and of
+	this slot. */
+	return(prebuilt->fetch_cache
+	       + i * (prebuilt->mysql_row_len + 8) + 4);
+}
+
 /********************************************************************//**
 Pops a cached row for MySQL from the fetch cache. */
 UNIV_INLINE
@@ -3345,7 +3363,8 @@ row_sel_dequeue_cached_row_for_mysql(
 
 	UNIV_MEM_ASSERT_W(buf, prebuilt->mysql_row_len);
 
-	cached_rec = prebuilt->fetch_cache[prebuilt->fetch_cache_first];
+	cached_rec = row_sel_fetch_cache_row(
+		prebuilt, prebuilt->fetch_cache_first);
 
 	if (UNIV_UNLIKELY(prebuilt->keep_other_fields_on_keyread)) {
 		/* Copy cache record field by field, don't touch fields that
@@ -3396,27 +3415,30 @@ UNIV_INLINE
 void
 row_sel_prefetch_cache_init(
 /*========================*/
-	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct */
+	ulint		n_rows)		/*!< in: number of row slots */
 {
 	ulint	i;
 	ulint	sz;
 	byte*	ptr;
 
+	ut_ad(prebuilt->fetch_cache == NULL);
+
 	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+	sz = n_rows * (prebuilt->mysql_row_len + 8);
 	ptr = static_cast<byte*>(mem_alloc(sz));
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	prebuilt->fetch_cache = ptr;
+	prebuilt->fetch_cache_n_alloc = n_rows;
+
+	for (i = 0; i < n_rows; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
 		to track a possible bug. */
 
 		mach_write_to_4(ptr, ROW_PREBUILT_FETCH_MAGIC_N);
-		ptr += 4;
-
-		prebuilt->fetch_cache[i] = ptr;
-		ptr += prebuilt->mysql_row_len;
+		ptr += 4 + prebuilt->mysql_row_len;
 
 		mach_write_to_4(ptr, ROW_PREBUILT_FETCH_MAGIC_N);
 		ptr += 4;
@@ -3432,21 +3454,49 @@ row_sel_fetch_last_buf(
 /*===================*/
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
+	byte*	row;
+
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_size);
+
+	if (prebuilt->n_fetch_cached == 0) {
+		/* A new batch starts. If the scan has already returned
+		a full batch, it is likely to continue: double the batch
+		size within the memory budget, so that the cursor is
+		restored and the pages latched less often. */
+		if (prebuilt->n_rows_fetched >= prebuilt->fetch_cache_size) {
+			ulint	max_size = ut_max(
+				MYSQL_FETCH_CACHE_SIZE,
+				MYSQL_FETCH_CACHE_MAX_BYTES
+				/ (prebuilt->mysql_row_len + 8));
+
+			prebuilt->fetch_cache_size = ut_min(
+				2 * prebuilt->fetch_cache_size, max_size);
+		}
 
-	if (prebuilt->fetch_cache[0] == NULL) {
+		/* The cache is empty: it can be reallocated. */
+		if (prebuilt->fetch_cache_size
+		    > prebuilt->fetch_cache_n_alloc
+		    && prebuilt->fetch_cache != NULL) {
+
+			row_prebuilt_free_fetch_cache(prebuilt);
+		}
+	}
+
+	if (prebuilt->fetch_cache == NULL) {
 		/* Allocate memory for the fetch cache */
 		ut_ad(prebuilt->n_fetch_cached == 0);
 
-		row_sel_prefetch_cache_init(prebuilt);
+		row_sel_prefetch_cache_init(
+			prebuilt, prebuilt->fetch_cache_size);
 	}
 
 	ut_ad(prebuilt->fetch_cache_first == 0);
-	UNIV_MEM_INVALID(prebuilt->fetch_cache[prebuilt->n_fetch_cached],
-			 prebuilt->mysql_row_len);
 
-	return(prebuilt->fetch_cache[prebuilt->n_fetch_cached]);
+	row = row_sel_fetch_cache_row(prebuilt, prebuilt->n_fetch_cached);
+	UNIV_MEM_INVALID(row, prebuilt->mysql_row_len);
+
+	return(row);
 }
 
 /********************************************************************//**
@@ -3795,6 +3845,7 @@ row_search_for_mysql(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_size = MYSQL_FETCH_CACHE_SIZE;
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -3819,6 +3870,7 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched = 0;
 			prebuilt->n_fetch_cached = 0;
 			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_size = MYSQL_FETCH_CACHE_SIZE;
 
 		} else if (UNIV_LIKELY(prebuilt->n_fetch_cached > 0)) {
 			row_sel_dequeue_cached_row_for_mysql(buf, prebuilt);
@@ -3830,7 +3882,8 @@ row_search_for_mysql(
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_size) {
 
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -4829,7 +4882,7 @@ requires_clust_rec:
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached < prebuilt->fetch_cache_size);
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -4882,7 +4935,7 @@ requires_clust_rec:
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_size) {
 			goto next_rec;
 		}
 
@@ -465,7 +465,8 @@ row_upd_changes_field_size_or_external(
 		}
 
 		if (dfield_is_ext(new_val) || old_len != new_len
-		    || rec_offs_nth_extern(offsets, upd_field->field_no)) {
+		    || rec_offs_nth_extern(offsets, upd_field->field_no)
+		    || rec_offs_nth_default(offsets, upd_field->field_no)) {
 
 			return(TRUE);
 		}
@@ -1692,6 +1693,7 @@ row_upd_sec_index_entry(
 #endif /* UNIV_DEBUG */
 
 	mtr_start(&mtr);
+	dict_disable_redo_if_temporary(index->table, &mtr);
 
 	if (*index->name == TEMP_INDEX_PREFIX) {
 		/* The index->online_status may change if the
@@ -2159,6 +2161,7 @@ row_upd_clust_rec(
 	down the index tree */
 
 	mtr_start(mtr);
+	dict_disable_redo_if_temporary(index->table, mtr);
 
 	/* NOTE: this transaction has an s-lock or x-lock on the record and
 	therefore other transactions cannot modify the record when we have no
@@ -2326,6 +2329,7 @@ row_upd_clust_step(
 	/* We have to restore the cursor to its position */
 
 	mtr_start(&mtr);
+	dict_disable_redo_if_temporary(index->table, &mtr);
 
 	/* If the restoration does not succeed, then the same
 	transaction has deleted the record on which the cursor was,
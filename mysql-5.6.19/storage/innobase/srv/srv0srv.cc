@@ -85,6 +85,8 @@ UNIV_INTERN ibool	srv_error_monitor_active = FALSE;
 
 UNIV_INTERN ibool	srv_buf_dump_thread_active = FALSE;
 
+UNIV_INTERN ibool	srv_buf_resize_thread_active = FALSE;
+
 UNIV_INTERN ibool	srv_dict_stats_thread_active = FALSE;
 
 UNIV_INTERN const char*	srv_main_thread_op_info = "";
@@ -138,8 +140,20 @@ on duplicate key checking and foreign key checking */
 UNIV_INTERN ibool	srv_locks_unsafe_for_binlog = FALSE;
 /** Sort buffer size in index creation */
 UNIV_INTERN ulong	srv_sort_buf_size = 1048576;
+/** Number of threads that merge sort and insert the entries of the
+indexes being created */
+UNIV_INTERN ulong	srv_sort_threads = 4;
+/** Percentage of each index page that is filled when an index tree
+is built bottom-up */
+UNIV_INTERN ulong	srv_fill_factor = 100;
+/** Number of threads that scan a clustered index in parallel for
+COUNT(*) and CHECK TABLE */
+UNIV_INTERN ulong	srv_parallel_read_threads = 4;
 /** Maximum modification log file size for online index creation */
 UNIV_INTERN unsigned long long	srv_online_max_size;
+/** Number of threads that apply the modification log of a table
+that is being rebuilt online */
+UNIV_INTERN ulong	srv_online_alter_apply_threads = 4;
 
 /* If this flag is TRUE, then we will use the native aio of the
 OS (provided we compiled Innobase with it in), otherwise we will
@@ -147,6 +161,11 @@ use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 UNIV_INTERN my_bool	srv_use_native_aio = TRUE;
 
+/* If this flag is TRUE and native aio is used on Linux, the requests
+are submitted through io_uring instead of libaio when the kernel
+supports it */
+UNIV_INTERN my_bool	srv_use_io_uring = FALSE;
+
 #ifdef __WIN__
 /* Windows native condition variables. We use runtime loading / function
 pointers, because they are not available on Windows Server 2003 and
@@ -222,6 +241,10 @@ UNIV_INTERN ibool srv_use_xa_resume = FALSE;
 UNIV_INTERN ulint	srv_buf_pool_size	= ULINT_MAX;
 /* requested number of buffer pool instances */
 UNIV_INTERN ulint       srv_buf_pool_instances  = 1;
+/* size in bytes of a buffer pool chunk, the unit of online resizing */
+UNIV_INTERN ulong	srv_buf_pool_chunk_unit	= 128 * 1024 * 1024;
+/* whether to bind the memory of every buffer pool instance to a NUMA node */
+UNIV_INTERN my_bool	srv_buf_pool_numa	= FALSE;
 /* number of locks to protect buf_pool->page_hash */
 UNIV_INTERN ulong	srv_n_page_hash_locks = 16;
 /** Scan depth for LRU flush batch i.e.: number of blocks scanned*/
@@ -275,6 +298,13 @@ UNIV_INTERN ulint	srv_max_n_open_files	  = 300;
 UNIV_INTERN ulong	srv_io_capacity         = 200;
 UNIV_INTERN ulong	srv_max_io_capacity     = 400;
 
+/* Percentage of srv_io_capacity that the background change buffer
+merge reads per second when the change buffer is not over half full */
+UNIV_INTERN ulong	srv_ibuf_merge_io_pct   = 5;
+/* Maximum number of pages read by one background change buffer merge
+batch */
+UNIV_INTERN ulong	srv_ibuf_merge_batch    = 64;
+
 /* The InnoDB main thread tries to keep the ratio of modified pages
 in the buffer pool to all database pages in the buffer pool smaller than
 the following number. But it is not guaranteed that the value stays below
@@ -296,6 +326,15 @@ UNIV_INTERN ulong	srv_n_purge_threads = 1;
 /* the number of pages to purge in one batch */
 UNIV_INTERN ulong	srv_purge_batch_size = 20;
 
+/* Whether purge truncates undo tablespaces that have grown beyond
+srv_max_undo_log_size, and the threshold in bytes */
+UNIV_INTERN my_bool	srv_undo_log_truncate = FALSE;
+UNIV_INTERN unsigned long long	srv_max_undo_log_size = 1024 * 1024 * 1024;
+
+/* The number of threads, including the recovery thread itself, that apply
+hashed redo log records to pages during crash recovery. */
+UNIV_INTERN ulong	srv_n_recv_apply_threads = 4;
+
 /* Internal setting for "innodb_stats_method". Decides how InnoDB treats
 NULL value when collecting statistics. By default, it is set to
 SRV_STATS_NULLS_EQUAL(0), ie. all NULL value are treated equal */
@@ -343,9 +382,15 @@ UNIV_INTERN unsigned long long	srv_stats_transient_sample_pages = 8;
 UNIV_INTERN my_bool		srv_stats_persistent = TRUE;
 UNIV_INTERN unsigned long long	srv_stats_persistent_sample_pages = 20;
 UNIV_INTERN my_bool		srv_stats_auto_recalc = TRUE;
+UNIV_INTERN ulong		srv_stats_threads = 4;
 
 UNIV_INTERN ibool	srv_use_doublewrite_buf	= TRUE;
 
+/** If TRUE, the LRU and flush_list batches of every buffer pool instance
+are written through separate doublewrite files instead of the doublewrite
+buffer in the system tablespace. */
+UNIV_INTERN my_bool	srv_dblwr_files			= FALSE;
+
 /** doublewrite buffer is 1MB is size i.e.: it can hold 128 16K pages.
 The following parameter is the size of the buffer that is used for
 batch flushing i.e.: LRU flushing and flush_list flushing. The rest
@@ -595,6 +640,9 @@ UNIV_INTERN os_event_t	srv_error_event;
 /** Event to signal the buffer pool dump/load thread */
 UNIV_INTERN os_event_t	srv_buf_dump_event;
 
+/** Event to signal the buffer pool resize thread */
+UNIV_INTERN os_event_t	srv_buf_resize_event;
+
 /** The buffer pool dump/load file name */
 UNIV_INTERN char*	srv_buf_dump_filename;
 
@@ -603,6 +651,10 @@ and/or load it during startup. */
 UNIV_INTERN char	srv_buffer_pool_dump_at_shutdown = FALSE;
 UNIV_INTERN char	srv_buffer_pool_load_at_startup = FALSE;
 
+/** Interval in seconds between periodic buffer pool dumps, 0 if
+the buffer pool is only dumped on request and at shutdown */
+UNIV_INTERN ulong	srv_buf_dump_interval = 0;
+
 /** Slot index in the srv_sys->sys_threads array for the purge thread. */
 static const ulint	SRV_PURGE_SLOT	= 1;
 
@@ -960,6 +1012,8 @@ srv_init(void)
 
 		srv_buf_dump_event = os_event_create();
 
+		srv_buf_resize_event = os_event_create();
+
 		UT_LIST_INIT(srv_sys->tasks);
 	}
 
@@ -1006,6 +1060,9 @@ srv_free(void)
 	if (!srv_read_only_mode) {
 		os_event_free(srv_buf_dump_event);
 		srv_buf_dump_event = NULL;
+
+		os_event_free(srv_buf_resize_event);
+		srv_buf_resize_event = NULL;
 	}
 }
 
@@ -1970,6 +2027,8 @@ srv_any_background_threads_are_active(void)
 		thread_active = "srv_monitor_thread";
 	} else if (srv_buf_dump_thread_active) {
 		thread_active = "buf_dump_thread";
+	} else if (srv_buf_resize_thread_active) {
+		thread_active = "buf_resize_thread";
 	} else if (srv_dict_stats_thread_active) {
 		thread_active = "dict_stats_thread";
 	}
@@ -1977,6 +2036,7 @@ srv_any_background_threads_are_active(void)
 	os_event_set(srv_error_event);
 	os_event_set(srv_monitor_event);
 	os_event_set(srv_buf_dump_event);
+	os_event_set(srv_buf_resize_event);
 	os_event_set(lock_sys->timeout_event);
 	os_event_set(dict_stats_event);
 
@@ -2652,6 +2712,7 @@ srv_do_purge(
 	static ulint	count = 0;
 	static ulint	n_use_threads = 0;
 	static ulint	rseg_history_len = 0;
+	static ulint	batch_size = 0;
 	ulint		old_activity_count = srv_get_activity_count();
 
 	ut_a(n_threads > 0);
@@ -2677,6 +2738,11 @@ srv_do_purge(
 
 			if (n_use_threads < n_threads) {
 				++n_use_threads;
+			} else {
+				/* All threads are in use: let each
+				of them purge more per batch. */
+				batch_size = ut_min(2 * batch_size,
+						    SRV_PURGE_MAX_BATCH_SIZE);
 			}
 
 		} else if (srv_check_activity(old_activity_count)
@@ -2688,8 +2754,14 @@ srv_do_purge(
 			--n_use_threads;
 
 			old_activity_count = srv_get_activity_count();
+		} else {
+			batch_size /= 2;
 		}
 
+		/* The batch size grows with the history list, but it is
+		never smaller than what was configured. */
+		batch_size = ut_max(batch_size, srv_purge_batch_size);
+
 		/* Ensure that the purge threads are less than what
 		was configured. */
 
@@ -2698,11 +2770,22 @@ srv_do_purge(
 
 		/* Take a snapshot of the history list before purge. */
 		if ((rseg_history_len = trx_sys->rseg_history_len) == 0) {
+
+			if (srv_undo_log_truncate
+			    || purge_sys->undo_trunc_space
+			    != ULINT_UNDEFINED) {
+				/* The history is empty, so an oversized
+				undo tablespace can be marked, and a
+				drained one truncated, now. */
+				*n_total_purged += trx_purge(
+					1, srv_purge_batch_size, true);
+			}
+
 			break;
 		}
 
 		n_pages_purged = trx_purge(
-			n_use_threads, srv_purge_batch_size, false);
+			n_use_threads, batch_size, false);
 
 		if (!(count++ % TRX_SYS_N_RSEGS)) {
 			/* Force a truncate of the history list. */
@@ -141,10 +141,6 @@ static os_fast_mutex_t	srv_os_test_mutex;
 static char*	srv_monitor_file_name;
 #endif /* !UNIV_HOTBACKUP */
 
-/** Default undo tablespace size in UNIV_PAGEs count (10MB). */
-static const ulint SRV_UNDO_TABLESPACE_SIZE_IN_PAGES =
-	((1024 * 1024) * 10) / UNIV_PAGE_SIZE_DEF;
-
 /** */
 #define SRV_N_PENDING_IOS_PER_THREAD	OS_AIO_N_PENDING_IOS_PER_THREAD
 #define SRV_MAX_N_PENDING_SYNC_IOS	100
@@ -1655,6 +1651,11 @@ innobase_start_or_create_for_mysql(void)
 	ib_logf(IB_LOG_LEVEL_INFO,
 		"" IB_ATOMICS_STARTUP_MSG "");
 
+#ifdef INNODB_SYNC_USE_FUTEX
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Mutexes and rw_locks wait on Linux futexes");
+#endif /* INNODB_SYNC_USE_FUTEX */
+
 	ib_logf(IB_LOG_LEVEL_INFO,
 		"Compressed tables use zlib " ZLIB_VERSION
 #ifdef UNIV_ZIP_DEBUG
@@ -1794,7 +1795,9 @@ innobase_start_or_create_for_mysql(void)
 			    + 1 /* srv_master_thread */
 			    + 1 /* srv_purge_coordinator_thread */
 			    + 1 /* buf_dump_thread */
+			    + 1 /* buf_resize_thread */
 			    + 1 /* dict_stats_thread */
+			    + 63 /* dict_stats_worker_thread */
 			    + 1 /* fts_optimize_thread */
 			    + 1 /* recv_writer_thread */
 			    + 1 /* buf_flush_page_cleaner_thread */
@@ -1805,6 +1808,7 @@ innobase_start_or_create_for_mysql(void)
 			    + srv_n_read_io_threads
 			    + srv_n_write_io_threads
 			    + srv_n_purge_threads
+			    + srv_n_recv_apply_threads
 			    /* FTS Parallel Sort */
 			    + fts_sort_pll_degree * FTS_NUM_AUX_INDEX
 			      * max_connections;
@@ -1815,6 +1819,20 @@ innobase_start_or_create_for_mysql(void)
 		srv_buf_pool_instances = 1;
 	}
 
+	if (srv_buf_pool_chunk_unit * srv_buf_pool_instances
+	    > srv_buf_pool_size) {
+		/* Every instance must have at least one chunk */
+		srv_buf_pool_chunk_unit = static_cast<ulong>(ut_max(
+			ut_2pow_round(srv_buf_pool_size
+				      / srv_buf_pool_instances,
+				      (ulint) 1024 * 1024),
+			(ulint) 1024 * 1024));
+
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Adjusting innodb_buffer_pool_chunk_size to %lu",
+			(ulong) srv_buf_pool_chunk_unit);
+	}
+
 	srv_boot();
 
 	ib_logf(IB_LOG_LEVEL_INFO,
@@ -2604,6 +2622,10 @@ files_checked:
 		buf_dblwr_create();
 	}
 
+	/* The pages read from the doublewrite files are not needed
+	after the crash recovery */
+	buf_dblwr_files_cleanup();
+
 	/* Here the double write buffer has already been created and so
 	any new rollback segments will be allocated after the double
 	write buffer. The default segment should already exist.
@@ -2670,6 +2692,12 @@ files_checked:
 		return(err);
 	}
 
+	/* Create the SYS_COLUMN_DEFAULTS system table */
+	err = dict_create_or_check_sys_column_defaults();
+	if (err != DB_SUCCESS) {
+		return(err);
+	}
+
 	srv_is_being_started = FALSE;
 
 	ut_a(trx_purge_state() == PURGE_STATE_INIT);
@@ -2865,6 +2893,9 @@ files_checked:
 		/* Create the buffer pool dump/load thread */
 		os_thread_create(buf_dump_thread, NULL, NULL);
 
+		/* Create the buffer pool resize thread */
+		os_thread_create(buf_resize_thread, NULL, NULL);
+
 		/* Create the dict stats gathering thread */
 		os_thread_create(dict_stats_thread, NULL, NULL);
 
@@ -266,6 +266,10 @@ rw_lock_create_func(
 	lock->last_x_line = 0;
 	lock->event = os_event_create();
 	lock->wait_ex_event = os_event_create();
+#ifdef INNODB_SYNC_USE_FUTEX
+	lock->futex_seq = 0;
+	lock->wait_ex_futex_seq = 0;
+#endif /* INNODB_SYNC_USE_FUTEX */
 
 	mutex_enter(&rw_lock_list_mutex);
 
@@ -365,9 +369,13 @@ rw_lock_s_lock_spin(
 	const char*	file_name, /*!< in: file name where lock requested */
 	ulint		line)	/*!< in: line where requested */
 {
+#ifdef INNODB_SYNC_USE_FUTEX
+	ib_uint32_t	seq;	/* futex word value before the last check */
+#else /* INNODB_SYNC_USE_FUTEX */
 	ulint		index;	/* index of the reserved wait cell */
-	ulint		i = 0;	/* spin round count */
 	sync_array_t*	sync_arr;
+#endif /* INNODB_SYNC_USE_FUTEX */
+	ulint		i = 0;	/* spin round count */
 	size_t		counter_index;
 
 	/* We reuse the thread id to index into the counter, cache
@@ -406,17 +414,26 @@ lock_loop:
 
 		rw_lock_stats.rw_s_spin_round_count.add(counter_index, i);
 
+#ifdef INNODB_SYNC_USE_FUTEX
+		/* Read the futex word before setting waiters: a release
+		after this point changes it, and the futex wait below
+		then returns at once. */
+		seq = lock->futex_seq;
+#else /* INNODB_SYNC_USE_FUTEX */
 		sync_arr = sync_array_get_and_reserve_cell(lock,
 							   RW_LOCK_SHARED,
 							   file_name,
 							   line, &index);
+#endif /* INNODB_SYNC_USE_FUTEX */
 
 		/* Set waiters before checking lock_word to ensure wake-up
 		signal is sent. This may lead to some unnecessary signals. */
 		rw_lock_set_waiter_flag(lock);
 
 		if (TRUE == rw_lock_s_lock_low(lock, pass, file_name, line)) {
+#ifndef INNODB_SYNC_USE_FUTEX
 			sync_array_free_cell(sync_arr, index);
+#endif /* !INNODB_SYNC_USE_FUTEX */
 			return; /* Success */
 		}
 
@@ -424,7 +441,11 @@ lock_loop:
 		lock->count_os_wait++;
 		rw_lock_stats.rw_s_os_wait_count.add(counter_index, 1);
 
+#ifdef INNODB_SYNC_USE_FUTEX
+		os_futex_wait(&lock->futex_seq, seq);
+#else /* INNODB_SYNC_USE_FUTEX */
 		sync_array_wait_event(sync_arr, index);
+#endif /* INNODB_SYNC_USE_FUTEX */
 
 		i = 0;
 		goto lock_loop;
@@ -466,9 +487,13 @@ rw_lock_x_lock_wait(
 	const char*	file_name,/*!< in: file name where lock requested */
 	ulint		line)	/*!< in: line where requested */
 {
+#ifdef INNODB_SYNC_USE_FUTEX
+	ib_uint32_t	seq;
+#else /* INNODB_SYNC_USE_FUTEX */
 	ulint		index;
-	ulint		i = 0;
 	sync_array_t*	sync_arr;
+#endif /* INNODB_SYNC_USE_FUTEX */
+	ulint		i = 0;
 	size_t		counter_index;
 
 	/* We reuse the thread id to index into the counter, cache
@@ -490,10 +515,16 @@ rw_lock_x_lock_wait(
 		/* If there is still a reader, then go to sleep.*/
 		rw_lock_stats.rw_x_spin_round_count.add(counter_index, i);
 
+#ifdef INNODB_SYNC_USE_FUTEX
+		/* Read the futex word with a full barrier, so that it
+		is read before lock_word is checked below. */
+		seq = os_atomic_increment_uint32(&lock->wait_ex_futex_seq, 0);
+#else /* INNODB_SYNC_USE_FUTEX */
 		sync_arr = sync_array_get_and_reserve_cell(lock,
 							   RW_LOCK_WAIT_EX,
 							   file_name,
 							   line, &index);
+#endif /* INNODB_SYNC_USE_FUTEX */
 
 		i = 0;
 
@@ -512,16 +543,23 @@ rw_lock_x_lock_wait(
 					       file_name, line);
 #endif
 
+#ifdef INNODB_SYNC_USE_FUTEX
+			os_futex_wait(&lock->wait_ex_futex_seq, seq);
+#else /* INNODB_SYNC_USE_FUTEX */
 			sync_array_wait_event(sync_arr, index);
+#endif /* INNODB_SYNC_USE_FUTEX */
 #ifdef UNIV_SYNC_DEBUG
 			rw_lock_remove_debug_info(
 				lock, pass, RW_LOCK_WAIT_EX);
 #endif
 			/* It is possible to wake when lock_word < 0.
 			We must pass the while-loop check to proceed.*/
-		} else {
+		}
+#ifndef INNODB_SYNC_USE_FUTEX
+		else {
 			sync_array_free_cell(sync_arr, index);
 		}
+#endif /* !INNODB_SYNC_USE_FUTEX */
 	}
 	rw_lock_stats.rw_x_spin_round_count.add(counter_index, i);
 }
@@ -604,8 +642,12 @@ rw_lock_x_lock_func(
 	ulint		line)	/*!< in: line where requested */
 {
 	ulint		i;	/*!< spin round count */
+#ifdef INNODB_SYNC_USE_FUTEX
+	ib_uint32_t	seq;	/*!< futex word value before the last check */
+#else /* INNODB_SYNC_USE_FUTEX */
 	ulint		index;	/*!< index of the reserved wait cell */
 	sync_array_t*	sync_arr;
+#endif /* INNODB_SYNC_USE_FUTEX */
 	ibool		spinning = FALSE;
 	size_t		counter_index;
 
@@ -656,15 +698,21 @@ lock_loop:
 
 	rw_lock_stats.rw_x_spin_round_count.add(counter_index, i);
 
+#ifdef INNODB_SYNC_USE_FUTEX
+	seq = lock->futex_seq;
+#else /* INNODB_SYNC_USE_FUTEX */
 	sync_arr = sync_array_get_and_reserve_cell(lock, RW_LOCK_EX,
 						   file_name, line, &index);
+#endif /* INNODB_SYNC_USE_FUTEX */
 
 	/* Waiters must be set before checking lock_word, to ensure signal
 	is sent. This could lead to a few unnecessary wake-up signals. */
 	rw_lock_set_waiter_flag(lock);
 
 	if (rw_lock_x_lock_low(lock, pass, file_name, line)) {
+#ifndef INNODB_SYNC_USE_FUTEX
 		sync_array_free_cell(sync_arr, index);
+#endif /* !INNODB_SYNC_USE_FUTEX */
 		return; /* Locking succeeded */
 	}
 
@@ -672,7 +720,11 @@ lock_loop:
 	lock->count_os_wait++;
 	rw_lock_stats.rw_x_os_wait_count.add(counter_index, 1);
 
+#ifdef INNODB_SYNC_USE_FUTEX
+	os_futex_wait(&lock->futex_seq, seq);
+#else /* INNODB_SYNC_USE_FUTEX */
 	sync_array_wait_event(sync_arr, index);
+#endif /* INNODB_SYNC_USE_FUTEX */
 
 	i = 0;
 	goto lock_loop;
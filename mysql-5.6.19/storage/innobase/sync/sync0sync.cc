@@ -436,7 +436,7 @@ mutex_own(
 {
 	ut_ad(mutex_validate(mutex));
 
-	return(mutex_get_lock_word(mutex) == 1
+	return(mutex_get_lock_word(mutex) != 0
 	       && os_thread_eq(mutex->thread_id, os_thread_get_curr_id()));
 }
 #endif /* UNIV_DEBUG */
@@ -474,8 +474,10 @@ mutex_spin_wait(
 	ulint		line)		/*!< in: line where requested */
 {
 	ulint		i;		/* spin round count */
+#ifndef INNODB_SYNC_USE_FUTEX
 	ulint		index;		/* index of the reserved wait cell */
 	sync_array_t*	sync_arr;
+#endif /* !INNODB_SYNC_USE_FUTEX */
 	size_t		counter_index;
 
 	counter_index = (size_t) os_thread_get_curr_id();
@@ -488,7 +490,9 @@ mutex_spin_wait(
 	Count the number of calls to mutex_spin_wait. */
 	mutex_spin_wait_count.add(counter_index, 1);
 
+#ifndef INNODB_SYNC_USE_FUTEX
 mutex_loop:
+#endif /* !INNODB_SYNC_USE_FUTEX */
 
 	i = 0;
 
@@ -501,6 +505,15 @@ mutex_loop:
 spin_loop:
 
 	while (mutex_get_lock_word(mutex) != 0 && i < SYNC_SPIN_ROUNDS) {
+#ifdef INNODB_SYNC_USE_FUTEX
+		if (mutex_get_lock_word(mutex) == MUTEX_FUTEX_CONTENDED) {
+			/* Threads are already sleeping on the mutex and
+			the next release hands it to one of them: spinning
+			further would only burn CPU. */
+			mutex_spin_round_count.add(counter_index, i);
+			goto futex_wait;
+		}
+#endif /* INNODB_SYNC_USE_FUTEX */
 		if (srv_spin_wait_delay) {
 			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
 		}
@@ -537,6 +550,28 @@ spin_loop:
 		goto spin_loop;
 	}
 
+#ifdef INNODB_SYNC_USE_FUTEX
+futex_wait:
+	/* Mark the mutex contended and sleep until it is released. If
+	the exchange returns MUTEX_FUTEX_FREE we own the mutex, and since
+	lock_word stays MUTEX_FUTEX_CONTENDED our mutex_exit will wake up
+	the next sleeper, if any. */
+	while (os_atomic_test_and_set_uint32(&mutex->lock_word,
+					     MUTEX_FUTEX_CONTENDED)
+	       != MUTEX_FUTEX_FREE) {
+
+		mutex_os_wait_count.add(counter_index, 1);
+
+		mutex->count_os_wait++;
+
+		os_futex_wait(&mutex->lock_word, MUTEX_FUTEX_CONTENDED);
+	}
+
+	ut_d(mutex->thread_id = os_thread_get_curr_id());
+#ifdef UNIV_SYNC_DEBUG
+	mutex_set_debug_info(mutex, file_name, line);
+#endif
+#else /* INNODB_SYNC_USE_FUTEX */
 	sync_arr = sync_array_get_and_reserve_cell(mutex, SYNC_MUTEX,
 						   file_name, line, &index);
 
@@ -579,6 +614,7 @@ spin_loop:
 	sync_array_wait_event(sync_arr, index);
 
 	goto mutex_loop;
+#endif /* INNODB_SYNC_USE_FUTEX */
 }
 
 /******************************************************************//**
@@ -589,12 +625,18 @@ mutex_signal_object(
 /*================*/
 	ib_mutex_t*	mutex)	/*!< in: mutex */
 {
+#ifdef INNODB_SYNC_USE_FUTEX
+	/* Wake up a single sleeper: the mutex can only be granted to
+	one thread, and waking all of them would be a thundering herd. */
+	os_futex_wake(&mutex->lock_word, 1);
+#else /* INNODB_SYNC_USE_FUTEX */
 	mutex_set_waiters(mutex, 0);
 
 	/* The memory order of resetting the waiters field and
 	signaling the object is important. See LEMMA 1 above. */
 	os_event_set(mutex->event);
 	sync_array_object_signalled();
+#endif /* INNODB_SYNC_USE_FUTEX */
 }
 
 #ifdef UNIV_SYNC_DEBUG
@@ -1144,6 +1186,7 @@ sync_thread_add_level(
 	case SYNC_LOG:
 	case SYNC_LOG_FLUSH_ORDER:
 	case SYNC_ANY_LATCH:
+	case SYNC_FIL_SPACE_HASH:
 	case SYNC_FILE_FORMAT_TAG:
 	case SYNC_DOUBLEWRITE:
 	case SYNC_SEARCH_SYS:
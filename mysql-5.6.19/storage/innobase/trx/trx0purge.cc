@@ -45,6 +45,13 @@ Created 3/26/1996 Heikki Tuuri
 #include "os0thread.h"
 #include "srv0mon.h"
 #include "mtr0log.h"
+#include "buf0lru.h"
+#include "log0log.h"
+
+#include <map>
+
+/** Maps the tables of a purge batch to the purge nodes that own them */
+typedef std::map<table_id_t, ulint>	purge_table_node_map;
 
 /** Maximum allowable purge history length.  <=0 means 'infinite'. */
 UNIV_INTERN ulong		srv_max_purge_lag = 0;
@@ -133,6 +140,8 @@ trx_purge_sys_create(
 
 	purge_sys->heap = mem_heap_create(256);
 
+	purge_sys->undo_trunc_space = ULINT_UNDEFINED;
+
 	ut_a(n_purge_threads > 0);
 
 	purge_sys->sess = sess_open();
@@ -955,6 +964,63 @@ trx_purge_fetch_next_rec(
 	return(trx_purge_get_next_rec(n_pages_handled, heap));
 }
 
+/*******************************************************************//**
+Chooses the purge node that an undo log record is handed to. All records
+of a table within a batch go to the same node; a table that has not been
+seen yet in the batch goes to the node with the fewest records.
+@return index of the node */
+static
+ulint
+trx_purge_choose_node(
+/*==================*/
+	trx_undo_rec_t*		undo_rec,	/*!< in: undo log record, or
+						&trx_purge_dummy_rec */
+	ulint			n_nodes,	/*!< in: number of nodes */
+	const ulint*		n_recs,		/*!< in: number of records
+						handed to each node so far */
+	purge_table_node_map&	table_nodes,	/*!< in/out: node of each
+						table seen in the batch */
+	table_id_t*		prev_table_id,	/*!< in/out: table of the
+						previous record */
+	ulint*			prev_node)	/*!< in/out: node of the
+						previous record, or
+						ULINT_UNDEFINED */
+{
+	ulint		least = 0;
+	ulint		type;
+	ulint		cmpl_info;
+	bool		updated_extern;
+	undo_no_t	undo_no;
+	table_id_t	table_id;
+
+	for (ulint i = 1; i < n_nodes; ++i) {
+		if (n_recs[i] < n_recs[least]) {
+			least = i;
+		}
+	}
+
+	if (undo_rec == &trx_purge_dummy_rec) {
+		/* Nothing to purge; any node will do. */
+		return(least);
+	}
+
+	trx_undo_rec_get_pars(undo_rec, &type, &cmpl_info,
+			      &updated_extern, &undo_no, &table_id);
+
+	/* Consecutive records are usually for the same table. */
+	if (*prev_node != ULINT_UNDEFINED && table_id == *prev_table_id) {
+		return(*prev_node);
+	}
+
+	std::pair<purge_table_node_map::iterator, bool>	ins
+		= table_nodes.insert(std::make_pair(table_id, least));
+
+	*prev_table_id = table_id;
+	*prev_node = ins.first->second;
+
+	return(*prev_node);
+}
+
 /*******************************************************************//**
 This function runs a purge batch.
 @return	number of undo log pages handled in the batch */
@@ -971,8 +1037,14 @@ trx_purge_attach_undo_recs(
 	ulint		i = 0;
 	ulint		n_pages_handled = 0;
 	ulint		n_thrs = UT_LIST_GET_LEN(purge_sys->query->thrs);
+	purge_node_t*	nodes[SRV_MAX_N_PURGE_THREADS];
+	ulint		n_recs[SRV_MAX_N_PURGE_THREADS];
+	table_id_t	prev_table_id = 0;
+	ulint		prev_node = ULINT_UNDEFINED;
+	purge_table_node_map	table_nodes;
 
 	ut_a(n_purge_threads > 0);
+	ut_a(n_purge_threads <= SRV_MAX_N_PURGE_THREADS);
 
 	*limit = purge_sys->iter;
 
@@ -991,6 +1063,9 @@ trx_purge_attach_undo_recs(
 		ut_a(node->done);
 
 		node->done = FALSE;
+
+		nodes[i] = node;
+		n_recs[i] = 0;
 	}
 
 	/* There should never be fewer nodes than threads, the inverse
@@ -998,26 +1073,22 @@ trx_purge_attach_undo_recs(
 	ut_a(i == n_purge_threads);
 
 	/* Fetch and parse the UNDO records. The UNDO records are added
-	to a per purge node vector. */
+	to a per purge node vector. All records of a table go to the same
+	node, so that the workers do not contend on the same index pages.
+	A table that is seen for the first time in this batch is given to
+	the node that has the fewest records so far. The records are
+	allocated from purge_sys->heap, which is emptied only at the start
+	of the next batch, because the owning node is not known until the
+	record has been read. */
 	thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
 	ut_a(n_thrs > 0 && thr != NULL);
 
 	ut_ad(trx_purge_check_limit());
 
-	i = 0;
-
 	for (;;) {
 		purge_node_t*		node;
-		trx_purge_rec_t*	purge_rec;
-
-		ut_a(!thr->is_active);
-
-		/* Get the purge node. */
-		node = (purge_node_t*) thr->child;
-		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
-
-		purge_rec = static_cast<trx_purge_rec_t*>(
-			mem_heap_zalloc(node->heap, sizeof(*purge_rec)));
+		trx_purge_rec_t		purge_rec;
+		ulint			n;
 
 		/* Track the max {trx_id, undo_no} for truncating the
 		UNDO logs once we have purged the records. */
@@ -1030,37 +1101,41 @@ trx_purge_attach_undo_recs(
 		}
 
 		/* Fetch the next record, and advance the purge_sys->iter. */
-		purge_rec->undo_rec = trx_purge_fetch_next_rec(
-			&purge_rec->roll_ptr, &n_pages_handled, node->heap);
-
-		if (purge_rec->undo_rec != NULL) {
-
-			if (node->undo_recs == NULL) {
-				node->undo_recs = ib_vector_create(
-					ib_heap_allocator_create(node->heap),
-					sizeof(trx_purge_rec_t),
-					batch_size);
-			} else {
-				ut_a(!ib_vector_is_empty(node->undo_recs));
-			}
+		purge_rec.undo_rec = trx_purge_fetch_next_rec(
+			&purge_rec.roll_ptr, &n_pages_handled,
+			purge_sys->heap);
 
-			ib_vector_push(node->undo_recs, purge_rec);
+		if (purge_rec.undo_rec == NULL) {
+			break;
+		}
 
-			if (n_pages_handled >= batch_size) {
+		n = trx_purge_choose_node(
+			purge_rec.undo_rec, n_purge_threads, n_recs,
+			table_nodes, &prev_table_id, &prev_node);
 
-				break;
-			}
+		node = nodes[n];
+
+		if (node->undo_recs == NULL) {
+			node->undo_recs = ib_vector_create(
+				ib_heap_allocator_create(node->heap),
+				sizeof(trx_purge_rec_t),
+				batch_size);
 		} else {
-			break;
+			ut_a(!ib_vector_is_empty(node->undo_recs));
 		}
 
-		thr = UT_LIST_GET_NEXT(thrs, thr);
+		ib_vector_push(node->undo_recs, &purge_rec);
 
-		if (!(++i % n_purge_threads)) {
-			thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
+		++n_recs[n];
+
+		if (n_pages_handled >= batch_size) {
+
+			break;
 		}
+	}
 
-		ut_a(thr != NULL);
+	for (i = 0; i < n_purge_threads; ++i) {
+		nodes[i]->n_recs_total += n_recs[i];
 	}
 
 	ut_ad(trx_purge_check_limit());
@@ -1068,6 +1143,32 @@ trx_purge_attach_undo_recs(
 	return(n_pages_handled);
 }
 
+/*******************************************************************//**
+Records the current time and transaction number in the ring buffer used
+by trx_purge_get_history_age(), unless the previous sample is recent. */
+static
+void
+trx_purge_sample_lag(void)
+/*======================*/
+{
+	ib_time_t	now = ut_time();
+	ulint		prev = (purge_sys->lag_next + TRX_PURGE_N_LAG_SAMPLES - 1)
+		% TRX_PURGE_N_LAG_SAMPLES;
+
+	if (purge_sys->lag_time[prev] != 0
+	    && ut_difftime(now, purge_sys->lag_time[prev])
+	    < TRX_PURGE_LAG_SAMPLE_INTERVAL) {
+
+		return;
+	}
+
+	purge_sys->lag_trx_no[purge_sys->lag_next] = trx_sys_get_max_trx_id();
+	purge_sys->lag_time[purge_sys->lag_next] = now;
+
+	purge_sys->lag_next = (purge_sys->lag_next + 1)
+		% TRX_PURGE_N_LAG_SAMPLES;
+}
+
 /*******************************************************************//**
 Calculate the DML delay required.
 @return delay in microseconds or ULINT_MAX */
@@ -1155,6 +1256,262 @@ trx_purge_wait_for_workers_to_complete(
 	ut_a(srv_get_task_queue_length() == 0);
 }
 
+/******************************************************************//**
+Sets or clears the skip_allocation flag of the rollback segments in an
+undo tablespace. */
+static
+void
+trx_purge_undo_space_set_skip(
+/*==========================*/
+	ulint	space_id,	/*!< in: undo tablespace id */
+	bool	skip)		/*!< in: whether to stop assigning the
+				rollback segments to new transactions */
+{
+	for (ulint i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		trx_rseg_t*	rseg = trx_sys->rseg_array[i];
+
+		if (rseg != NULL && rseg->space == space_id) {
+			mutex_enter(&rseg->mutex);
+			rseg->skip_allocation = skip;
+			mutex_exit(&rseg->mutex);
+		}
+	}
+}
+
+/******************************************************************//**
+Looks for an undo tablespace that has grown beyond srv_max_undo_log_size
+and marks it for truncation, so that no new transactions are assigned to
+its rollback segments and purge can drain them. */
+static
+void
+trx_purge_mark_undo_for_truncate(void)
+/*==================================*/
+{
+	ut_ad(purge_sys->undo_trunc_space == ULINT_UNDEFINED);
+
+	/* Keep at least one undo tablespace open for new transactions. */
+	if (srv_undo_tablespaces_open < 2) {
+		return;
+	}
+
+	for (ulint i = 0; i < srv_undo_tablespaces_open; ++i) {
+		ulint	space_id;
+		ulint	size;
+
+		/* Undo tablespace ids start from 1. */
+		space_id = purge_sys->undo_trunc_last
+			% srv_undo_tablespaces_open + 1;
+		purge_sys->undo_trunc_last = space_id;
+
+		size = fil_space_get_size(space_id);
+
+		if (size > SRV_UNDO_TABLESPACE_SIZE_IN_PAGES
+		    && ((ib_uint64_t) size << UNIV_PAGE_SIZE_SHIFT)
+		    > srv_max_undo_log_size) {
+
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Undo tablespace %lu has grown to %lu pages;"
+				" marking it for truncation.",
+				(ulong) space_id, (ulong) size);
+
+			trx_purge_undo_space_set_skip(space_id, true);
+			purge_sys->undo_trunc_space = space_id;
+
+			return;
+		}
+	}
+}
+
+/******************************************************************//**
+Checks whether all the rollback segments of an undo tablespace are
+unused and have no history left to purge.
+@return true if the tablespace can be truncated */
+static
+bool
+trx_purge_undo_space_is_drained(
+/*============================*/
+	ulint	space_id)	/*!< in: undo tablespace id */
+{
+	for (ulint i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		trx_rseg_t*	rseg = trx_sys->rseg_array[i];
+		bool		drained;
+		mtr_t		mtr;
+		ulint		len;
+
+		if (rseg == NULL || rseg->space != space_id) {
+			continue;
+		}
+
+		mutex_enter(&rseg->mutex);
+
+		drained = rseg->trx_ref_count == 0
+			&& UT_LIST_GET_LEN(rseg->update_undo_list) == 0
+			&& UT_LIST_GET_LEN(rseg->insert_undo_list) == 0
+			&& rseg->last_page_no == FIL_NULL;
+
+		mutex_exit(&rseg->mutex);
+
+		if (!drained
+		    || (purge_sys->rseg == rseg && purge_sys->next_stored)) {
+
+			return(false);
+		}
+
+		/* The history list is truncated behind the purge view,
+		so it can still be non-empty after the logs were purged. */
+		mtr_start(&mtr);
+
+		len = flst_get_len(
+			trx_rsegf_get(rseg->space, rseg->zip_size,
+				      rseg->page_no, &mtr)
+			+ TRX_RSEG_HISTORY, &mtr);
+
+		mtr_commit(&mtr);
+
+		if (len > 0) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/******************************************************************//**
+Truncates a drained undo tablespace to its initial size, creates its
+rollback segment headers anew and makes its rollback segments available
+to new transactions again.
+
+The old pages of the tablespace are discarded from the buffer pool and
+the tablespace is reinitialized in one mini-transaction, which also
+updates the rollback segment slots in the transaction system header. A
+log checkpoint is made before the file is shrunk, so that recovery never
+applies redo log records to pages beyond the new end of the file. If the
+server is killed before the file is shrunk, the tablespace is left
+reinitialized at its old file size. */
+static
+void
+trx_purge_truncate_undo_space(
+/*==========================*/
+	ulint	space_id)	/*!< in: undo tablespace id */
+{
+	ulint	page_nos[TRX_SYS_N_RSEGS];
+	mtr_t	mtr;
+	ulint	i;
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Truncating undo tablespace %lu.", (ulong) space_id);
+
+	/* No transaction uses the tablespace any more. Its pages need
+	not be written, because they are all reinitialized or freed. */
+	buf_LRU_flush_or_remove_pages(space_id, BUF_REMOVE_ALL_NO_WRITE, NULL);
+
+	mtr_start(&mtr);
+
+	fsp_header_init(space_id, SRV_UNDO_TABLESPACE_SIZE_IN_PAGES, &mtr);
+
+	for (i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		const trx_rseg_t*	rseg = trx_sys->rseg_array[i];
+
+		if (rseg != NULL && rseg->space == space_id) {
+			page_nos[i] = trx_rseg_header_create(
+				space_id, rseg->zip_size, rseg->max_size,
+				rseg->id, &mtr);
+
+			ut_a(page_nos[i] != FIL_NULL);
+		}
+	}
+
+	mtr_commit(&mtr);
+
+	for (i = 0; i < TRX_SYS_N_RSEGS; ++i) {
+		trx_rseg_t*	rseg = trx_sys->rseg_array[i];
+		trx_undo_t*	undo;
+
+		if (rseg == NULL || rseg->space != space_id) {
+			continue;
+		}
+
+		mutex_enter(&rseg->mutex);
+
+		/* The cached undo log segments were freed along with
+		the rest of the tablespace. */
+		while ((undo = UT_LIST_GET_FIRST(rseg->update_undo_cached))) {
+			UT_LIST_REMOVE(undo_list, rseg->update_undo_cached, undo);
+			trx_undo_mem_free(undo);
+		}
+
+		while ((undo = UT_LIST_GET_FIRST(rseg->insert_undo_cached))) {
+			UT_LIST_REMOVE(undo_list, rseg->insert_undo_cached, undo);
+			trx_undo_mem_free(undo);
+		}
+
+		rseg->page_no = page_nos[i];
+		rseg->curr_size = 1;
+		rseg->last_page_no = FIL_NULL;
+		rseg->last_offset = 0;
+		rseg->last_trx_no = 0;
+		rseg->last_del_marks = FALSE;
+
+		mutex_exit(&rseg->mutex);
+	}
+
+	log_make_checkpoint_at(LSN_MAX, TRUE);
+
+	if (!fil_truncate_space(space_id, SRV_UNDO_TABLESPACE_SIZE_IN_PAGES)) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Could not shrink the file of undo tablespace %lu;"
+			" it keeps its old size.", (ulong) space_id);
+	} else {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Truncated undo tablespace %lu to %lu pages.",
+			(ulong) space_id,
+			(ulong) SRV_UNDO_TABLESPACE_SIZE_IN_PAGES);
+	}
+
+	trx_purge_undo_space_set_skip(space_id, false);
+}
+
+/******************************************************************//**
+Marks an oversized undo tablespace for truncation, or truncates the
+marked one once purge has drained it. */
+static
+void
+trx_purge_truncate_undo(void)
+/*=========================*/
+{
+	ulint	space_id = purge_sys->undo_trunc_space;
+
+	if (space_id == ULINT_UNDEFINED) {
+		if (!srv_undo_log_truncate) {
+			return;
+		}
+
+		trx_purge_mark_undo_for_truncate();
+
+		/* On an idle server the marked tablespace may
+		already be drained. */
+		space_id = purge_sys->undo_trunc_space;
+
+		if (space_id == ULINT_UNDEFINED) {
+			return;
+		}
+	}
+
+	if (!srv_undo_log_truncate) {
+		/* Truncation was disabled while the tablespace was
+		being drained: make it available again. */
+		trx_purge_undo_space_set_skip(space_id, false);
+	} else if (srv_shutdown_state != SRV_SHUTDOWN_NONE
+		   || !trx_purge_undo_space_is_drained(space_id)) {
+
+		return;
+	} else {
+		trx_purge_truncate_undo_space(space_id);
+	}
+
+	purge_sys->undo_trunc_space = ULINT_UNDEFINED;
+}
+
 /******************************************************************//**
 Remove old historical changes from the rollback segments. */
 static
@@ -1169,6 +1526,8 @@ trx_purge_truncate(void)
 	} else {
 		trx_purge_truncate_history(&purge_sys->limit, purge_sys->view);
 	}
+
+	trx_purge_truncate_undo();
 }
 
 /*******************************************************************//**
@@ -1191,6 +1550,8 @@ trx_purge(
 
 	srv_dml_needed_delay = trx_purge_dml_delay();
 
+	trx_purge_sample_lag();
+
 	/* The number of tasks submitted should be completed. */
 	ut_a(purge_sys->n_submitted == purge_sys->n_completed);
 
@@ -1275,6 +1636,92 @@ run_synchronously:
 	return(n_pages_handled);
 }
 
+/*******************************************************************//**
+Estimates how long ago the oldest transaction whose undo log records
+have not been purged yet was committed. Transaction numbers are assigned
+at commit from the same counter as transaction ids, so that transaction
+was committed after the latest sample whose transaction id counter is not
+bigger than its number.
+@return age in seconds */
+UNIV_INTERN
+ulint
+trx_purge_get_history_age(
+/*======================*/
+	bool*	at_least)	/*!< out: true if the transaction is older
+				than the oldest sample kept, and the age
+				is only a lower limit */
+{
+	trx_id_t	trx_no = purge_sys->iter.trx_no;
+	ib_time_t	now = ut_time();
+	ib_time_t	newest = 0;
+	ib_time_t	oldest = 0;
+
+	*at_least = false;
+
+	if (trx_sys->rseg_history_len == 0) {
+		return(0);
+	}
+
+	for (ulint i = 0; i < TRX_PURGE_N_LAG_SAMPLES; ++i) {
+		ib_time_t	t = purge_sys->lag_time[i];
+
+		if (t == 0) {
+			continue;
+		}
+
+		if (oldest == 0 || t < oldest) {
+			oldest = t;
+		}
+
+		if (purge_sys->lag_trx_no[i] <= trx_no && t > newest) {
+			newest = t;
+		}
+	}
+
+	if (newest == 0) {
+		*at_least = oldest != 0;
+		newest = oldest ? oldest : now;
+	}
+
+	return((ulint) ut_difftime(now, newest));
+}
+
+/*******************************************************************//**
+Prints the number of undo log records handed to each purge worker and
+the age of the oldest unpurged history. The counters are read without
+latching, because they are only for display. */
+UNIV_INTERN
+void
+trx_purge_print(
+/*============*/
+	FILE*	file)	/*!< in: file where to print */
+{
+	bool		at_least;
+	ulint		age = trx_purge_get_history_age(&at_least);
+	que_thr_t*	thr;
+	ulint		i = 0;
+
+	fprintf(file, "Purge history age %s%lu sec, records per worker:",
+		at_least ? "> " : "", (ulong) age);
+
+	for (thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
+	     thr != NULL && i < srv_n_purge_threads;
+	     thr = UT_LIST_GET_NEXT(thrs, thr), ++i) {
+
+		const purge_node_t*	node
+			= static_cast<const purge_node_t*>(thr->child);
+
+		fprintf(file, " %lu", (ulong) node->n_recs_total);
+	}
+
+	putc('\n', file);
+
+	if (purge_sys->undo_trunc_space != ULINT_UNDEFINED) {
+		fprintf(file, "Undo tablespace %lu is being truncated\n",
+			(ulong) purge_sys->undo_trunc_space);
+	}
+}
+
 /*******************************************************************//**
 Get the purge state.
 @return purge state. */
@@ -164,6 +164,100 @@ trx_in_trx_list(
 }
 #endif /* UNIV_DEBUG */
 
+/*****************************************************************//**
+Finds the position of a transaction id in trx_sys->rw_trx_ids.
+@return	position of the first element that is not less than id */
+static
+ulint
+trx_sys_rw_trx_ids_find(
+/*====================*/
+	trx_id_t	id)	/*!< in: transaction id */
+{
+	ulint	low	= 0;
+	ulint	high	= trx_sys->n_rw_trx_ids;
+
+	while (low < high) {
+		ulint	mid = (low + high) / 2;
+
+		if (trx_sys->rw_trx_ids[mid] < id) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return(low);
+}
+
+/*****************************************************************//**
+Adds a transaction id to trx_sys->rw_trx_ids. The caller must hold
+trx_sys->mutex, unless the database is being started. */
+UNIV_INTERN
+void
+trx_sys_rw_trx_ids_add(
+/*===================*/
+	trx_id_t	id)	/*!< in: id of a read-write transaction */
+{
+	ulint	pos;
+
+	ut_ad(srv_is_being_started || mutex_own(&trx_sys->mutex));
+
+	if (trx_sys->n_rw_trx_ids == trx_sys->rw_trx_ids_size) {
+		trx_sys->rw_trx_ids_size = trx_sys->rw_trx_ids_size
+			? 2 * trx_sys->rw_trx_ids_size : 256;
+
+		trx_sys->rw_trx_ids = static_cast<trx_id_t*>(
+			ut_realloc(trx_sys->rw_trx_ids,
+				   trx_sys->rw_trx_ids_size
+				   * sizeof *trx_sys->rw_trx_ids));
+		ut_a(trx_sys->rw_trx_ids != NULL);
+	}
+
+	/* Transactions started at runtime get ascending ids,
+	so the id can be appended, except at startup. */
+
+	if (trx_sys->n_rw_trx_ids == 0
+	    || trx_sys->rw_trx_ids[trx_sys->n_rw_trx_ids - 1] < id) {
+		pos = trx_sys->n_rw_trx_ids;
+	} else {
+		pos = trx_sys_rw_trx_ids_find(id);
+		ut_ad(trx_sys->rw_trx_ids[pos] != id);
+
+		memmove(&trx_sys->rw_trx_ids[pos + 1],
+			&trx_sys->rw_trx_ids[pos],
+			(trx_sys->n_rw_trx_ids - pos)
+			* sizeof *trx_sys->rw_trx_ids);
+	}
+
+	trx_sys->rw_trx_ids[pos] = id;
+	trx_sys->n_rw_trx_ids++;
+}
+
+/*****************************************************************//**
+Removes a transaction id from trx_sys->rw_trx_ids, if it is there.
+The caller must hold trx_sys->mutex. */
+UNIV_INTERN
+void
+trx_sys_rw_trx_ids_remove(
+/*======================*/
+	trx_id_t	id)	/*!< in: id of a read-write transaction */
+{
+	ulint	pos;
+
+	ut_ad(mutex_own(&trx_sys->mutex));
+
+	pos = trx_sys_rw_trx_ids_find(id);
+
+	if (pos < trx_sys->n_rw_trx_ids && trx_sys->rw_trx_ids[pos] == id) {
+		trx_sys->n_rw_trx_ids--;
+
+		memmove(&trx_sys->rw_trx_ids[pos],
+			&trx_sys->rw_trx_ids[pos + 1],
+			(trx_sys->n_rw_trx_ids - pos)
+			* sizeof *trx_sys->rw_trx_ids);
+	}
+}
+
 /*****************************************************************//**
 Writes the value of max_trx_id to the file based trx system header. */
 UNIV_INTERN
@@ -1226,6 +1320,8 @@ trx_sys_close(void)
 	ut_a(UT_LIST_GET_LEN(trx_sys->view_list) == 0);
 	ut_a(UT_LIST_GET_LEN(trx_sys->ro_trx_list) == 0);
 	ut_a(UT_LIST_GET_LEN(trx_sys->rw_trx_list) == 0);
+	ut_a(trx_sys->n_rw_trx_ids == 0);
+	ut_a(UT_LIST_GET_LEN(trx_sys->serialisation_list) == 0);
   if (trx_sys->n_prepared_trx)
   {
 	  ut_a(UT_LIST_GET_LEN(trx_sys->mysql_trx_list) == 0);
@@ -1235,6 +1331,10 @@ trx_sys_close(void)
 
 	mutex_free(&trx_sys->mutex);
 
+	if (trx_sys->rw_trx_ids != NULL) {
+		ut_free(trx_sys->rw_trx_ids);
+	}
+
 	mem_free(trx_sys);
 
 	trx_sys = NULL;
@@ -317,6 +317,8 @@ trx_free_prepared(
 	UT_LIST_REMOVE(trx_list, trx_sys->rw_trx_list, trx);
 	ut_d(trx->in_rw_trx_list = FALSE);
 
+	trx_sys_rw_trx_ids_remove(trx->id);
+
 	/* Undo trx_resurrect_table_locks(). */
 	UT_LIST_INIT(trx->lock.trx_locks);
 
@@ -405,6 +407,13 @@ trx_list_rw_insert_ordered(
 	}
 #endif /* UNIV_DEBUG */
 
+	/* Transactions that were committed before the crash
+	must be visible in read views. */
+
+	if (trx->state != TRX_STATE_COMMITTED_IN_MEMORY) {
+		trx_sys_rw_trx_ids_add(trx->id);
+	}
+
 	ut_ad(!trx->in_rw_trx_list);
 	ut_d(trx->in_rw_trx_list = TRUE);
 }
@@ -695,6 +704,7 @@ trx_lists_init_at_db_start(void)
 
 	UT_LIST_INIT(trx_sys->ro_trx_list);
 	UT_LIST_INIT(trx_sys->rw_trx_list);
+	UT_LIST_INIT(trx_sys->serialisation_list);
 
 	/* Look from the rollback segments if there exist undo logs for
 	transactions */
@@ -754,6 +764,9 @@ trx_lists_init_at_db_start(void)
 
 /******************************************************************//**
 Assigns a rollback segment to a transaction in a round-robin fashion.
+Rollback segments whose undo tablespace is being truncated are skipped;
+if no other rollback segment is available, the one in the system
+tablespace is used.
 @return	assigned rollback segment instance */
 static
 trx_rseg_t*
@@ -790,20 +803,69 @@ trx_assign_rseg_low(
 	defined for rollback segments. We want all UNDO records to be in
 	the non-system tablespaces. */
 
-	do {
+	for (ulint n_skipped = 0;;) {
 		rseg = trx_sys->rseg_array[i];
 		ut_a(rseg == NULL || i == rseg->id);
 
-		i = (rseg == NULL) ? 0 : i + 1;
+		i = (rseg == NULL) ? 0 : (i + 1) % TRX_SYS_N_RSEGS;
+
+		if (rseg == NULL
+		    || (rseg->space == 0
+			&& n_tablespaces > 0
+			&& trx_sys->rseg_array[1] != NULL)) {
+
+			continue;
+		}
+
+		mutex_enter(&rseg->mutex);
+
+		if (!rseg->skip_allocation) {
+			break;
+		}
+
+		mutex_exit(&rseg->mutex);
+
+		if (++n_skipped > TRX_SYS_N_RSEGS) {
+			/* All the candidates are being truncated. The
+			rollback segment in the system tablespace is never
+			marked for truncation. */
+			rseg = trx_sys->rseg_array[0];
+			mutex_enter(&rseg->mutex);
+			break;
+		}
+	}
 
-	} while (rseg == NULL
-		 || (rseg->space == 0
-		     && n_tablespaces > 0
-		     && trx_sys->rseg_array[1] != NULL));
+	ut_ad(!rseg->skip_allocation);
+	rseg->trx_ref_count++;
+	mutex_exit(&rseg->mutex);
 
 	return(rseg);
 }
 
+/******************************************************************//**
+Releases the reference that trx_assign_rseg_low() took on the rollback
+segment of a transaction. */
+static
+void
+trx_release_rseg(
+/*=============*/
+	trx_t*	trx)	/*!< in/out: transaction */
+{
+	trx_rseg_t*	rseg = trx->rseg;
+
+	/* Recovered transactions were not assigned by
+	trx_assign_rseg_low(); their undo logs keep the rollback
+	segment busy. */
+	if (rseg != NULL && !trx->is_recovered) {
+		mutex_enter(&rseg->mutex);
+		ut_ad(rseg->trx_ref_count > 0);
+		rseg->trx_ref_count--;
+		mutex_exit(&rseg->mutex);
+	}
+
+	trx->rseg = NULL;
+}
+
 /****************************************************************//**
 Assign a read-only transaction a rollback-segment, if it is attempting
 to write to a TEMPORARY table. */
@@ -898,6 +960,7 @@ trx_start_low(
 		ut_ad(!trx_is_autocommit_non_locking(trx));
 		UT_LIST_ADD_FIRST(trx_list, trx_sys->rw_trx_list, trx);
 		ut_d(trx->in_rw_trx_list = TRUE);
+		trx_sys_rw_trx_ids_add(trx->id);
 #ifdef UNIV_DEBUG
 		if (trx->id > trx_sys->rw_max_trx_id) {
 			trx_sys->rw_max_trx_id = trx->id;
@@ -932,6 +995,14 @@ trx_serialisation_number_get(
 
 	trx->no = trx_sys_get_new_trx_id();
 
+	/* The numbers are assigned in ascending order while
+	holding trx_sys->mutex, so that the first element of
+	the list has the smallest trx->no. */
+
+	ut_ad(!trx->in_serialisation_list);
+	UT_LIST_ADD_LAST(no_list, trx_sys->serialisation_list, trx);
+	trx->in_serialisation_list = true;
+
 	/* If the rollack segment is not empty then the
 	new trx_t::no can't be less than any trx_t::no
 	already in the rollback segment. User threads only
@@ -1191,8 +1262,23 @@ trx_commit_in_memory(
 
 		MONITOR_INC(MONITOR_TRX_NL_RO_COMMIT);
 	} else {
+		if (!trx->read_only) {
+			/* Remove the id before the locks are released.
+			A transaction that was waiting for one of our locks
+			may create a read view as soon as it is granted the
+			lock, and that view must see our changes. The view
+			copies trx_sys->rw_trx_ids and does not look at
+			the state of the transactions. */
+
+			mutex_enter(&trx_sys->mutex);
+			trx_sys_rw_trx_ids_remove(trx->id);
+			mutex_exit(&trx_sys->mutex);
+		}
+
 		lock_trx_release_locks(trx);
 
+		DEBUG_SYNC_C("trx_commit_in_memory_after_release_locks");
+
 		/* Remove the transaction from the list of active
 		transactions now that it no longer holds any user locks. */
 
@@ -1212,6 +1298,18 @@ trx_commit_in_memory(
 			MONITOR_INC(MONITOR_TRX_RW_COMMIT);
 		}
 
+		/* The transaction was added by
+		trx_serialisation_number_get() if it wrote update undo
+		log. Recovered transactions have a dummy trx->no and
+		are not in the list unless they were serialised after
+		the restart. */
+
+		if (trx->in_serialisation_list) {
+			UT_LIST_REMOVE(
+				no_list, trx_sys->serialisation_list, trx);
+			trx->in_serialisation_list = false;
+		}
+
 		/* If this transaction came from trx_allocate_for_mysql(),
 		trx->in_mysql_trx_list would hold. In that case, the
 		trx->state change must be protected by trx_sys->mutex, so that
@@ -1292,7 +1390,7 @@ trx_commit_in_memory(
 	trx_named_savept_t*	savep = UT_LIST_GET_FIRST(trx->trx_savepoints);
 	trx_roll_savepoints_free(trx, savep);
 
-	trx->rseg = NULL;
+	trx_release_rseg(trx);
 	trx->undo_no = 0;
 	trx->last_sql_stat_start.least_undo_no = 0;
 
@@ -1446,6 +1544,8 @@ trx_cleanup_at_db_startup(
 	assert_trx_in_rw_list(trx);
 	ut_d(trx->in_rw_trx_list = FALSE);
 
+	trx_sys_rw_trx_ids_remove(trx->id);
+
 	mutex_exit(&trx_sys->mutex);
 
 	/* Change the transaction state without mutex protection, now